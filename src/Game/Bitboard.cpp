@@ -0,0 +1,495 @@
+#include "Game/Bitboard.h"
+
+#include <array>
+#include <algorithm>
+#include <bit>
+#include <string>
+#include <cassert>
+#include <utility>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+#include "Game/Square.h"
+#include "Game/Color.h"
+
+namespace
+{
+    using Bitboard::bitboard_t;
+
+    template<size_t N>
+    constexpr bitboard_t step_attacks(const Square square, const std::array<Square_Difference, N>& steps) noexcept
+    {
+        bitboard_t result = 0;
+        for(const auto& step : steps)
+        {
+            const auto target = square + step;
+            if(target.inside_board())
+            {
+                result |= Bitboard::square_bit(target);
+            }
+        }
+        return result;
+    }
+
+    template<size_t N>
+    constexpr std::array<bitboard_t, 64> step_attack_table(const std::array<Square_Difference, N>& steps) noexcept
+    {
+        std::array<bitboard_t, 64> table{};
+        for(unsigned int index = 0; index < table.size(); ++index)
+        {
+            table[index] = step_attacks(Square::from_index(index), steps);
+        }
+        return table;
+    }
+
+    constexpr std::array<Square_Difference, 4> rook_directions = {{{1, 0}, {-1, 0}, {0, 1}, {0, -1}}};
+    constexpr std::array<Square_Difference, 4> bishop_directions = {{{1, 1}, {1, -1}, {-1, 1}, {-1, -1}}};
+
+    constexpr auto knight_attack_table = step_attack_table(std::array<Square_Difference, 8>{{{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}}});
+    constexpr auto king_attack_table = step_attack_table(std::array<Square_Difference, 8>{{{1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}}});
+    constexpr std::array<std::array<bitboard_t, 64>, 2> pawn_attack_table = {step_attack_table(std::array<Square_Difference, 2>{{{-1, 1}, {1, 1}}}),
+                                                                             step_attack_table(std::array<Square_Difference, 2>{{{-1, -1}, {1, -1}}})};
+
+    //! \brief The squares from a square to the edge of the board in one direction, not including the starting square.
+    constexpr bitboard_t ray(const Square square, const Square_Difference& step) noexcept
+    {
+        bitboard_t result = 0;
+        for(auto target = square + step; target.inside_board(); target += step)
+        {
+            result |= Bitboard::square_bit(target);
+        }
+        return result;
+    }
+
+    //! \brief The squares a sliding piece crosses in one direction on an empty board.
+    struct Ray
+    {
+        bitboard_t squares;
+        bool toward_higher_index; //!< Whether the square indices increase along the ray.
+    };
+
+    constexpr std::array<Ray, 4> rays_from(const Square square, const std::array<Square_Difference, 4>& directions) noexcept
+    {
+        std::array<Ray, 4> rays{};
+        for(size_t direction = 0; direction < directions.size(); ++direction)
+        {
+            const auto& step = directions[direction];
+            rays[direction] = {ray(square, step), 8*step.file_change + step.rank_change > 0};
+        }
+        return rays;
+    }
+
+    //! \brief Find the attacks of a sliding piece by cutting off each ray at the nearest blocking piece.
+    //!
+    //! This is only used for filling the lookup tables.
+    constexpr bitboard_t sliding_attacks(const std::array<Ray, 4>& rays, const bitboard_t occupied) noexcept
+    {
+        bitboard_t result = 0;
+        for(const auto& ray : rays)
+        {
+            const auto blockers = ray.squares & occupied;
+            if(blockers == 0)
+            {
+                result |= ray.squares;
+            }
+            else if(ray.toward_higher_index)
+            {
+                // Keep the squares up to and including the lowest blocker.
+                const auto nearest_blocker = blockers & (~blockers + 1);
+                result |= ray.squares & (2*nearest_blocker - 1);
+            }
+            else
+            {
+                // Keep the squares down to and including the highest blocker.
+                const auto nearest_blocker = bitboard_t{1} << (63 - std::countl_zero(blockers));
+                result |= ray.squares & ~(nearest_blocker - 1);
+            }
+        }
+        return result;
+    }
+
+    //! \brief The squares where a piece can block a sliding piece's movement.
+    //!
+    //! The last square in each direction is not included since a piece there cannot block anything.
+    constexpr bitboard_t blocking_mask(const Square square, const std::array<Square_Difference, 4>& directions) noexcept
+    {
+        bitboard_t result = 0;
+        for(const auto& step : directions)
+        {
+            for(auto target = square + step; target.inside_board() && (target + step).inside_board(); target += step)
+            {
+                result |= Bitboard::square_bit(target);
+            }
+        }
+        return result;
+    }
+
+    bitboard_t parallel_bits_extract(const bitboard_t source, const bitboard_t mask) noexcept
+    {
+#if defined(__BMI2__)
+        return _pext_u64(source, mask);
+#else
+        // Software emulation of the BMI2 PEXT instruction
+        bitboard_t result = 0;
+        auto remaining_mask = mask;
+        for(bitboard_t result_bit = 1; remaining_mask; result_bit <<= 1)
+        {
+            const auto lowest_mask_bit = remaining_mask & (~remaining_mask + 1);
+            if(source & lowest_mask_bit)
+            {
+                result |= result_bit;
+            }
+            remaining_mask ^= lowest_mask_bit;
+        }
+        return result;
+#endif
+    }
+
+    // Multipliers that map every arrangement of blocking pieces to a table index with no
+    // destructive collisions. They were found by trying sparse random numbers, as described
+    // in https://www.chessprogramming.org/Looking_for_Magics, and are written out here so
+    // that the search does not have to run every time the program starts.
+    constexpr std::array<bitboard_t, 64> rook_magics =
+    {
+        0x0080008040002010, 0x8440400020001000, 0x1080100020000880, 0x9080080080041000,
+        0x0180180080040012, 0x0180050200800400, 0x0400040200900108, 0x2080002080004100,
+        0x0184800040088028, 0x0000802000804010, 0x4212002048820010, 0x0000800800100080,
+        0x8020800400080082, 0x0201000401000208, 0x0284002802211004, 0x020200050090421c,
+        0x0040828004204000, 0xd000404000201008, 0x00208080100c2000, 0x0201010010000820,
+        0x0008008080080400, 0x2623808062002400, 0x0080808002000100, 0x0210020000629304,
+        0x0000400080008028, 0x000c200880400380, 0x0450040020080020, 0x0100080080100081,
+        0x0004080100110004, 0x8080040080800200, 0x0800610400029008, 0xa000004600040881,
+        0x0080002002400450, 0x0030004000402000, 0x2102008022001840, 0x10c0210009001000,
+        0x1140800400800800, 0x80aa000802001004, 0x000010080c002a01, 0x0208051882000044,
+        0x4080004000858020, 0x101000422001400a, 0x0060004023050010, 0x0004a142007a0011,
+        0xc502000810220004, 0x0002008004008002, 0x0001000200010004, 0x00000100a0420014,
+        0x1001002040820200, 0x0080200040100040, 0x60a0001000480240, 0x0004080010008480,
+        0x0003021008000500, 0x0020020004008080, 0x0a20011002080400, 0x5401008400410200,
+        0x00842041811a0102, 0x900080c000310123, 0x1140402000100901, 0x12041000a0090025,
+        0x0001000210040801, 0x0043000400020801, 0x0000219e03102804, 0x4000010040840022
+    };
+
+    constexpr std::array<bitboard_t, 64> bishop_magics =
+    {
+        0x1020111000809481, 0x0809290b04090010, 0x8041820083001060, 0x2002408100001014,
+        0x8124042101202404, 0x0801040240001000, 0x0102180424a40820, 0x042204c0c8043072,
+        0x0002200210023880, 0x000002a404008202, 0x0090048400820410, 0x0200480483000020,
+        0x0000020210800080, 0x2100208860080900, 0x0200420110080590, 0x0004448048181410,
+        0x0420099002020810, 0x0004048910008200, 0x1808000102082200, 0x808c023840102000,
+        0x0001000820080a01, 0x0000810808040200, 0x0004200447080840, 0x0041000a0090c400,
+        0x0620110020028202, 0x0008049d21290204, 0x00820900480810a0, 0x0c05080044004030,
+        0x0081001009004010, 0x400511020a008880, 0x8180822024020206, 0x0809120810208408,
+        0x0011082380400400, 0x8084100400024400, 0x0800403002080040, 0x0200600800050104,
+        0x00a4200200002080, 0x00308106000100ac, 0x8024080200004120, 0x0802008500182400,
+        0x2001282010000410, 0x040418c208009000, 0x0000c20540402404, 0x1204002124000802,
+        0x0020584101001010, 0x20400101020a0100, 0x2160010142015102, 0x0802080041004083,
+        0x1201041002880030, 0x0002020211840008, 0x8105002084100060, 0x190000e020880420,
+        0x0400004010412230, 0x0100842004044040, 0x0008103002084002, 0x8088812104090050,
+        0x0801009201200200, 0x04014a0202028201, 0x8000020100809000, 0x0101800240208820,
+        0x1060804421604100, 0x410a010420241100, 0x0000408202020200, 0x0840048400820010
+    };
+
+    //! \brief The attacks of a sliding piece from one square for every arrangement of blocking pieces.
+    //!
+    //! \tparam entry_count The number of arrangements: 2^(number of blocking squares).
+    template<size_t entry_count>
+    struct Square_Attacks
+    {
+        bitboard_t mask = 0;
+        int shift = 0;
+        std::array<bitboard_t, entry_count> pext_attacks{};
+        std::array<bitboard_t, entry_count> magic_attacks{};
+        bool magic_is_valid = true; //!< Whether no two arrangements with different attacks share a magic entry.
+    };
+
+    //! \brief The lookup entries for one square.
+    //!
+    //! Each square is a separate constant expression so that no single evaluation exceeds
+    //! the compiler's limit on the number of operations during compilation.
+    template<const std::array<Square_Difference, 4>& directions, const std::array<bitboard_t, 64>& magic_numbers, size_t index>
+    constexpr auto square_attacks =
+    []()
+    {
+        constexpr auto square = Square::from_index(index);
+        constexpr auto mask = blocking_mask(square, directions);
+        const auto rays = rays_from(square, directions);
+        Square_Attacks<size_t{1} << std::popcount(mask)> result;
+        result.mask = mask;
+        result.shift = 64 - std::popcount(mask);
+
+        // Enumerate all subsets of the mask in increasing order (Carry-Rippler trick).
+        // The n-th subset has a PEXT index of n.
+        size_t subset_index = 0;
+        bitboard_t subset = 0;
+        do
+        {
+            const auto attacks = sliding_attacks(rays, subset);
+            result.pext_attacks[subset_index] = attacks;
+            auto& magic_entry = result.magic_attacks[(subset*magic_numbers[index]) >> result.shift];
+            if(magic_entry != 0 && magic_entry != attacks)
+            {
+                result.magic_is_valid = false;
+            }
+            magic_entry = attacks;
+            ++subset_index;
+            subset = (subset - mask) & mask;
+        } while(subset != 0);
+
+        return result;
+    }();
+
+    //! \brief Attack lookup tables for one type of sliding piece.
+    //!
+    //! Both backends use the same per-square offsets into their tables since each square
+    //! needs 2^(number of blocking squares) entries in either scheme. The tables are filled
+    //! during compilation.
+    //! \tparam directions The directions the piece moves.
+    //! \tparam magic_numbers The magic multipliers for each square.
+    //! \tparam table_size The total number of entries for all squares.
+    template<const std::array<Square_Difference, 4>& directions, const std::array<bitboard_t, 64>& magic_numbers, size_t table_size>
+    class Slider_Table
+    {
+        public:
+            constexpr Slider_Table() noexcept : magics(magic_numbers)
+            {
+                add_squares(std::make_index_sequence<64>{});
+            }
+
+            //! \brief Whether the table size is exact and no two arrangements of blockers with different attacks share a magic entry.
+            constexpr bool is_valid() const noexcept
+            {
+                return complete;
+            }
+
+            bitboard_t attacks(const Square square, const bitboard_t occupied, const Bitboard::Slider_Backend backend) const noexcept
+            {
+                const auto index = square.index();
+                if(backend == Bitboard::Slider_Backend::PEXT)
+                {
+                    return pext_attacks[offsets[index] + parallel_bits_extract(occupied, masks[index])];
+                }
+                else
+                {
+                    return magic_attacks[offsets[index] + magic_index(index, occupied)];
+                }
+            }
+
+        private:
+            std::array<bitboard_t, 64> masks{};
+            std::array<bitboard_t, 64> magics{};
+            std::array<int, 64> shifts{};
+            std::array<size_t, 64> offsets{};
+            std::array<bitboard_t, table_size> magic_attacks{};
+            std::array<bitboard_t, table_size> pext_attacks{};
+            bool complete = true;
+
+            template<size_t... indices>
+            constexpr void add_squares(std::index_sequence<indices...>) noexcept
+            {
+                size_t offset = 0;
+                ((offset = add_square(indices, offset, square_attacks<directions, magic_numbers, indices>)), ...);
+                if(offset != table_size)
+                {
+                    complete = false;
+                }
+            }
+
+            template<size_t entry_count>
+            constexpr size_t add_square(const size_t index, const size_t offset, const Square_Attacks<entry_count>& square) noexcept
+            {
+                masks[index] = square.mask;
+                shifts[index] = square.shift;
+                offsets[index] = offset;
+                if( ! square.magic_is_valid || offset + entry_count > table_size)
+                {
+                    complete = false;
+                    return offset + entry_count;
+                }
+
+                std::copy(square.pext_attacks.begin(), square.pext_attacks.end(), pext_attacks.begin() + std::ptrdiff_t(offset));
+                std::copy(square.magic_attacks.begin(), square.magic_attacks.end(), magic_attacks.begin() + std::ptrdiff_t(offset));
+                return offset + entry_count;
+            }
+
+            size_t magic_index(const unsigned int square_index, const bitboard_t occupied) const noexcept
+            {
+                return size_t(((occupied & masks[square_index])*magics[square_index]) >> shifts[square_index]);
+            }
+    };
+
+    constexpr Slider_Table<rook_directions, rook_magics, 102'400> rook_table;
+    static_assert(rook_table.is_valid(), "The rook attack table has the wrong size or a bad magic number.");
+    constexpr Slider_Table<bishop_directions, bishop_magics, 5'248> bishop_table;
+    static_assert(bishop_table.is_valid(), "The bishop attack table has the wrong size or a bad magic number.");
+
+    //! \brief For every pair of squares on a common row, column, or diagonal, the squares between them and the whole line through them.
+    //!
+    //! Both tables are indexed by [square index][square index]. Other pairs of squares have empty entries.
+    struct Line_Tables
+    {
+        std::array<std::array<bitboard_t, 64>, 64> between{};
+        std::array<std::array<bitboard_t, 64>, 64> line{};
+    };
+
+    constexpr auto line_tables =
+    []()
+    {
+        Line_Tables tables;
+        const auto directions = std::array<Square_Difference, 8>{{{1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}}};
+        for(unsigned int index = 0; index < 64; ++index)
+        {
+            const auto a = Square::from_index(index);
+            for(const auto& step : directions)
+            {
+                const auto whole_line = Bitboard::square_bit(a) | ray(a, step) | ray(a, {-step.file_change, -step.rank_change});
+                bitboard_t between = 0;
+                for(auto b = a + step; b.inside_board(); b += step)
+                {
+                    tables.between[index][b.index()] = between;
+                    tables.line[index][b.index()] = whole_line;
+                    between |= Bitboard::square_bit(b);
+                }
+            }
+        }
+        return tables;
+    }();
+
+#if defined(__BMI2__)
+    constexpr auto pext_instruction_available = true;
+#else
+    constexpr auto pext_instruction_available = false;
+#endif
+
+    constinit auto current_backend = pext_instruction_available ? Bitboard::Slider_Backend::PEXT : Bitboard::Slider_Backend::MAGIC;
+}
+
+void Bitboard::use_slider_backend(const Slider_Backend backend) noexcept
+{
+    current_backend = backend;
+}
+
+Bitboard::Slider_Backend Bitboard::slider_backend() noexcept
+{
+    return current_backend;
+}
+
+std::string Bitboard::backend_name(const Slider_Backend backend) noexcept
+{
+    if(backend == Slider_Backend::MAGIC)
+    {
+        return "Magic";
+    }
+    else
+    {
+        return hardware_pext_available() ? "PEXT" : "PEXT (software)";
+    }
+}
+
+bool Bitboard::hardware_pext_available() noexcept
+{
+    return pext_instruction_available;
+}
+
+int Bitboard::count(const bitboard_t squares) noexcept
+{
+    return std::popcount(squares);
+}
+
+Square Bitboard::first_square(const bitboard_t squares) noexcept
+{
+    assert(squares != 0);
+    return Square::from_index(unsigned(std::countr_zero(squares)));
+}
+
+Square Bitboard::pop_first_square(bitboard_t& squares) noexcept
+{
+    const auto square = first_square(squares);
+    squares &= squares - 1;
+    return square;
+}
+
+Bitboard::bitboard_t Bitboard::knight_attacks(const Square square) noexcept
+{
+    return knight_attack_table[square.index()];
+}
+
+Bitboard::bitboard_t Bitboard::king_attacks(const Square square) noexcept
+{
+    return king_attack_table[square.index()];
+}
+
+Bitboard::bitboard_t Bitboard::pawn_attacks(const Square square, const Piece_Color pawn_color) noexcept
+{
+    return pawn_attack_table[std::to_underlying(pawn_color)][square.index()];
+}
+
+Bitboard::bitboard_t Bitboard::rook_attacks(const Square square, const bitboard_t occupied) noexcept
+{
+    return rook_table.attacks(square, occupied, current_backend);
+}
+
+Bitboard::bitboard_t Bitboard::bishop_attacks(const Square square, const bitboard_t occupied) noexcept
+{
+    return bishop_table.attacks(square, occupied, current_backend);
+}
+
+Bitboard::bitboard_t Bitboard::squares_between(const Square a, const Square b) noexcept
+{
+    return line_tables.between[a.index()][b.index()];
+}
+
+Bitboard::bitboard_t Bitboard::line_through(const Square a, const Square b) noexcept
+{
+    return line_tables.line[a.index()][b.index()];
+}
+
+Square_Set_Iterator::Square_Set_Iterator(const Bitboard::bitboard_t squares) noexcept : remaining_squares(squares)
+{
+}
+
+Square_Set_Iterator& Square_Set_Iterator::operator++() noexcept
+{
+    remaining_squares &= remaining_squares - 1;
+    return *this;
+}
+
+void Square_Set_Iterator::operator++(int) noexcept
+{
+    ++(*this);
+}
+
+Square Square_Set_Iterator::operator*() const noexcept
+{
+    return Bitboard::first_square(remaining_squares);
+}
+
+Square_Set::Square_Set(const Bitboard::bitboard_t squares_in) noexcept : squares(squares_in)
+{
+}
+
+Square_Set_Iterator Square_Set::begin() const noexcept
+{
+    return Square_Set_Iterator(squares);
+}
+
+Square_Set_Iterator Square_Set::end() const noexcept
+{
+    return Square_Set_Iterator();
+}
+
+int Square_Set::size() const noexcept
+{
+    return Bitboard::count(squares);
+}
+
+bool Square_Set::empty() const noexcept
+{
+    return squares == 0;
+}
+
+bool Square_Set::contains(const Square square) const noexcept
+{
+    return square.inside_board() && (squares & Bitboard::square_bit(square));
+}
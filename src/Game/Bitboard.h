@@ -0,0 +1,179 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+#include <string>
+#include <iterator>
+#include <cassert>
+
+#include "Game/Square.h"
+#include "Game/Color.h"
+
+//! \file
+
+//! \brief Functions for working with sets of squares stored as the bits of a 64-bit integer.
+//!
+//! Bit n of a bitboard represents the Square with Square::index() == n. The attacks
+//! of sliding pieces (rooks, bishops, and queens) are looked up in precomputed tables
+//! that are indexed by the occupied squares that can block the piece's movement. There
+//! are two methods for computing the table index: magic multiplication and the BMI2
+//! PEXT instruction. See https://www.chessprogramming.org/Magic_Bitboards.
+namespace Bitboard
+{
+    //! \brief A set of squares on a board.
+    using bitboard_t = uint64_t;
+
+    //! \brief The methods of calculating the attack table index for sliding pieces.
+    enum class Slider_Backend
+    {
+        MAGIC,
+        PEXT
+    };
+
+    //! \brief Choose the method of looking up sliding piece attacks.
+    //!
+    //! This should not be called while other threads are generating moves.
+    //! \param backend The method to use for all subsequent lookups.
+    void use_slider_backend(Slider_Backend backend) noexcept;
+
+    //! \brief The current method for looking up sliding piece attacks.
+    Slider_Backend slider_backend() noexcept;
+
+    //! \brief A text description of a slider backend for printing.
+    //!
+    //! \param backend The backend to describe.
+    std::string backend_name(Slider_Backend backend) noexcept;
+
+    //! \brief Whether the PEXT backend uses the hardware instruction.
+    //!
+    //! \returns True if this program was compiled with BMI2 instructions enabled. Otherwise,
+    //!          the PEXT backend uses a much slower software emulation.
+    bool hardware_pext_available() noexcept;
+
+    //! \brief A bitboard containing only the given square.
+    constexpr bitboard_t square_bit(Square square) noexcept;
+
+    //! \brief The number of squares in a bitboard.
+    int count(bitboard_t squares) noexcept;
+
+    //! \brief The square with the lowest index in a non-empty bitboard.
+    Square first_square(bitboard_t squares) noexcept;
+
+    //! \brief Remove and return the square with the lowest index in a non-empty bitboard.
+    //!
+    //! \param[in,out] squares The bitboard that will lose a square.
+    //! \returns The removed square.
+    Square pop_first_square(bitboard_t& squares) noexcept;
+
+    //! \brief The squares attacked by a knight.
+    bitboard_t knight_attacks(Square square) noexcept;
+
+    //! \brief The squares attacked by a king.
+    bitboard_t king_attacks(Square square) noexcept;
+
+    //! \brief The squares attacked by a pawn.
+    //!
+    //! \param square The location of the pawn.
+    //! \param pawn_color The color of the pawn.
+    bitboard_t pawn_attacks(Square square, Piece_Color pawn_color) noexcept;
+
+    //! \brief The squares attacked by a rook.
+    //!
+    //! \param square The location of the rook.
+    //! \param occupied All of the squares with a piece on them.
+    bitboard_t rook_attacks(Square square, bitboard_t occupied) noexcept;
+
+    //! \brief The squares attacked by a bishop.
+    //!
+    //! \param square The location of the bishop.
+    //! \param occupied All of the squares with a piece on them.
+    bitboard_t bishop_attacks(Square square, bitboard_t occupied) noexcept;
+
+    //! \brief The squares strictly between two squares on a common row, column, or diagonal.
+    //!
+    //! \returns An empty bitboard if the squares do not share a line.
+    bitboard_t squares_between(Square a, Square b) noexcept;
+
+    //! \brief The full row, column, or diagonal that passes through two squares.
+    //!
+    //! \returns An empty bitboard if the squares do not share a line.
+    bitboard_t line_through(Square a, Square b) noexcept;
+}
+
+//! \brief The iterator created by the Square_Set container that dereferences to a Square.
+class Square_Set_Iterator
+{
+    public:
+        //! \brief This iterator is meant to be traversed once.
+        using iterator_category = std::input_iterator_tag;
+        //! \brief The iterator dereferences to a Square.
+        using value_type = Square;
+        //! \brief The distance between iterators is an int.
+        using difference_type = int;
+        //! \brief The pointer to the data is a pointer to a Square.
+        using pointer = Square*;
+        //! \brief The reference to the data is reference to a Square.
+        using reference = Square&;
+
+        //! \brief Create an iterator over the squares of a bitboard.
+        //!
+        //! \param squares The squares that have not been visited yet.
+        explicit Square_Set_Iterator(Bitboard::bitboard_t squares) noexcept;
+
+        //! \brief Create an iterator with no squares left to visit.
+        Square_Set_Iterator() noexcept = default;
+
+        //! \brief Go to the next Square in the set.
+        Square_Set_Iterator& operator++() noexcept;
+
+        //! \brief Go to the next Square in the set.
+        void operator++(int) noexcept;
+
+        //! \brief Iterators are equal when they have the same squares left to visit.
+        bool operator==(const Square_Set_Iterator& other) const noexcept = default;
+
+        //! \brief Get the Square referred to by the iterator.
+        Square operator*() const noexcept;
+
+    private:
+        Bitboard::bitboard_t remaining_squares = 0;
+};
+
+//! \brief A pseudo-container for iterating over the squares in a bitboard.
+//!
+//! Squares are visited in order of Square::index(). The time needed to
+//! iterate depends only on the number of squares in the set.
+class Square_Set
+{
+    public:
+        //! \brief Create a set of squares.
+        //!
+        //! \param squares The squares in the set.
+        explicit Square_Set(Bitboard::bitboard_t squares) noexcept;
+
+        //! \brief Return the iterator to the first square in the set.
+        Square_Set_Iterator begin() const noexcept;
+
+        //! \brief Return the end iterator.
+        Square_Set_Iterator end() const noexcept;
+
+        //! \brief The number of squares in the set.
+        int size() const noexcept;
+
+        //! \brief Whether the set has no squares.
+        bool empty() const noexcept;
+
+        //! \brief Whether a square is in the set.
+        bool contains(Square square) const noexcept;
+
+    private:
+        Bitboard::bitboard_t squares;
+};
+
+constexpr Bitboard::bitboard_t Bitboard::square_bit(const Square square) noexcept
+{
+    assert(square.inside_board());
+    return bitboard_t{1} << square.index();
+}
+
+#endif // BITBOARD_H
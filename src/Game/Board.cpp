@@ -8,7 +8,6 @@
 #include <array>
 #include <mutex>
 #include <algorithm>
-#include <bitset>
 #include <string>
 #include <chrono>
 using namespace std::chrono_literals;
@@ -26,6 +25,9 @@ using namespace std::chrono_literals;
 #include "Game/Piece.h"
 #include "Game/Move.h"
 #include "Game/PGN.h"
+#include "Game/Bitboard.h"
+#include "Game/Move_Generator.h"
+#include "Game/Position_History.h"
 
 #include "Players/Player.h"
 
@@ -33,41 +35,45 @@ using namespace std::chrono_literals;
 #include "Utility/Random.h"
 #include "Utility/String.h"
 #include "Utility/Fixed_Capacity_Vector.h"
-#include "Utility/Algorithm.h"
 
 namespace
 {
-    const auto square_hash_values =
-    []()
+    //! \brief The random numbers that are combined to make the Zobrist hash of a board.
+    struct Zobrist_Hash_Values
     {
         // One entry for each piece on each square (including no piece)
-        std::array<std::array<uint64_t, 13>, 64> hash_cache;
-        for(auto& square_indexed_row : hash_cache)
-        {
-            std::ranges::generate(square_indexed_row, Random::random_unsigned_int64);
-        }
-        return hash_cache;
-    }();
-
-    const auto castling_hash_values =
+        std::array<std::array<uint64_t, 13>, 64> square{};
+        std::array<std::array<uint64_t, 2>, 2> castling{}; // Indexed by [Piece_Color][Direction]
+        uint64_t switch_turn = 0;
+        std::array<uint64_t, 8> en_passant{};
+    };
+
+    //! \brief The Zobrist hash values, generated during compilation.
+    //!
+    //! The seed is fixed so that positions have the same hashes in every run, which makes searches repeatable.
+    constexpr auto zobrist_hash_values =
     []()
     {
-        std::array<std::array<uint64_t, 2>, 2> castling_hash_cache; // Indexed by [Piece_Color][Direction]
-        for(auto& a : castling_hash_cache)
+        auto hash_source = Random::Random_Bits_Generator(0x5eedc0ffee);
+        const auto next_hash_value = [&hash_source]() { return hash_source(); };
+        Zobrist_Hash_Values values;
+        for(auto& square_indexed_row : values.square)
+        {
+            std::ranges::generate(square_indexed_row, next_hash_value);
+        }
+        for(auto& a : values.castling)
         {
-            std::ranges::generate(a, Random::random_unsigned_int64);
+            std::ranges::generate(a, next_hash_value);
         }
-        return castling_hash_cache;
+        values.switch_turn = next_hash_value();
+        std::ranges::generate(values.en_passant, next_hash_value);
+        return values;
     }();
 
-    const auto switch_turn_board_hash = Random::random_unsigned_int64();
-    const auto en_passant_hash_values =
-    []()
-    {
-        std::array<uint64_t, 8> en_passant_hash_cache;
-        std::ranges::generate(en_passant_hash_cache, Random::random_unsigned_int64);
-        return en_passant_hash_cache;
-    }();
+    constexpr const auto& square_hash_values = zobrist_hash_values.square;
+    constexpr const auto& castling_hash_values = zobrist_hash_values.castling;
+    constexpr auto switch_turn_board_hash = zobrist_hash_values.switch_turn;
+    constexpr const auto& en_passant_hash_values = zobrist_hash_values.en_passant;
 
     const std::string standard_starting_fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
 
@@ -199,20 +205,14 @@ Board::Board(const std::string& input_fen)
         fen_parse_assert(en_passant_target.rank() == (whose_turn() == Piece_Color::WHITE ? 6 : 3), input_fen, "The en passant target must be on the third rank (if black to move) or sixth rank (if white to move).");
     }
 
-    // Fill repeat counter to indicate moves since last
-    // pawn move or capture.
     const auto fifty_move_count_input = String::to_number<size_t>(fen_parse.at(4));
-    fen_parse_assert(fifty_move_count_input < repeat_count.maximum_size(), input_fen, "Halfmove clock value too large.");
-    add_board_position_to_repeat_record();
-    while(moves_since_pawn_or_capture() < fifty_move_count_input)
-    {
-        add_to_repeat_count(Random::random_unsigned_int64());
-    }
+    fen_parse_assert(fifty_move_count_input <= 100, input_fen, "Halfmove clock value too large.");
+    moves_since_pawn_or_capture_count = fifty_move_count_input;
 
     const auto first_full_move_label = String::to_number<size_t>(fen_parse.at(5));
     plies_at_construction = 2*(first_full_move_label - 1) + (whose_turn() == Piece_Color::WHITE ? 0 : 1);
 
-    recreate_move_caches();
+    update_move_caches();
 
     starting_hash = board_hash();
     fen_cache.add(starting_hash, fen());
@@ -321,14 +321,66 @@ std::string Board::original_fen() const noexcept
 
 Game_Result Board::play_move(const Move& move) noexcept
 {
-    if(repeat_count.full())
-    {
-        repeat_count.shift_left();
-    }
     update_board(move);
     return move_result();
 }
 
+Game_Result Board::make_move(const Move& move, Undo_Record& undo) noexcept
+{
+    undo.move = &move;
+    undo.previous_move = previous_move;
+    undo.moving_piece = piece_on_square(move.start());
+    undo.capture_square = move.is_en_passant() ? Square{move.end().file(), move.start().rank()} : move.end();
+    undo.captured_piece = piece_on_square(undo.capture_square);
+    undo.legal_castles = legal_castles;
+    undo.en_passant_target = en_passant_target;
+    undo.unused_en_passant_target = unused_en_passant_target;
+    undo.board_hash = board_hash();
+    undo.checking_pieces = checking_pieces_cache;
+    undo.pinned_pieces = pinned_pieces_cache;
+    undo.moves_since_pawn_or_capture = moves_since_pawn_or_capture_count;
+
+    return play_move(move);
+}
+
+void Board::unmake_move(const Undo_Record& undo) noexcept
+{
+    // Reverse the piece placements of Board::update_board() in the opposite
+    // order so that the castling rights and king locations are restored along
+    // with the pieces.
+    const auto& move = *undo.move;
+    const auto color = undo.moving_piece.color();
+    if(move.is_castle())
+    {
+        const auto rook_start = Square{move.movement().file_change > 0 ? 'h' : 'a', move.start().rank()};
+        const auto rook_end = move.start() + move.movement().step();
+        place_piece({}, rook_end);
+        place_piece({color, Piece_Type::ROOK}, rook_start);
+        castling_index[std::to_underlying(color)] = size_t(-1);
+        castling_movement[std::to_underlying(color)] = 0;
+    }
+
+    place_piece({}, move.end());
+    place_piece(undo.moving_piece, move.start());
+    if(undo.captured_piece)
+    {
+        place_piece(undo.captured_piece, undo.capture_square);
+    }
+
+    --game_move_count;
+    previous_move = undo.previous_move;
+    turn_color = color;
+    legal_castles = undo.legal_castles;
+    en_passant_target = undo.en_passant_target;
+    unused_en_passant_target = undo.unused_en_passant_target;
+    current_board_hash = undo.board_hash;
+    checking_pieces_cache = undo.checking_pieces;
+    pinned_pieces_cache = undo.pinned_pieces;
+    moves_since_pawn_or_capture_count = undo.moves_since_pawn_or_capture;
+
+    legal_moves_cache_is_stale = true;
+}
+
 Game_Result Board::play_move(const std::string& move)
 {
     return play_move(interpret_move(move));
@@ -387,7 +439,7 @@ Game_Result Board::move_result() const noexcept
 
     // An insufficient material draw can only happen after a capture
     // or a pawn promotion to a minor piece, both of which clear the
-    // repeat_count tracker.
+    // repeat record.
     if(moves_since_pawn_or_capture() == 0 && ! enough_material_to_checkmate())
     {
         return Game_Result(Winner_Color::NONE, Game_Result_Type::INSUFFICIENT_MATERIAL);
@@ -428,18 +480,39 @@ void Board::update_board(const Move& move) noexcept
     assert(is_in_legal_moves_list(move));
 
     ++game_move_count;
+    if(moves_since_pawn_or_capture_count < 100)
+    {
+        ++moves_since_pawn_or_capture_count;
+    }
     previous_move = &move;
-    if(move.is_en_passant(*this))
+    if(move.is_en_passant())
     {
         remove_piece({move.end().file(), move.start().rank()});
     }
     move_piece(move);
     clear_en_passant_target();
     unused_en_passant_target = {};
-    move.side_effects(*this);
+
+    if(move.is_pawn_double_move())
+    {
+        make_en_passant_targetable(move.start() + Square_Difference{0, move.movement().rank_change/2});
+    }
+    else if(move.promotion())
+    {
+        place_piece(move.promotion(), move.end());
+    }
+    else if(move.is_castle())
+    {
+        const auto rook_start = Square{move.movement().file_change > 0 ? 'h' : 'a', move.start().rank()};
+        const auto rook_end = move.start() + move.movement().step();
+        move_piece({rook_start, rook_end});
+        castling_index[std::to_underlying(whose_turn())] = played_ply_count() - 1;
+        castling_movement[std::to_underlying(whose_turn())] = move.movement().file_change;
+    }
+
     switch_turn();
 
-    recreate_move_caches();
+    update_move_caches();
 
     add_board_position_to_repeat_record();
 }
@@ -521,13 +594,13 @@ void Board::move_piece(const Move& move) noexcept
     if(piece_on_square(move.end()))
     {
         remove_piece(move.end());
-        clear_repeat_count();
+        reset_moves_since_pawn_or_capture();
     }
 
     const auto moving_piece = piece_on_square(move.start());
     if(moving_piece.type() == Piece_Type::PAWN)
     {
-        clear_repeat_count();
+        reset_moves_since_pawn_or_capture();
     }
     else if(moving_piece.type() == Piece_Type::KING)
     {
@@ -543,14 +616,81 @@ Piece_Color Board::whose_turn() const noexcept
     return turn_color;
 }
 
-const std::vector<const Move*>& Board::legal_moves() const noexcept
+const Board::move_list& Board::legal_moves() const noexcept
 {
+    if(legal_moves_cache_is_stale)
+    {
+        generate_legal_moves();
+    }
+
     return legal_moves_cache;
 }
 
 bool Board::attacked_by(Square target, Piece_Color attacker) const noexcept
 {
-    return moves_attacking_square(target, attacker).any();
+    // Attacks pass through the king of the defending color so that
+    // a king cannot escape check by moving along the line of attack.
+    const auto defending_king = pieces(opposite(attacker), Piece_Type::KING);
+    return attackers_of(target, attacker, occupied_squares() & ~defending_king) != 0;
+}
+
+Bitboard::bitboard_t Board::occupied_squares() const noexcept
+{
+    return color_squares[std::to_underlying(Piece_Color::WHITE)] | color_squares[std::to_underlying(Piece_Color::BLACK)];
+}
+
+Bitboard::bitboard_t Board::pieces(const Piece_Color color, const Piece_Type type) const noexcept
+{
+    return color_squares[std::to_underlying(color)] & piece_type_squares[std::to_underlying(type)];
+}
+
+Bitboard::bitboard_t Board::attackers_of(const Square target, const Piece_Color attacking_color, const Bitboard::bitboard_t occupied) const noexcept
+{
+    const auto queens = pieces(attacking_color, Piece_Type::QUEEN);
+    return (Bitboard::pawn_attacks(target, opposite(attacking_color)) & pieces(attacking_color, Piece_Type::PAWN))
+         | (Bitboard::knight_attacks(target) & pieces(attacking_color, Piece_Type::KNIGHT))
+         | (Bitboard::king_attacks(target) & pieces(attacking_color, Piece_Type::KING))
+         | (Bitboard::rook_attacks(target, occupied) & (pieces(attacking_color, Piece_Type::ROOK) | queens))
+         | (Bitboard::bishop_attacks(target, occupied) & (pieces(attacking_color, Piece_Type::BISHOP) | queens));
+}
+
+Bitboard::bitboard_t Board::checking_pieces() const noexcept
+{
+    return checking_pieces_cache;
+}
+
+Bitboard::bitboard_t Board::pinned_pieces() const noexcept
+{
+    return pinned_pieces_cache;
+}
+
+Bitboard::bitboard_t Board::find_checking_pieces() const noexcept
+{
+    return attackers_of(find_king(whose_turn()), opposite(whose_turn()), occupied_squares());
+}
+
+Bitboard::bitboard_t Board::find_pinned_pieces() const noexcept
+{
+    const auto king_color = whose_turn();
+    const auto king_square = find_king(king_color);
+    const auto attacking_color = opposite(king_color);
+    const auto attacking_pieces = color_squares[std::to_underlying(attacking_color)];
+    const auto queens = pieces(attacking_color, Piece_Type::QUEEN);
+    auto pinning_pieces = (Bitboard::rook_attacks(king_square, attacking_pieces) & (pieces(attacking_color, Piece_Type::ROOK) | queens))
+                        | (Bitboard::bishop_attacks(king_square, attacking_pieces) & (pieces(attacking_color, Piece_Type::BISHOP) | queens));
+
+    Bitboard::bitboard_t pinned = 0;
+    while(pinning_pieces)
+    {
+        const auto pinning_square = Bitboard::pop_first_square(pinning_pieces);
+        const auto blockers = Bitboard::squares_between(king_square, pinning_square) & occupied_squares();
+        if(Bitboard::count(blockers) == 1)
+        {
+            pinned |= blockers;
+        }
+    }
+
+    return pinned & color_squares[std::to_underlying(king_color)];
 }
 
 void Board::remove_piece(const Square square) noexcept
@@ -580,121 +720,37 @@ void Board::place_piece(const Piece piece, const Square square) noexcept
     const auto old_piece = piece_on_square(square);
     piece_on_square(square) = piece;
 
-    remove_attacks_from(square, old_piece);
-    update_blocks(square, old_piece, piece);
-    add_attacks_from(square, piece);
-
-    update_board_hash(square); // XOR in new piece on square
-
-    if(piece && piece.type() == Piece_Type::KING)
+    const auto square_bit = Bitboard::square_bit(square);
+    if(old_piece)
     {
-        record_king_location(piece.color(), square);
+        color_squares[std::to_underlying(old_piece.color())] &= ~square_bit;
+        piece_type_squares[std::to_underlying(old_piece.type())] &= ~square_bit;
+        update_material(old_piece, square, -1);
     }
-}
-
-void Board::record_king_location(const Piece_Color color, const Square square)
-{
-    king_location[std::to_underlying(color)] = square;
-}
-
-void Board::add_attacks_from(const Square square, const Piece piece) noexcept
-{
-    modify_attacks(square, piece, true);
-}
 
-void Board::modify_attacks(const Square square, const Piece piece, const bool adding_attacks) noexcept
-{
-    if( ! piece)
+    if(piece)
     {
-        return;
+        color_squares[std::to_underlying(piece.color())] |= square_bit;
+        piece_type_squares[std::to_underlying(piece.type())] |= square_bit;
+        update_material(piece, square, 1);
     }
 
-    const auto attacking_color = piece.color();
-    const auto vulnerable_king = Piece{opposite(attacking_color), Piece_Type::KING};
-    for(const auto& attack_move_list : piece.attacking_move_lists(square))
-    {
-        for(const auto attack : attack_move_list)
-        {
-            const auto attacked_square = attack->end();
-            const auto attacked_index = attacked_square.index();
-
-            potential_attacks[std::to_underlying(attacking_color)][attacked_index][attack->attack_index()] = adding_attacks;
-
-            const auto blocking_piece = piece_on_square(attacked_square);
-            if(blocking_piece && blocking_piece != vulnerable_king)
-            {
-                break;
-            }
-        }
-    }
-}
-
-void Board::remove_attacks_from(const Square square, const Piece old_piece) noexcept
-{
-    modify_attacks(square, old_piece, false);
-}
-
-void Board::update_blocks(const Square square, const Piece old_piece, const Piece new_piece) noexcept
-{
-    // Replacing nothing with nothing changes nothing.
-    // Replacing one piece with another does not change which
-    // moves are blocked. Only happens during pawn promotions.
-    if(bool(old_piece) == bool(new_piece))
-    {
-        return;
-    }
-
-    const auto add_new_attacks = ! new_piece; // New pieces block; no new pieces allow new moves through
-    const auto origin_square_index = square.index();
+    update_board_hash(square); // XOR in new piece on square
 
-    for(const auto attacking_color : {Piece_Color::WHITE, Piece_Color::BLACK})
+    if(piece && piece.type() == Piece_Type::KING)
     {
-        const auto vulnerable_king = Piece{opposite(attacking_color), Piece_Type::KING};
-        if(new_piece == vulnerable_king)
-        {
-            continue;
-        }
-
-        const auto& attack_direction_list = potential_attacks[std::to_underlying(attacking_color)][origin_square_index];
-        for(size_t index = 0; index < 8; ++index) // < 8 to exclude knight moves, which are never blocked
-        {
-            if(attack_direction_list[index])
-            {
-                const auto step = Move::attack_direction_from_index(index);
-                const auto revealed_attacker = piece_on_square(square - step);
-                if(revealed_attacker && (revealed_attacker.type() == Piece_Type::PAWN || revealed_attacker.type() == Piece_Type::KING))
-                {
-                    continue; // Pawns and kings are never blocked
-                }
-
-                for(const auto target_square : Square::square_line_from(square, step))
-                {
-                    potential_attacks[std::to_underlying(attacking_color)][target_square.index()][index] = add_new_attacks;
-
-                    const auto piece = piece_on_square(target_square);
-                    if(piece && piece != vulnerable_king)
-                    {
-                        break;
-                    }
-                }
-            }
-        }
+        record_king_location(piece.color(), square);
     }
 }
 
-std::bitset<16> Board::moves_attacking_square(const Square square, const Piece_Color attacking_color) const noexcept
-{
-    return potential_attacks[std::to_underlying(attacking_color)][square.index()];
-}
-
-std::bitset<16> Board::checking_moves() const noexcept
+void Board::record_king_location(const Piece_Color color, const Square square)
 {
-    return moves_attacking_square(find_king(whose_turn()), opposite(whose_turn()));
+    king_location[std::to_underlying(color)] = square;
 }
 
 bool Board::king_is_in_check() const noexcept
 {
-    return attacked_by(find_king(whose_turn()), opposite(whose_turn()));
+    return checking_pieces() != 0;
 }
 
 bool Board::safe_for_king(const Square square, const Piece_Color king_color) const noexcept
@@ -703,6 +759,11 @@ bool Board::safe_for_king(const Square square, const Piece_Color king_color) con
 }
 
 bool Board::king_is_in_check_after_move(const Move& move) const noexcept
+{
+    return king_is_in_check_after_move(move, checking_pieces(), pinned_pieces());
+}
+
+bool Board::king_is_in_check_after_move(const Move& move, const Bitboard::bitboard_t checkers, const Bitboard::bitboard_t pinned) const noexcept
 {
     const auto king_square = find_king(whose_turn());
     if(move.start() == king_square)
@@ -710,52 +771,27 @@ bool Board::king_is_in_check_after_move(const Move& move) const noexcept
         return ! safe_for_king(move.end(), whose_turn());
     }
 
-    if(king_is_in_check())
+    if(Bitboard::count(checkers) > 1)
     {
-        if(king_multiply_checked())
-        {
-            return true;
-        }
-
-        assert(checking_square.is_set());
-        if(in_line_in_order(checking_square, move.end(), king_square))
-        {
-            return piece_is_pinned(move.start());
-        }
-
-        if(move.is_en_passant(*this)) 
-        {
-            const auto captured_pawn_square = Square{move.end().file(), move.start().rank()};
-            return checking_square != captured_pawn_square || piece_is_pinned(move.start());
-        }
-
-        // Nothing is done about the check
         return true;
     }
 
-    if(piece_is_pinned(move.start()))
+    if(move.is_en_passant())
     {
-        return ! moves_are_parallel(move.movement(), king_square - move.start());
+        // Removing two pieces from the board can reveal attacks that are not detected by pins.
+        const auto captured_pawn = Bitboard::square_bit({move.end().file(), move.start().rank()});
+        const auto occupied_after = (occupied_squares() & ~Bitboard::square_bit(move.start()) & ~captured_pawn) | Bitboard::square_bit(move.end());
+        return (attackers_of(king_square, opposite(whose_turn()), occupied_after) & ~captured_pawn) != 0;
     }
 
-    if(move.is_en_passant(*this) && king_square.rank() == move.start().rank())
+    const auto end_bit = Bitboard::square_bit(move.end());
+    if(checkers != 0 && ((checkers | Bitboard::squares_between(king_square, Bitboard::first_square(checkers))) & end_bit) == 0)
     {
-        const auto squares = Square::square_line_from(king_square, (move.start() - king_square).step());
-        const auto rook = Piece{opposite(whose_turn()), Piece_Type::ROOK};
-        const auto queen = Piece{opposite(whose_turn()), Piece_Type::QUEEN};
-        const auto revealed_attacker =
-            std::ranges::find_if(squares,
-                                 [this, rook, queen](auto square)
-                                 {
-                                     const auto piece = piece_on_square(square);
-                                     return piece == rook || piece == queen;
-                                 });
-
-        return revealed_attacker != squares.end() &&
-               Algorithm::has_exactly_n(squares.begin(), revealed_attacker, [this](auto square) { return piece_on_square(square); }, 2);
+        // Nothing is done about the check
+        return true;
     }
 
-    return false;
+    return (pinned & Bitboard::square_bit(move.start())) && ! (Bitboard::line_through(king_square, move.start()) & end_bit);
 }
 
 bool Board::move_checks_king(const Move& move) const noexcept
@@ -764,15 +800,15 @@ bool Board::move_checks_king(const Move& move) const noexcept
     const auto moving_piece = piece_on_square(move.start());
     const auto piece = move.promotion() ? move.promotion() : moving_piece;
     const auto& after_moves = piece.attacking_move_lists(move.end());
-    for(const auto& move_list : after_moves)
+    for(const auto& attack_list : after_moves)
     {
-        const auto checking_move = std::find_if(move_list.begin(),
-                                                move_list.end(),
+        const auto checking_move = std::find_if(attack_list.begin(),
+                                                attack_list.end(),
                                                 [opponent_king_square](auto attack)
                                                 {
                                                     return attack->end() == opponent_king_square;
                                                 });
-        if(checking_move != move_list.end())
+        if(checking_move != attack_list.end())
         {
             const auto found_move = *checking_move;
             return piece.type() == Piece_Type::KNIGHT || all_empty_between(found_move->start(),
@@ -785,7 +821,51 @@ bool Board::move_checks_king(const Move& move) const noexcept
 
 bool Board::no_legal_moves() const noexcept
 {
-    return legal_moves().empty();
+    if( ! legal_moves_cache_is_stale)
+    {
+        return legal_moves_cache.empty();
+    }
+
+    return ! unpinned_piece_can_move() && legal_moves().empty();
+}
+
+bool Board::unpinned_piece_can_move() const noexcept
+{
+    // When the king is not in check, any pseudo-legal move by a piece other than the king
+    // that is not pinned is legal, so finding one is much quicker than generating moves.
+    // If none is found, the position is unusual enough that the full move list is cheap.
+    if(checking_pieces())
+    {
+        return false;
+    }
+
+    const auto own_pieces = color_squares[std::to_underlying(whose_turn())];
+    const auto occupied = occupied_squares();
+    const auto free_pieces = own_pieces & ~pinned_pieces();
+
+    // Moving forward one rank adds one to a square's index.
+    const auto pawns = pieces(whose_turn(), Piece_Type::PAWN) & free_pieces;
+    if((whose_turn() == Piece_Color::WHITE ? pawns << 1 : pawns >> 1) & ~occupied)
+    {
+        return true;
+    }
+
+    auto movers = free_pieces & ~pieces(whose_turn(), Piece_Type::PAWN) & ~pieces(whose_turn(), Piece_Type::KING);
+    while(movers)
+    {
+        const auto square = Bitboard::pop_first_square(movers);
+        const auto type = piece_on_square(square).type();
+        const auto attacks = type == Piece_Type::KNIGHT ? Bitboard::knight_attacks(square)
+                           : type == Piece_Type::BISHOP ? Bitboard::bishop_attacks(square, occupied)
+                           : type == Piece_Type::ROOK ? Bitboard::rook_attacks(square, occupied)
+                           : Bitboard::rook_attacks(square, occupied) | Bitboard::bishop_attacks(square, occupied);
+        if(attacks & ~own_pieces)
+        {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 void Board::make_en_passant_targetable(const Square square) noexcept
@@ -818,129 +898,134 @@ Square Board::find_king(const Piece_Color color) const noexcept
     return king_location[std::to_underlying(color)];
 }
 
-void Board::recreate_move_caches() noexcept
+void Board::update_move_caches() noexcept
 {
-    checking_square = find_checking_square();
-    legal_moves_cache.clear();
-    for(const auto square : Square::all_squares())
-    {
-        const auto piece = piece_on_square(square);
-        if(piece && piece.color() == whose_turn())
-        {
-            for(const auto& move_list : piece.move_lists(square))
-            {
-                for(const auto move : move_list)
-                {
-                    if(move->is_legal(*this))
-                    {
-                        legal_moves_cache.push_back(move);
-                    }
-
-                    if(piece_on_square(move->end()))
-                    {
-                        break;
-                    }
-                }
-            }
-        }
-    }
+    legal_moves_cache_is_stale = true;
+    checking_pieces_cache = find_checking_pieces();
+    pinned_pieces_cache = find_pinned_pieces();
 
-    if(en_passant_target.is_set() && std::ranges::none_of(legal_moves_cache, [this](const auto move) { return move->is_en_passant(*this); }))
+    if(en_passant_target.is_set() && ! en_passant_is_possible())
     {
         disable_en_passant_target();
     }
 }
 
-void Board::disable_en_passant_target() noexcept
+bool Board::en_passant_is_possible() const noexcept
 {
-    unused_en_passant_target = en_passant_target;
-    clear_en_passant_target();
+    auto capturers = Bitboard::pawn_attacks(en_passant_target, opposite(whose_turn())) & pieces(whose_turn(), Piece_Type::PAWN);
+    while(capturers)
+    {
+        const auto start = Bitboard::pop_first_square(capturers);
+        const auto direction = en_passant_target.file() < start.file() ? Direction::LEFT : Direction::RIGHT;
+        if( ! king_is_in_check_after_move(Move::from_code(Move::en_passant(whose_turn(), start.file(), direction).code())))
+        {
+            return true;
+        }
+    }
+
+    return false;
 }
 
-Square Board::find_checking_square() const noexcept
+void Board::generate_legal_moves() const noexcept
 {
-    if( ! king_is_in_check())
-    {
-        return {};
-    }
+    legal_moves_cache.clear();
+    legal_moves_cache_is_stale = false;
 
-    const auto checking_index = std::countr_zero(checking_moves().to_ulong());
-    const auto step = Move::attack_direction_from_index(checking_index);
-    const auto king_square = find_king(whose_turn());
-    const auto squares = Square::square_line_from(king_square, -step);
-    return *std::ranges::find_if(squares, [this](auto square) { return piece_on_square(square); });
+    Move_Generator::all_legal_moves(*this, legal_moves_cache);
 }
 
-bool Board::enough_material_to_checkmate(const Piece_Color piece_color) const noexcept
+void Board::disable_en_passant_target() noexcept
 {
-    auto piece_is_right = [piece_color](const auto piece, const auto type) { return piece == Piece{piece_color, type}; };
+    unused_en_passant_target = en_passant_target;
+    clear_en_passant_target();
+}
 
-    if(std::ranges::any_of(board,
-                           [piece_is_right](const auto piece)
-                           {
-                               return piece_is_right(piece, Piece_Type::QUEEN) ||
-                                   piece_is_right(piece, Piece_Type::ROOK) ||
-                                   piece_is_right(piece, Piece_Type::PAWN);
-                           }))
+bool Board::enough_material_to_checkmate(const Piece_Color piece_color) const noexcept
+{
+    if(piece_count(piece_color, Piece_Type::QUEEN) > 0 ||
+       piece_count(piece_color, Piece_Type::ROOK) > 0 ||
+       piece_count(piece_color, Piece_Type::PAWN) > 0)
     {
         return true;
     }
 
-    const auto knight_count = std::ranges::count_if(board, [piece_is_right](const auto piece) { return piece_is_right(piece, Piece_Type::KNIGHT); });
+    const auto knight_count = piece_count(piece_color, Piece_Type::KNIGHT);
     if(knight_count > 1)
     {
         return true;
     }
 
-    auto bishop_on_square_color =
-        [this, piece_is_right](const Square_Color square_color, const Square square)
-        {
-            return piece_is_right(piece_on_square(square), Piece_Type::BISHOP) && square.color() == square_color;
-        };
-
-    const auto squares = Square::all_squares();
-    const auto bishops_on_white =
-        std::ranges::any_of(squares, [bishop_on_square_color](const auto square) { return bishop_on_square_color(Square_Color::WHITE, square); });
-    const auto bishops_on_black =
-        std::ranges::any_of(squares, [bishop_on_square_color](const auto square) { return bishop_on_square_color(Square_Color::BLACK, square); });
+    const auto bishops_on_white = bishop_count(piece_color, Square_Color::WHITE) > 0;
+    const auto bishops_on_black = bishop_count(piece_color, Square_Color::BLACK) > 0;
     return (bishops_on_white && bishops_on_black) || (knight_count > 0 && (bishops_on_white || bishops_on_black));
 }
 
 bool Board::enough_material_to_checkmate() const noexcept
 {
-    auto piece_is_right = [](auto piece, auto type) { return piece && piece.type() == type; };
+    auto total_count = [this](const Piece_Type type)
+                       {
+                           return piece_count(Piece_Color::WHITE, type) + piece_count(Piece_Color::BLACK, type);
+                       };
 
-    if(std::ranges::any_of(board,
-                           [piece_is_right](const auto piece)
-                           {
-                               return piece_is_right(piece, Piece_Type::QUEEN) ||
-                                   piece_is_right(piece, Piece_Type::ROOK) ||
-                                   piece_is_right(piece, Piece_Type::PAWN);
-                           }))
+    if(total_count(Piece_Type::QUEEN) > 0 || total_count(Piece_Type::ROOK) > 0 || total_count(Piece_Type::PAWN) > 0)
     {
         return true;
     }
 
-    const auto knight_count = std::ranges::count_if(board, [piece_is_right](const auto piece) { return piece_is_right(piece, Piece_Type::KNIGHT); });
+    const auto knight_count = total_count(Piece_Type::KNIGHT);
     if(knight_count > 1)
     {
         return true;
     }
 
-    auto bishop_on_square_color =
-        [this, piece_is_right](const Square_Color square_color, const Square square)
-        {
-            return piece_is_right(piece_on_square(square), Piece_Type::BISHOP) && square.color() == square_color;
-        };
+    auto bishops_on = [this](const Square_Color square_color)
+                      {
+                          return bishop_count(Piece_Color::WHITE, square_color) + bishop_count(Piece_Color::BLACK, square_color) > 0;
+                      };
 
-    const auto squares = Square::all_squares();
-    const auto bishops_on_white =
-        std::ranges::any_of(squares, [bishop_on_square_color](const auto square) { return bishop_on_square_color(Square_Color::WHITE, square); });
-    const auto bishops_on_black =
-        std::ranges::any_of(squares, [bishop_on_square_color](const auto square) { return bishop_on_square_color(Square_Color::BLACK, square); });
+    const auto bishops_on_white = bishops_on(Square_Color::WHITE);
+    const auto bishops_on_black = bishops_on(Square_Color::BLACK);
     return (bishops_on_white && bishops_on_black) || (knight_count > 0 && (bishops_on_white || bishops_on_black));
 }
 
+int Board::piece_count(const Piece_Color color, const Piece_Type type) const noexcept
+{
+    return piece_counts[std::to_underlying(color)][std::to_underlying(type)];
+}
+
+int Board::bishop_count(const Piece_Color bishop_color, const Square_Color square_color) const noexcept
+{
+    return bishop_square_counts[std::to_underlying(bishop_color)][std::to_underlying(square_color)];
+}
+
+uint64_t Board::material_key() const noexcept
+{
+    return material_signature;
+}
+
+Square_Set Board::piece_squares(const Piece_Color color) const noexcept
+{
+    return Square_Set(color_squares[std::to_underlying(color)]);
+}
+
+Square_Set Board::piece_squares(const Piece_Color color, const Piece_Type type) const noexcept
+{
+    return Square_Set(pieces(color, type));
+}
+
+void Board::update_material(const Piece piece, const Square square, const int change) noexcept
+{
+    piece_counts[std::to_underlying(piece.color())][std::to_underlying(piece.type())] += change;
+    if(piece.type() == Piece_Type::BISHOP)
+    {
+        bishop_square_counts[std::to_underlying(piece.color())][std::to_underlying(square.color())] += change;
+    }
+
+    // No piece count can exceed 10 (2 original pieces plus 8 promotions), so four bits is enough.
+    const auto count_bit = uint64_t{1} << (4*piece.index());
+    material_signature = change > 0 ? material_signature + count_bit : material_signature - count_bit;
+}
+
 void Board::update_board_hash(const Square square) noexcept
 {
     current_board_hash ^= square_hash(square);
@@ -969,7 +1054,7 @@ bool Board::move_captures(const Move& move) const noexcept
     assert(is_in_legal_moves_list(move));
     assert( ! attacked_piece || (move.can_capture() && attacked_piece.color() == opposite(whose_turn())));
 
-    return attacked_piece || move.is_en_passant(*this);
+    return attacked_piece || move.is_en_passant();
 }
 
 bool Board::move_changes_material(const Move& move) const noexcept
@@ -977,16 +1062,10 @@ bool Board::move_changes_material(const Move& move) const noexcept
     return move_captures(move) || move.promotion_piece_symbol();
 }
 
-bool Board::king_multiply_checked() const noexcept
-{
-    return checking_moves().count() > 1;
-}
-
 bool Board::all_empty_between(const Square start, const Square end) const noexcept
 {
     assert(straight_line_move(start, end));
-    const auto squares = Square::squares_between(start, end);
-    return std::ranges::none_of(squares, [this](auto square) { return piece_on_square(square); });
+    return (Bitboard::squares_between(start, end) & occupied_squares()) == 0;
 }
 
 bool Board::piece_is_pinned(const Square square) const noexcept
@@ -1006,52 +1085,82 @@ bool Board::is_discovered_check(const Move& move) const noexcept
 bool Board::piece_is_pinned_to_king(const Piece_Color king_color, const Square square) const noexcept
 {
     const auto king_square = find_king(king_color);
-    if(king_square == square || ! straight_line_move(square, king_square))
+    if(king_square == square || ! straight_line_move(square, king_square) || ! all_empty_between(king_square, square))
     {
         return false;
     }
 
-    const auto direction = (king_square - square).step();
-    const auto attack_square = square - direction;
+    // Look for a sliding piece beyond the square on the line from the king.
     const auto attacking_color = opposite(king_color);
-    const auto color_index = std::to_underlying(attacking_color);
-    const auto opponent_pawn = Piece(attacking_color, Piece_Type::PAWN);
-    const auto opponent_king = Piece(attacking_color, Piece_Type::KING);
-    return potential_attacks[color_index][square.index()][Move::attack_index(direction)]
-        && piece_on_square(attack_square) != opponent_pawn
-        && piece_on_square(attack_square) != opponent_king
-        && all_empty_between(king_square, square);
+    const auto queens = pieces(attacking_color, Piece_Type::QUEEN);
+    const auto line = Bitboard::line_through(king_square, square);
+    const auto diagonal = king_square.file() != square.file() && king_square.rank() != square.rank();
+    const auto pinning_pieces = diagonal ? (pieces(attacking_color, Piece_Type::BISHOP) | queens) : (pieces(attacking_color, Piece_Type::ROOK) | queens);
+    const auto attacks = diagonal ? Bitboard::bishop_attacks(square, occupied_squares()) : Bitboard::rook_attacks(square, occupied_squares());
+    return (attacks & line & pinning_pieces) != 0;
 }
 
 void Board::add_board_position_to_repeat_record() noexcept
 {
-    add_to_repeat_count(board_hash());
+    // Overwrites a position too old to be repeated
+    history().record(all_ply_count(), board_hash());
+}
+
+Position_History& Board::history() const noexcept
+{
+    assert(position_history);
+    return *position_history;
 }
 
-void Board::add_to_repeat_count(const uint64_t new_hash) noexcept
+void Board::use_position_history(Position_History& new_history) noexcept
 {
-    repeat_count.push_back(new_hash);
+    if(position_history)
+    {
+        const auto plies_back = std::min(moves_since_pawn_or_capture(), played_ply_count());
+        for(auto ply = all_ply_count() - plies_back; ply < all_ply_count(); ++ply)
+        {
+            new_history.record(ply, position_history->hash_at(ply));
+        }
+    }
+    position_history = &new_history;
+    add_board_position_to_repeat_record();
 }
 
 ptrdiff_t Board::current_board_position_repeat_count() const noexcept
 {
-    return std::ranges::count(repeat_count, board_hash());
+    return repeat_count_from_depth(moves_since_pawn_or_capture());
 }
 
 size_t Board::moves_since_pawn_or_capture() const noexcept
 {
-    return repeat_count.size() - 1;
+    return moves_since_pawn_or_capture_count;
 }
 
 std::ptrdiff_t Board::repeat_count_from_depth(size_t depth) const noexcept
 {
-    depth = std::min(depth, repeat_count.size() - 1);
-    return std::count(repeat_count.end() - depth - 1, repeat_count.end(), board_hash());
+    // Positions before the last pawn move or capture cannot be repeated. Only positions
+    // with the same player to move can match, so every other ply is skipped.
+    depth = std::min({depth, moves_since_pawn_or_capture(), played_ply_count()});
+    if(depth < 2)
+    {
+        return 1;
+    }
+
+    const auto& positions = history();
+    std::ptrdiff_t count = 1;
+    for(size_t plies_back = 2; plies_back <= depth; plies_back += 2)
+    {
+        if(positions.hash_at(all_ply_count() - plies_back) == board_hash())
+        {
+            ++count;
+        }
+    }
+    return count;
 }
 
-void Board::clear_repeat_count() noexcept
+void Board::reset_moves_since_pawn_or_capture() noexcept
 {
-    repeat_count.clear();
+    moves_since_pawn_or_capture_count = 0;
 }
 
 size_t Board::castling_move_index(const Piece_Color player) const noexcept
@@ -1064,14 +1173,14 @@ bool Board::player_castled(const Piece_Color player) const noexcept
     return castling_direction(player) != 0;
 }
 
-Board Board::without_random_pawn() const noexcept
+Board Board::without_random_pawn(Random::Random_Bits_Generator& generator) const noexcept
 {
     assert(std::ranges::any_of(board, [](auto p) { return p && p.type() == Piece_Type::PAWN; }));
 
     auto result = *this;
     while(true)
     {
-        const auto square = Square('a' + char(Random::random_integer(0, 7)), Random::random_integer(1, 8));
+        const auto square = Square('a' + char(Random::random_integer(0, 7, generator)), Random::random_integer(1, 8, generator));
         const auto piece = result.piece_on_square(square);
         if(piece && piece.type() == Piece_Type::PAWN)
         {
@@ -1081,49 +1190,59 @@ Board Board::without_random_pawn() const noexcept
     }
 }
 
-std::vector<const Move*> Board::quiescent(const std::array<double, 6>& piece_values) const noexcept
+Board::quiescent_move_list Board::quiescent(const std::array<double, 6>& piece_values) noexcept
 {
+    quiescent_move_list capture_moves;
     if( ! previous_move)
     {
-        return {};
+        return capture_moves;
     }
 
     // The capture_move at index i results in the state_value at index i + 1
-    std::vector<const Move*> capture_moves;
-    std::vector<double> state_values = {0.0};
+    Fixed_Capacity_Vector<double, maximum_quiescent_captures + 1> state_values;
+    state_values.push_back(0.0);
 
     const auto player_color = whose_turn();
-    auto current_board = *this;
+    Fixed_Capacity_Vector<Undo_Record, maximum_quiescent_captures> undo_records;
     const auto square = previous_move->end();
-    while(current_board.attacked_by(square, current_board.whose_turn()))
+    const auto attacker_value = [&piece_values, this](const Move* move)
+                                {
+                                    return piece_values[std::to_underlying(piece_on_square(move->start()).type())];
+                                };
+    while( ! capture_moves.full() && attacked_by(square, whose_turn()))
     {
-        std::vector<const Move*> capturing_moves;
-        std::ranges::copy_if(current_board.legal_moves(), std::back_inserter(capturing_moves), [square](auto move) { return move->end() == square; });
+        // Attack with the weakest piece first
+        const Move* move = nullptr;
+        auto captures = Move_Generator(*this, nullptr, true);
+        while(const auto capture = captures.next())
+        {
+            if(capture->end() == square && ( ! move || attacker_value(capture) < attacker_value(move)))
+            {
+                move = capture;
+            }
+        }
 
-        if(capturing_moves.empty())
+        if( ! move)
         {
             // This can happen when the only attacking piece is a king
             // and the attacked piece is guarded.
             break;
         }
 
-        // Attack with the weakest piece first
-        const auto move =
-            *std::ranges::min_element(capturing_moves,
-                                      [&piece_values, &current_board](auto move1, auto move2)
-                                      {
-                                          return piece_values[std::to_underlying(current_board.piece_on_square(move1->start()).type())] <
-                                              piece_values[std::to_underlying(current_board.piece_on_square(move2->start()).type())];
-                                      });
-
         // Make sure that an exchange does not lose material
-        const auto moving_piece = current_board.piece_on_square(move->start());
-        const auto attacked_piece = current_board.piece_on_square(move->end());
-        current_board.play_move(*move);
+        const auto moving_piece = piece_on_square(move->start());
+        const auto attacked_piece = piece_on_square(move->end());
+        undo_records.push_back({});
+        make_move(*move, undo_records.back());
         capture_moves.push_back(move);
         state_values.push_back(state_values.back() + (moving_piece.color() == player_color ? +1 : -1)*piece_values[std::to_underlying(attacked_piece.type())]);
     }
 
+    while( ! undo_records.empty())
+    {
+        unmake_move(undo_records.back());
+        undo_records.pop_back();
+    }
 
     if(capture_moves.empty())
     {
@@ -1132,21 +1251,20 @@ std::vector<const Move*> Board::quiescent(const std::array<double, 6>& piece_val
 
     // Make sure to stop before either player ends up in an
     // avoidable loss of material.
-    auto minimax_iter = state_values.rbegin();
-    auto minimax_value = *minimax_iter;
-    for(auto iter = std::next(minimax_iter); iter != state_values.rend(); std::advance(iter, 1))
+    auto minimax_index = state_values.size() - 1;
+    auto minimax_value = state_values[minimax_index];
+    for(auto index = minimax_index; index > 0; --index)
     {
-        auto value = *iter;
+        const auto value = state_values[index - 1];
 
         // Even indices indicate a player's choice (maximize score).
         // Odd indices indicate an opponent's choice (minimize score).
-        const auto index = std::distance(iter, state_values.rend()) - 1;
-        if(index % 2 == 0)
+        if((index - 1) % 2 == 0)
         {
             if(value > minimax_value)
             {
                 minimax_value = value;
-                minimax_iter = iter;
+                minimax_index = index - 1;
             }
         }
         else
@@ -1154,13 +1272,13 @@ std::vector<const Move*> Board::quiescent(const std::array<double, 6>& piece_val
             if(value < minimax_value)
             {
                 minimax_value = value;
-                minimax_iter = iter;
+                minimax_index = index - 1;
             }
         }
     }
 
-    const auto minimax_index = std::distance(minimax_iter, state_values.rend()) - 1;
-    return {capture_moves.begin(), capture_moves.begin() + minimax_index};
+    capture_moves.erase(capture_moves.begin() + minimax_index, capture_moves.end());
+    return capture_moves;
 }
 
 void Board::compare_hashes(const Board& other) const noexcept
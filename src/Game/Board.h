@@ -4,19 +4,22 @@
 #include <vector>
 #include <string>
 #include <array>
-#include <bitset>
 #include <cstdint>
+#include <type_traits>
 
 #include "Game/Color.h"
 #include "Game/Square.h"
 #include "Game/Piece.h"
+#include "Game/Bitboard.h"
 
 #include "Utility/Fixed_Capacity_Vector.h"
+#include "Utility/Random.h"
 
 class Clock;
 class Game_Result;
 class Player;
 class Move;
+class Position_History;
 enum class Direction;
 
 class UCI_Mediator;
@@ -29,6 +32,11 @@ class UCI_Mediator;
 //! Some abbreviation definitions:
 //! - FEN: Forsyth-Edwards Notation: a succinct format for encoding the state of a board in text. (https://en.wikipedia.org/wiki/Forsyth%E2%80%93Edwards_Notation)
 //! - PGN: Portable Game Notation: the standard way of recording moves in a game. (https://en.wikipedia.org/wiki/Portable_Game_Notation)
+//!
+//! The record of past positions used to detect threefold repetition (see Position_History)
+//! is kept outside the board and must be given to it with use_position_history() before any
+//! move is played. This is checked in DEBUG builds. Copies of a board share its history, so
+//! playing different moves on two copies at the same time requires giving the copy its own history.
 class Board
 {
     public:
@@ -50,6 +58,45 @@ class Board
         //! \returns Returns a Game_Result indicating the result of the move and whether the game has ended.
         Game_Result play_move(const Move& move) noexcept;
 
+        //! \brief A record of the board state that is lost when a move is played.
+        //!
+        //! An instance is filled in by Board::make_move() and is used by Board::unmake_move()
+        //! to return the board to the state it had before the move.
+        class Undo_Record
+        {
+            private:
+                const Move* move = nullptr;
+                const Move* previous_move = nullptr;
+                Piece moving_piece;
+                Piece captured_piece;
+                Square capture_square;
+                std::array<std::array<bool, 2>, 2> legal_castles{};
+                Square en_passant_target;
+                Square unused_en_passant_target;
+                uint64_t board_hash = 0;
+                Bitboard::bitboard_t checking_pieces = 0;
+                Bitboard::bitboard_t pinned_pieces = 0;
+                size_t moves_since_pawn_or_capture = 0;
+
+                friend class Board;
+        };
+
+        //! \brief Updates the state of the board according to a Player-selected Move in a way that can be reversed.
+        //!
+        //! \param move A Move-class instance. This must be an item taken from Board::legal_moves().
+        //! \param undo A record that will be filled with the data needed by Board::unmake_move().
+        //! \returns Returns a Game_Result indicating the result of the move and whether the game has ended.
+        //!
+        //! This is much faster than copying the Board before playing a move, so it is useful for
+        //! searching the game tree.
+        Game_Result make_move(const Move& move, Undo_Record& undo) noexcept;
+
+        //! \brief Return the board to the state it was in before the last call to Board::make_move().
+        //!
+        //! \param undo The record filled in by the matching call to Board::make_move(). Calls to
+        //!        Board::unmake_move() must be made in the reverse order of the calls to Board::make_move().
+        void unmake_move(const Undo_Record& undo) noexcept;
+
         //! \brief Updates the state of the board according to the text-based move.
         //!
         //! This is equivalent to calling board.play_move(board.interpret_move(move)).
@@ -151,11 +198,23 @@ class Board
         //! \returns Piece instance on square. May be an invalid Piece if square is emtpy.
         Piece piece_on_square(Square square) const noexcept;
 
+        //! \brief The largest number of legal moves in any chess position.
+        static const size_t maximum_legal_moves = 218;
+
+        //! \brief A list of moves with room for all of the legal moves in any position.
+        using move_list = Fixed_Capacity_Vector<const Move*, maximum_legal_moves>;
+
+        //! \brief The largest number of captures returned by quiescent().
+        static const size_t maximum_quiescent_captures = 32;
+
+        //! \brief A list of moves with room for the longest series of captures from quiescent().
+        using quiescent_move_list = Fixed_Capacity_Vector<const Move*, maximum_quiescent_captures>;
+
         //! \brief Get a list of all legal moves for the current player.
         //!
         //! \returns A list of pointers to legal moves. Any call to Board::play_move() must take
         //!          its argument from this list.
-        const std::vector<const Move*>& legal_moves() const noexcept;
+        const move_list& legal_moves() const noexcept;
 
         //! \brief Whether there are no legal moves for the current player.
         //!
@@ -236,6 +295,35 @@ class Board
         //!          If the method returns false, this will usually lead to a drawn game.
         bool enough_material_to_checkmate() const noexcept;
 
+        //! \brief The number of pieces of a given color and type on the board.
+        //!
+        //! \param color The color of the pieces to count.
+        //! \param type The type of the pieces to count.
+        int piece_count(Piece_Color color, Piece_Type type) const noexcept;
+
+        //! \brief The number of bishops of a given color standing on a given color of square.
+        //!
+        //! \param bishop_color The color of the bishops to count.
+        //! \param square_color The color of the squares the bishops stand on.
+        int bishop_count(Piece_Color bishop_color, Square_Color square_color) const noexcept;
+
+        //! \brief A number that identifies the material on the board.
+        //!
+        //! Two boards have the same key if and only if they have the same number of each type of
+        //! piece for each color. Each count is stored in four bits, ordered by Piece::index().
+        uint64_t material_key() const noexcept;
+
+        //! \brief The squares occupied by all of a player's pieces.
+        //!
+        //! \param color The color of the pieces.
+        Square_Set piece_squares(Piece_Color color) const noexcept;
+
+        //! \brief The squares occupied by a player's pieces of one type.
+        //!
+        //! \param color The color of the pieces.
+        //! \param type The type of the pieces.
+        Square_Set piece_squares(Piece_Color color, Piece_Type type) const noexcept;
+
         //! \brief Check if castling is legal for the given player color and direction.
         //!
         //! \param color The color of the player.
@@ -268,6 +356,14 @@ class Board
         //! \param depth The number of plies to look back for equivalent positions.
         std::ptrdiff_t repeat_count_from_depth(size_t depth) const noexcept;
 
+        //! \brief Record this board's positions in a Position_History.
+        //!
+        //! A board must have a history before any moves are played on it. If the board already has
+        //! a history, the positions that can still be repeated are copied to the new history. Copies
+        //! of the board made after this call will also use the new history.
+        //! \param history The new history. It must outlive this board and its future copies.
+        void use_position_history(Position_History& history) noexcept;
+
         //! \brief Returns the Zobrist hash of the current state of the board.
         //!
         //! See https://en.wikipedia.org/wiki/Zobrist_hashing for details.
@@ -287,18 +383,21 @@ class Board
         //! \brief Create a copy of the board with a random pawn removed.
         //!
         //! This can be used by a Player to calibrate the value of a centipawn.
+        //! \param generator The source of randomness for picking the pawn. The same generator
+        //!        state always picks the same pawn.
         //! \exception Debug assertion failure if there are no pawns on the board.
-        Board without_random_pawn() const noexcept;
+        Board without_random_pawn(Random::Random_Bits_Generator& generator) const noexcept;
 
         //! \brief Returns a list of moves that results in a quiescent version of the board.
         //!
         //! This list is created by performing all possible captures on
         //! the ending square of the last move. If multiple captures are
         //! possible, the weakest pieces goes first according to the piece
-        //! values array.
+        //! values array. The captures are played and then unmade, so the
+        //! board is in its original state when this method returns.
         //! \param piece_values An array indexed by Piece::type() that gives
         //!        the value of the piece.
-        std::vector<const Move*> quiescent(const std::array<double, 6>& piece_values) const noexcept;
+        quiescent_move_list quiescent(const std::array<double, 6>& piece_values) noexcept;
 
         //! \brief Print data on why boards have different Zobrist hashes
         //!
@@ -307,7 +406,8 @@ class Board
 
     private:
         std::array<Piece, 64> board;
-        Fixed_Capacity_Vector<uint64_t, 101> repeat_count;
+        Position_History* position_history = nullptr;
+        size_t moves_since_pawn_or_capture_count = 0;
         Piece_Color turn_color = Piece_Color::WHITE;
         size_t game_move_count = 0;
         const Move* previous_move = nullptr;
@@ -316,32 +416,45 @@ class Board
         Square unused_en_passant_target;
         uint64_t starting_hash{};
         std::array<Square, 2> king_location;
-        Square checking_square;
         size_t plies_at_construction;
 
-        // Stores the moves that attack a square. The innermost array
-        // is filled with bools indicating the direction the piece attacking
-        // the square moves to reach that square: (from white's perspective)
-        // up, down, left, right, up-left, up-right, down-left, down-right,
-        // 2x1 up-left, 1x2 up-left, 2x1 up-right, 1x2 up-right,
-        // 2x1 down-left, 1x2 down-left, 2x1 down-right, 1x2 down-right
-        std::array<std::array<std::bitset<16>, 64>, 2> potential_attacks{}; // indexed by [attacker color][square index];
-
-        void add_attacks_from(Square square, Piece piece) noexcept;
-        void remove_attacks_from(Square square, Piece old_piece) noexcept;
-        void modify_attacks(Square square, Piece piece, bool adding_attacks) noexcept;
-        void update_blocks(Square square, Piece old_piece, Piece new_piece) noexcept;
-        std::bitset<16> moves_attacking_square(Square square, Piece_Color attacking_color) const noexcept;
-        std::bitset<16> checking_moves() const noexcept;
-        Square find_checking_square() const noexcept;
+        // Sets of squares occupied by each color and by each type of piece
+        std::array<Bitboard::bitboard_t, 2> color_squares{}; // indexed by [Piece_Color]
+        std::array<Bitboard::bitboard_t, 6> piece_type_squares{}; // indexed by [Piece_Type]
+
+        // Material summaries updated by Board::place_piece()
+        std::array<std::array<int, 6>, 2> piece_counts{}; // indexed by [Piece_Color][Piece_Type]
+        std::array<std::array<int, 2>, 2> bishop_square_counts{}; // indexed by [Piece_Color][Square_Color]
+        uint64_t material_signature = 0;
+        void update_material(Piece piece, Square square, int change) noexcept;
+
+        Bitboard::bitboard_t occupied_squares() const noexcept;
+        Bitboard::bitboard_t pieces(Piece_Color color, Piece_Type type) const noexcept;
+        Bitboard::bitboard_t attackers_of(Square target, Piece_Color attacking_color, Bitboard::bitboard_t occupied) const noexcept;
+        Bitboard::bitboard_t checking_pieces() const noexcept;
+        Bitboard::bitboard_t pinned_pieces() const noexcept;
+        Bitboard::bitboard_t find_checking_pieces() const noexcept;
+        Bitboard::bitboard_t find_pinned_pieces() const noexcept;
+        bool king_is_in_check_after_move(const Move& move, Bitboard::bitboard_t checkers, Bitboard::bitboard_t pinned) const noexcept;
 
         // Information cache for gene reference
         std::array<size_t, 2> castling_index{size_t(-1), size_t(-1)};
         std::array<int, 2> castling_movement{0, 0};
 
         // Caches
-        std::vector<const Move*> legal_moves_cache;
-        void recreate_move_caches() noexcept;
+        // The legal move list is only generated when it is asked for. Most positions
+        // reached during a search only need to know whether any legal move exists, or
+        // only need the first few moves from a Move_Generator.
+        mutable move_list legal_moves_cache;
+        mutable bool legal_moves_cache_is_stale = true;
+
+        // Found once per position for all legality checks
+        Bitboard::bitboard_t checking_pieces_cache = 0;
+        Bitboard::bitboard_t pinned_pieces_cache = 0;
+        void update_move_caches() noexcept;
+        void generate_legal_moves() const noexcept;
+        bool en_passant_is_possible() const noexcept;
+        bool unpinned_piece_can_move() const noexcept;
 
         Piece& piece_on_square(Square square) noexcept;
         void remove_piece(Square square) noexcept;
@@ -361,9 +474,9 @@ class Board
 
         // Track threefold repetition and fifty-move rule
         void add_board_position_to_repeat_record() noexcept;
-        void add_to_repeat_count(uint64_t new_hash) noexcept;
+        Position_History& history() const noexcept;
         ptrdiff_t current_board_position_repeat_count() const noexcept;
-        void clear_repeat_count() noexcept;
+        void reset_moves_since_pawn_or_capture() noexcept;
 
         // Zobrist hashing (implementation of threefold/fifty-move tracking)
         uint64_t current_board_hash = 0;
@@ -372,13 +485,16 @@ class Board
         uint64_t square_hash(Square square) const noexcept;
         void update_whose_turn_hash() noexcept;
 
-        bool king_multiply_checked() const noexcept;
-
-        // To implement side effects beyond moving and capturing pieces
+        // To check en passant targets when deciding move legality
         friend class Move;
 
+        // To generate moves directly from the piece bitboards
+        friend class Move_Generator;
+
         // Allow UCI_Mediator to change the legal moves with searchmoves command
         friend class UCI_Mediator;
 };
 
+static_assert(std::is_trivially_copyable_v<Board>);
+
 #endif // BOARD_H
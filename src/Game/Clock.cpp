@@ -4,11 +4,20 @@
 #include <chrono>
 using namespace std::chrono_literals;
 #include <limits>
+#include <algorithm>
 #include <sstream>
 #include <print>
 #include <format>
 #include <cmath>
 #include <ostream>
+#include <cstdint>
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <time.h>
+#elif defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#endif
 
 #include "Game/Board.h"
 #include "Game/Game_Result.h"
@@ -17,33 +26,57 @@ Clock::Clock(const seconds duration_seconds,
              const size_t moves_to_reset,
              const seconds increment_seconds,
              const Time_Reset_Method reset_method,
-             const std::chrono::system_clock::time_point previous_start_time) noexcept :
+             const std::chrono::system_clock::time_point previous_start_time,
+             const Time_Source time_source) noexcept :
     timers({duration_seconds, duration_seconds}),
     initial_start_time(duration_seconds),
     increment_time({increment_seconds, increment_seconds}),
     move_count_reset(moves_to_reset),
     method_of_reset(reset_method),
-    game_start_date_time(previous_start_time)
+    game_start_date_time(previous_start_time),
+    source_of_time(time_source)
+{
+}
+
+Clock Clock::node_budget(const size_t nodes_per_game,
+                         const size_t nodes_per_move,
+                         const std::chrono::system_clock::time_point previous_start_time) noexcept
 {
+    auto clock = Clock(0.0s, 0, 0.0s, Time_Reset_Method::ADDITION, previous_start_time);
+    clock.counts_nodes = true;
+    clock.game_node_budgets = {nodes_per_game, nodes_per_game};
+    clock.initial_node_budget = nodes_per_game;
+    clock.move_node_budget = nodes_per_move;
+    return clock;
 }
 
-Game_Result Clock::punch(const Board& board) noexcept
+Game_Result Clock::punch(const Board& board, const size_t nodes_searched) noexcept
 {
     if( ! is_running())
     {
         return {};
     }
 
-    const auto time_this_punch = std::chrono::steady_clock::now();
+    const auto time_this_punch = time_reading();
 
     const auto player_index = std::to_underlying(whose_turn);
-    timers[player_index] -= (time_this_punch - time_previous_punch);
+    const auto out_of_nodes = counts_nodes && nodes_searched > nodes_left(whose_turn);
+    if(counts_nodes)
+    {
+        // The allowance for the move is used up first.
+        const auto game_nodes_used = nodes_searched - std::min(nodes_searched, move_node_budget);
+        game_node_budgets[player_index] -= std::min(game_node_budgets[player_index], game_nodes_used);
+    }
+    else
+    {
+        timers[player_index] -= (time_this_punch - time_previous_punch);
+    }
     time_previous_punch = time_this_punch;
     whose_turn = opposite(whose_turn);
 
     auto punch_result = Game_Result{};
 
-    if(time_left(opposite(whose_turn)) < 0.0s)
+    if(out_of_nodes || time_left(opposite(whose_turn)) < 0.0s)
     {
         if(board.enough_material_to_checkmate(whose_turn))
         {
@@ -81,9 +114,9 @@ void Clock::unpunch() noexcept
 
 void Clock::stop() noexcept
 {
-    if(clocks_running)
+    if(clocks_running && ! counts_nodes)
     {
-        const auto time_stop = std::chrono::steady_clock::now();
+        const auto time_stop = time_reading();
         timers[std::to_underlying(whose_turn)] -= (time_stop - time_previous_punch);
         clocks_running = false;
     }
@@ -92,24 +125,23 @@ void Clock::stop() noexcept
 void Clock::start(const Piece_Color starting_turn) noexcept
 {
     whose_turn = starting_turn;
-    time_previous_punch = std::chrono::steady_clock::now();
+    time_previous_punch = time_reading();
     if(game_start_date_time == std::chrono::system_clock::time_point{})
     {
         game_start_date_time = std::chrono::system_clock::now();
     }
-    clocks_running = initial_start_time > 0s;
+    clocks_running = initial_start_time > 0s || counts_nodes;
 }
 
 Clock::seconds Clock::time_left(const Piece_Color color) const noexcept
 {
-    if(whose_turn != color || ! clocks_running)
+    if(whose_turn != color || ! clocks_running || counts_nodes)
     {
         return timers[std::to_underlying(color)];
     }
     else
     {
-        const auto now = std::chrono::steady_clock::now();
-        return timers[std::to_underlying(color)] - (now - time_previous_punch);
+        return timers[std::to_underlying(color)] - (time_reading() - time_previous_punch);
     }
 }
 
@@ -133,7 +165,7 @@ Piece_Color Clock::running_for() const noexcept
 void Clock::set_time(const Piece_Color player, const seconds new_time_seconds) noexcept
 {
     timers[std::to_underlying(player)] = new_time_seconds;
-    time_previous_punch = std::chrono::steady_clock::now();
+    time_previous_punch = time_reading();
 }
 
 void Clock::set_increment(const Piece_Color player, const seconds new_increment_time_seconds) noexcept
@@ -163,6 +195,35 @@ bool Clock::is_running() const noexcept
     return clocks_running;
 }
 
+Clock::seconds Clock::time_reading() const noexcept
+{
+    if(source_of_time == Time_Source::THREAD_CPU_TIME)
+    {
+#if defined(__linux__) || defined(__APPLE__)
+        timespec cpu_time;
+        if(clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu_time) == 0)
+        {
+            return std::chrono::seconds{cpu_time.tv_sec} + std::chrono::nanoseconds{cpu_time.tv_nsec};
+        }
+#elif defined(_WIN32)
+        FILETIME creation_time;
+        FILETIME exit_time;
+        FILETIME kernel_time;
+        FILETIME user_time;
+        if(GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time))
+        {
+            // FILETIMEs count 100-nanosecond intervals.
+            const auto to_ticks = [](const FILETIME& time) { return (uint64_t{time.dwHighDateTime} << 32) | time.dwLowDateTime; };
+            using file_time_ticks = std::chrono::duration<uint64_t, std::ratio<1, 10'000'000>>;
+            return file_time_ticks{to_ticks(kernel_time) + to_ticks(user_time)};
+        }
+#endif
+    }
+
+    // Wall time is also used on platforms without processor times for threads.
+    return std::chrono::steady_clock::now().time_since_epoch();
+}
+
 std::chrono::system_clock::time_point Clock::game_start_date_and_time() const noexcept
 {
     return game_start_date_time;
@@ -188,10 +249,45 @@ Clock::seconds Clock::increment(const Piece_Color color) const noexcept
     return increment_time[std::to_underlying(color)];
 }
 
+bool Clock::limits_nodes() const noexcept
+{
+    return counts_nodes;
+}
+
+size_t Clock::nodes_left(const Piece_Color color) const noexcept
+{
+    return game_nodes_left(color) + nodes_per_move();
+}
+
+size_t Clock::game_nodes_left(const Piece_Color color) const noexcept
+{
+    return game_node_budgets[std::to_underlying(color)];
+}
+
+size_t Clock::nodes_per_move() const noexcept
+{
+    return move_node_budget;
+}
+
 std::string Clock::time_control_string() const noexcept
 {
     std::ostringstream time_control_spec;
 
+    if(limits_nodes())
+    {
+        if(initial_node_budget > 0)
+        {
+            std::print(time_control_spec, "{} nodes", initial_node_budget);
+        }
+
+        if(nodes_per_move() > 0)
+        {
+            std::print(time_control_spec, "{}{} nodes/move", initial_node_budget > 0 ? "+" : "", nodes_per_move());
+        }
+
+        return time_control_spec.str();
+    }
+
     if(moves_per_time_period() > 0)
     {
         std::print(time_control_spec, "{}/", moves_per_time_period());
@@ -213,6 +309,11 @@ std::string Clock::time_control_string() const noexcept
 
 bool Clock::time_expired(Piece_Color color) const noexcept
 {
+    if(limits_nodes())
+    {
+        return nodes_left(color) == 0;
+    }
+
     return time_left(color) <= Clock::seconds{0};
 }
 
@@ -223,6 +324,11 @@ bool Clock::running_time_expired() const noexcept
 
 std::string Clock::time_left_display(Piece_Color color) const noexcept
 {
+    if(limits_nodes())
+    {
+        return std::format("{} nodes", nodes_left(color));
+    }
+
     const auto time = time_left(color);
     const auto hrs = std::chrono::duration_cast<std::chrono::hours>(time).count();
     const auto mins = std::chrono::duration_cast<std::chrono::minutes>(time).count() % 60;
@@ -21,6 +21,20 @@ enum class Time_Reset_Method
     SET_TO_ORIGINAL
 };
 
+//! \brief Specifies how a Clock measures the time a player spends thinking.
+enum class Time_Source
+{
+    //! \brief Time passes whether or not the player's thread is running.
+    WALL_TIME,
+
+    //! \brief Only the processor time used by the thread that punches the clock is counted.
+    //!
+    //! A player whose thread is waiting for a processor does not lose time. The clock must
+    //! be started, punched, and read on the thread that chooses the moves, and only the time
+    //! used by that thread is counted.
+    THREAD_CPU_TIME
+};
+
 //! \brief This class represents the dual-clock game timers used in tournament chess.
 class Clock
 {
@@ -43,14 +57,34 @@ class Clock
         //! \param previous_start_time If the clock for a game is being replaced by another clock (for example, a GUI
         //!        changes time control midgame), then this parameter can be used to preserve the actual start of the
         //!        current game.
+        //! \param time_source Whether the clock measures wall time or the processor time of the thread playing the game.
         explicit Clock(seconds duration_seconds = 0.0s,
                        size_t moves_to_reset = 0,
                        seconds increment_seconds = 0.0s,
                        Time_Reset_Method reset_method = Time_Reset_Method::ADDITION,
-                       std::chrono::system_clock::time_point previous_start_time = {}) noexcept;
+                       std::chrono::system_clock::time_point previous_start_time = {},
+                       Time_Source time_source = Time_Source::WALL_TIME) noexcept;
+
+        //! \brief Constructs a game clock that limits how many positions each player may search instead of how long they may think.
+        //!
+        //! Unlike time, the number of positions searched does not depend on the speed of the
+        //! computer or on other programs running at the same time. The clock does not measure
+        //! time, so the time_left() of both players is always zero.
+        //! \param nodes_per_game The number of positions each player may search during the whole game.
+        //! \param nodes_per_move The number of positions each player may search for every move
+        //!        in addition to the game budget. Positions from this allowance that are not
+        //!        searched are not carried over to later moves.
+        //! \param previous_start_time The actual start of the current game if this clock replaces another one.
+        static Clock node_budget(size_t nodes_per_game,
+                                 size_t nodes_per_move,
+                                 std::chrono::system_clock::time_point previous_start_time = {}) noexcept;
 
         //! \brief Stop the current player's clock and restart the opponent's clock.
-        Game_Result punch(const Board& board) noexcept;
+        //!
+        //! \param board The board position after the player's move has been chosen but not played.
+        //! \param nodes_searched The number of positions the player searched to choose the move.
+        //!        This is only counted by a node_budget() clock.
+        Game_Result punch(const Board& board, size_t nodes_searched = 0) noexcept;
 
         //! \brief Undo the last clock punch (time is not added).
         void unpunch() noexcept;
@@ -84,6 +118,12 @@ class Clock
         //! \brief Are clocks currently running?
         bool is_running() const noexcept;
 
+        //! \brief The current reading of the time source that this clock uses.
+        //!
+        //! Only the difference between two readings is meaningful. It is the time that this
+        //! clock would count between them. See Time_Source.
+        seconds time_reading() const noexcept;
+
         //! \brief Returns the date and time when start() was called.
         std::chrono::system_clock::time_point game_start_date_and_time() const noexcept;
 
@@ -102,8 +142,26 @@ class Clock
         //! \brief Returns a string representing the time control of the game
         std::string time_control_string() const noexcept;
 
+        //! \brief Whether this clock limits the number of positions searched instead of time (see node_budget()).
+        bool limits_nodes() const noexcept;
+
+        //! \brief The number of positions the given player may search for the next move.
+        //!
+        //! This is the rest of the game budget plus the allowance for each move.
+        //! \param color The color of the player being queried.
+        size_t nodes_left(Piece_Color color) const noexcept;
+
+        //! \brief The rest of the given player's budget for the whole game.
+        //!
+        //! \param color The color of the player being queried.
+        size_t game_nodes_left(Piece_Color color) const noexcept;
+
+        //! \brief The number of positions each player may search for every move in addition to the game budget.
+        size_t nodes_per_move() const noexcept;
+
         //! \brief Returns whether the clock's time has expired for the given player.
-        //! 
+        //!
+        //! For a node_budget() clock, this is whether the player may not search any more positions.
         //! \param color The player whose clock is being queried.
         bool time_expired(Piece_Color color) const noexcept;
 
@@ -111,6 +169,8 @@ class Clock
         bool running_time_expired() const noexcept;
 
         //! \brief Returns a text version of the time left on the clock formatted into hours : minutes : seconds.
+        //!
+        //! A node_budget() clock shows the number of positions the player may search instead.
         std::string time_left_display(Piece_Color color) const noexcept;
 
     private:
@@ -122,11 +182,17 @@ class Clock
         size_t move_count_reset;
         Time_Reset_Method method_of_reset;
 
+        bool counts_nodes = false;
+        std::array<size_t, 2> game_node_budgets{0, 0};
+        size_t initial_node_budget = 0;
+        size_t move_node_budget = 0;
+
         Piece_Color whose_turn = Piece_Color::WHITE;
         bool clocks_running = false;
 
         std::chrono::system_clock::time_point game_start_date_time;
-        std::chrono::steady_clock::time_point time_previous_punch;
+        Time_Source source_of_time;
+        seconds time_previous_punch;
 
         friend class Xboard_Mediator;
         friend class UCI_Mediator;
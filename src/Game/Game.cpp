@@ -7,6 +7,7 @@
 #include <print>
 #include <memory>
 #include <format>
+#include <optional>
 
 #include "Players/Player.h"
 #include "Players/Genetic_AI.h"
@@ -20,6 +21,7 @@
 #include "Game/Game_Result.h"
 #include "Game/Move.h"
 #include "Game/PGN.h"
+#include "Game/Position_History.h"
 
 #include "Utility/String.h"
 #include "Utility/Main_Tools.h"
@@ -28,9 +30,21 @@ std::vector<std::unique_ptr<Player>> get_players(Main_Tools::command_line_option
 {
     Main_Tools::command_line_options remaining_options;
     std::vector<std::unique_ptr<Player>> players;
+    std::optional<size_t> transposition_table_size;
+    std::optional<size_t> search_thread_count;
     for(const auto& [opt, values] : options)
     {
-        if(opt == "-random")
+        if(opt == "-hash")
+        {
+            Main_Tools::argument_assert( ! values.empty(), "{} requires a numeric argument.", opt);
+            transposition_table_size = String::to_number<size_t>(values[0]);
+        }
+        else if(opt == "-threads")
+        {
+            Main_Tools::argument_assert( ! values.empty(), "{} requires a numeric argument.", opt);
+            search_thread_count = String::to_number<size_t>(values[0]);
+        }
+        else if(opt == "-random")
         {
             players.push_back(std::make_unique<Random_AI>());
         }
@@ -38,6 +52,7 @@ std::vector<std::unique_ptr<Player>> get_players(Main_Tools::command_line_option
         {
             Main_Tools::argument_assert( ! values.empty(), "Genome file needed for player");
             std::string file_name = values[0];
+            Genetic_AI::use_calibration_cache_file(std::format("{}_calibration.txt", file_name));
             if(values.size() > 1)
             {
                 try
@@ -61,6 +76,22 @@ std::vector<std::unique_ptr<Player>> get_players(Main_Tools::command_line_option
         }
     }
 
+    if(transposition_table_size)
+    {
+        for(const auto& player : players)
+        {
+            player->set_transposition_table_size(*transposition_table_size);
+        }
+    }
+
+    if(search_thread_count)
+    {
+        for(const auto& player : players)
+        {
+            player->set_search_thread_count(*search_thread_count);
+        }
+    }
+
     options = remaining_options;
     return players;
 }
@@ -110,6 +141,10 @@ Game_Result play_game(Board board,
     std::vector<const Move*> game_record;
     Game_Result result;
 
+    // Games may be played simultaneously on different threads.
+    Position_History game_history;
+    board.use_position_history(game_history);
+
     if(print_board)
     {
         board.cli_print_game(white, black, game_clock);
@@ -127,7 +162,7 @@ Game_Result play_game(Board board,
             std::println("\n{} chose {}", player.name(), move_chosen.algebraic(board));
         }
 
-        result = game_clock.punch(board);
+        result = game_clock.punch(board, player.nodes_searched_for_last_move());
         if( ! result.game_has_ended())
         {
             result = board.play_move(move_chosen);
@@ -163,6 +198,7 @@ void play_game_with_outsider(const Player& player,
     signal(SIGINT, SIG_IGN);
 
     Board board;
+    outsider->record_game_positions(board);
     Clock clock;
     Game_Result game_result;
     std::vector<const Move*> game_record;
@@ -191,7 +227,7 @@ void play_game_with_outsider(const Player& player,
             const auto& chosen_move = player.choose_move(board, clock);
             clock.punch(board);
 
-            game_result = outsider->handle_move(board, chosen_move, game_record);
+            game_result = outsider->handle_move(board, chosen_move, game_record, player);
         } while( ! game_result.game_has_ended());
 
         outsider->log("Game ended with: {}", game_result.ending_reason());
@@ -58,7 +58,8 @@ void start_game(Main_Tools::command_line_options options);
 //! \param options A parsed list of command line options and their values.
 //! \returns A list of pointers to players so that mixed types can be accomodated (i.e., Genetic AI and Random).
 //! 
-//! The input options are modified by removing all player specifications.
+//! The input options are modified by removing all player specifications, including
+//! settings that apply to every player (e.g., -hash and -threads).
 std::vector<std::unique_ptr<Player>> get_players(Main_Tools::command_line_options& options);
 
 //! \brief Create a game clock from the command line options.
@@ -3,67 +3,36 @@
 #include <cassert>
 #include <cctype>
 #include <string>
+#include <array>
+#include <utility>
 
 #include "Game/Board.h"
 #include "Game/Square.h"
 #include "Game/Game_Result.h"
 #include "Game/Piece.h"
+#include "Game/Position_History.h"
 
 #include "Utility/String.h"
 
+// All moves are created during compilation, indexed by the high and low bytes of their codes.
+constinit const std::array<std::array<Move, 256>, 256> Move::all_moves =
+    []<Move::code_t... high_byte>(std::integer_sequence<Move::code_t, high_byte...>)
+    {
+        const auto moves_with_high_byte =
+            []<Move::code_t... low_byte>(const Move::code_t high, std::integer_sequence<Move::code_t, low_byte...>)
+            {
+                return std::array<Move, 256>{Move(Move::code_t((high << 8) | low_byte))...};
+            };
 
-Move::Move(const Square start, const Square end) noexcept : origin(start), destination(end)
-{
-    assert(start.inside_board());
-    assert(end.inside_board());
-    assert(start != end);
-}
-
-Move Move::pawn_move(Square start, Piece_Color pawn_color, Piece promote) noexcept
-{
-    const auto end = start + Square_Difference{0, pawn_color == Piece_Color::WHITE ? 1 : -1};
-    auto move = Move(start, end);
-    move.set_capturing_ability(false);
-    move.setup_pawn_promotion(pawn_color, promote);
-    move.setup_pawn_rules();
-    return move;
-}
-
-Move Move::pawn_capture(Square start, Direction direction, Piece_Color pawn_color, Piece promote) noexcept
-{
-    const auto end = start + Square_Difference{direction == Direction::LEFT ? -1 : 1, pawn_color == Piece_Color::WHITE ? 1 : -1 };
-    auto move = Move(start, end);
-    move.set_capturing_ability(true);
-    move.setup_pawn_promotion(pawn_color, promote);
-    move.setup_pawn_rules();
-    return move;
-}
-
-Move Move::pawn_double_move(Piece_Color pawn_color, char file) noexcept
-{
-    const auto start = Square{file, pawn_color == Piece_Color::WHITE ? 2 : 7};
-    const auto end = start + Square_Difference{0, pawn_color == Piece_Color::WHITE ? 2 : -2};
-    auto move = Move(start, end);
-    move.set_capturing_ability(false);
-    move.setup_pawn_rules();
-    return move;
-}
-
-Move Move::castle(Piece_Color king_color, Direction direction) noexcept
-{
-    const auto start = Square{'e', king_color == Piece_Color::WHITE ? 1 : 8};
-    const auto end = start + Square_Difference{direction == Direction::LEFT ? -2 : 2, 0};
-    auto move = Move(start, end);
-    move.setup_castling_rules(direction);
-    return move;
-}
+        return std::array<std::array<Move, 256>, 256>{moves_with_high_byte(high_byte, std::make_integer_sequence<Move::code_t, 256>{})...};
+    }(std::make_integer_sequence<Move::code_t, 256>{});
 
-void Move::side_effects(Board& board) const noexcept
+bool Move::is_legal(const Board& board) const noexcept
 {
-    side_effect(board);
+    return is_pseudo_legal(board) && ! board.king_is_in_check_after_move(*this);
 }
 
-bool Move::is_legal(const Board& board) const noexcept
+bool Move::is_pseudo_legal(const Board& board) const noexcept
 {
     assert(board.piece_on_square(start()));
     assert(board.piece_on_square(start()).color() == board.whose_turn());
@@ -77,32 +46,37 @@ bool Move::is_legal(const Board& board) const noexcept
         }
     }
 
-    return move_specific_legal(board) && ! board.king_is_in_check_after_move(*this);
+    return move_specific_legal(board);
 }
 
 bool Move::move_specific_legal(const Board& board) const noexcept
 {
-    return extra_rule(board);
-}
-
-bool Move::can_capture() const noexcept
-{
-    return able_to_capture;
-}
+    switch(flag())
+    {
+        case Flag::PAWN_CAPTURE:
+            return bool(board.piece_on_square(end()));
 
-Square Move::start() const noexcept
-{
-    return origin;
-}
+        case Flag::EN_PASSANT:
+            return board.en_passant_target == end();
 
-Square Move::end() const noexcept
-{
-    return destination;
-}
+        case Flag::CASTLE:
+        {
+            const auto direction = file_change() < 0 ? Direction::LEFT : Direction::RIGHT;
+            const auto king_crossing_square = start() + Square_Difference{direction == Direction::LEFT ? -1 : 1, 0};
+            const auto last_empty_square = end() + Square_Difference{-1, 0};
+            return board.castle_is_legal(board.whose_turn(), direction)
+                && ! board.king_is_in_check()
+                && board.safe_for_king(king_crossing_square, board.whose_turn())
+                && ! (direction == Direction::LEFT && board.piece_on_square(last_empty_square));
+        }
 
-Square_Difference Move::movement() const noexcept
-{
-    return end() - start();
+        default:
+            if(flag() >= Flag::CAPTURING_PROMOTION)
+            {
+                return bool(board.piece_on_square(end()));
+            }
+            return true;
+    }
 }
 
 int Move::file_change() const noexcept
@@ -163,6 +137,9 @@ std::string Move::algebraic_base(const Board& board) const noexcept
 
 std::string Move::result_mark(Board board) const noexcept
 {
+    // A separate history lets boards without one be annotated.
+    Position_History history;
+    board.use_position_history(history);
     const auto result = board.play_move(*this);
     if(board.king_is_in_check())
     {
@@ -181,61 +158,6 @@ std::string Move::result_mark(Board board) const noexcept
     }
 }
 
-void Move::setup_pawn_promotion([[maybe_unused]] Piece_Color pawn_color, Piece promote) noexcept
-{
-    assert( ! promote || start().rank() == (pawn_color == Piece_Color::WHITE ? 7 : 2));
-    assert( ! promote || pawn_color == promote.color());
-    pawn_promotion = promote;
-}
-
-void Move::setup_pawn_rules() noexcept
-{
-    const auto to_square = end();
-    const auto capturing = can_capture();
-    extra_rule = [=](const Board& board)
-        {
-            return (bool(board.piece_on_square(to_square)) == capturing) || board.en_passant_target == to_square;
-        };
-
-    if(std::abs(rank_change()) == 2)
-    {
-        const auto pawn_skipped_square = start() + Square_Difference{0, rank_change()/2};
-        side_effect = [=](Board& board) { board.make_en_passant_targetable(pawn_skipped_square); };
-    }
-    else if(promotion())
-    {
-        const auto promotion_piece = promotion();
-        const auto promotion_place = end();
-        side_effect = [=](Board& board) { board.place_piece(promotion_piece, promotion_place); };
-    }
-}
-
-void Move::setup_castling_rules(const Direction direction) noexcept
-{
-    set_capturing_ability(false);
-    is_castling = true;
-
-    const auto king_crossing_square = start() + Square_Difference{direction == Direction::LEFT ? -1 : 1, 0};
-    const auto last_empty_square = direction == Direction::LEFT ? end() + Square_Difference{-1, 0} : Square{};
-    extra_rule = [=](const Board& board)
-                 {
-                     return board.castle_is_legal(board.whose_turn(), direction)
-                         && ! board.king_is_in_check()
-                         && board.safe_for_king(king_crossing_square, board.whose_turn())
-                         && ! (last_empty_square.inside_board() && board.piece_on_square(last_empty_square));
-                 };
-
-    const auto rook_move_start = Square{direction == Direction::LEFT ? 'a' : 'h', start().rank()};
-    const auto rook_move_end = Square{direction == Direction::LEFT ? 'd' : 'f', start().rank()};
-    const auto file_move = file_change();
-    side_effect = [=](Board& board)
-                  {
-                      board.move_piece({rook_move_start, rook_move_end});
-                      board.castling_index[static_cast<int>(board.whose_turn())] = board.played_ply_count() - 1;
-                      board.castling_movement[static_cast<int>(board.whose_turn())] = file_move;
-                  };
-}
-
 std::string Move::coordinates() const noexcept
 {
     const auto result = start().text() + end().text();
@@ -249,19 +171,19 @@ std::string Move::coordinates() const noexcept
     }
 }
 
-bool Move::is_en_passant(const Board& board) const noexcept
+bool Move::is_en_passant() const noexcept
 {
-    return board.piece_on_square(start()).type() == Piece_Type::PAWN && board.en_passant_target == end();
+    return flag() == Flag::EN_PASSANT;
 }
 
 bool Move::is_castle() const noexcept
 {
-    return is_castling;
+    return flag() == Flag::CASTLE;
 }
 
-Piece Move::promotion() const noexcept
+bool Move::is_pawn_double_move() const noexcept
 {
-    return pawn_promotion;
+    return flag() == Flag::PAWN_DOUBLE_MOVE;
 }
 
 char Move::promotion_piece_symbol() const noexcept
@@ -312,8 +234,3 @@ Square_Difference Move::attack_direction_from_index(const size_t index) noexcept
     static constexpr int dy[] = { 1,  1,  1,  0,  0, -1, -1, -1,  2,  1, -1, -2, -2, -1,  1,  2};
     return {dx[index], dy[index]};
 }
-
-void Move::set_capturing_ability(const bool capturing_ability) noexcept
-{
-    able_to_capture = capturing_ability;
-}
@@ -2,7 +2,10 @@
 #define MOVE_H
 
 #include <string>
-#include <functional>
+#include <cstdint>
+#include <array>
+#include <cassert>
+#include <utility>
 
 #include "Game/Square.h"
 #include "Game/Piece.h"
@@ -16,14 +19,31 @@ class Board;
 class Piece;
 
 //! \brief A class to represent the movement of pieces.
+//!
+//! A move is stored in 16 bits: 6 bits for the starting square index, 6 bits for the ending
+//! square index, and 4 bits for a flag that identifies special moves (pawn moves, castling,
+//! en passant, and promotions). Every possible move has a single shared instance that can be
+//! retrieved with Move::from_code(), so pointers to moves can be compared for identity.
 class Move
 {
     public:
+        //! \brief The type of the packed move representation.
+        using code_t = uint16_t;
+
         //! \brief Constructs a move with no special rules.
         //!
         //! \param start The Square where move starts.
         //! \param end   The Square where move ends.
-        Move(Square start, Square end) noexcept;
+        constexpr Move(Square start, Square end) noexcept;
+
+        //! \brief Get the shared instance of the move with the given code.
+        //!
+        //! \param code A value returned by Move::code().
+        //! \returns A reference to a move that lives for the duration of the program.
+        static constexpr const Move& from_code(code_t code) noexcept;
+
+        //! \brief The packed 16-bit representation of this move.
+        constexpr code_t code() const noexcept;
 
         //! \brief Construct a non-capturing pawn move.
         //! 
@@ -32,7 +52,7 @@ class Move
         //! \param promote What piece to promote the pawn to if it reaches the back ranks. This may be an invalid piece if no promotion is intended.
         //! 
         //! \returns A move instance with proper pawn rules in place.
-        static Move pawn_move(Square start, Piece_Color pawn_color, Piece promote) noexcept;
+        static constexpr Move pawn_move(Square start, Piece_Color pawn_color, Piece promote) noexcept;
 
         //! \brief Construct a capturing pawn move.
         //! 
@@ -42,7 +62,7 @@ class Move
         //! \param promote What piece to promote the pawn to if it reaches the back ranks. This may be an invalid piece if no promotion is intended.
         //! 
         //! \returns A move instance with proper pawn rules in place.
-        static Move pawn_capture(Square start, Direction direction, Piece_Color pawn_color, Piece promote) noexcept;
+        static constexpr Move pawn_capture(Square start, Direction direction, Piece_Color pawn_color, Piece promote) noexcept;
 
         //! \brief Construct a pawn double move.
         //! 
@@ -50,15 +70,24 @@ class Move
         //! \param file Which file the pawn starts on.
         //! 
         //! \returns A move instance with proper pawn rules in place.
-        static Move pawn_double_move(Piece_Color pawn_color, char file) noexcept;
+        static constexpr Move pawn_double_move(Piece_Color pawn_color, char file) noexcept;
+
+        //! \brief Construct an en passant capture.
+        //!
+        //! \param pawn_color The color of the capturing pawn.
+        //! \param file Which file the capturing pawn starts on.
+        //! \param direction Whether the pawn captures to the left or right (from white's perspective).
+        //!
+        //! \returns A move instance with proper pawn rules in place.
+        static constexpr Move en_passant(Piece_Color pawn_color, char file, Direction direction) noexcept;
 
         //! \brief Construct castling move.
         //! 
         //! \param king_color The color of the castling king.
         //! \param direction To which side the castling goes: Direction::LEFT for queenside and Direction::RIGHT for kingside.
         //! 
-        //! \returns A move instance with proper pawn rules in place.
-        static Move castle(Piece_Color king_color, Direction direction) noexcept;
+        //! \returns A move instance with proper castling rules in place.
+        static constexpr Move castle(Piece_Color king_color, Direction direction) noexcept;
 
         //! \brief Since there's only one instance of every Move, assignment can only lose information.
         Move& operator=(const Move&) = delete;
@@ -66,42 +95,39 @@ class Move
         //! \brief Copy constructor so the functions that create the special moves can return a value.
         Move(const Move& other) noexcept = default;
 
-        //! \brief Further modifies the state of the board.
-        //!
-        //! Side effects are changes to the state of the board beyond the change
-        //! in position of the moved piece and captured piece (movement by rook
-        //! in castling, marking a square as a en passant target after a double
-        //! pawn move, etc.).
-        //!
-        //! The default move has no side effects.
-        //! \param board The board upon which the side effects are applied.
-        void side_effects(Board& board) const noexcept;
-
         //! \brief Checks if a move is legal on a given Board.
         //!
         //! This method checks for attacking a piece of the same color,
         //! attacking a piece when the move cannot capture, special rules,
         //! and whether the king is in check after the move. It does not
-        //! check if there are intervening pieces (see Board::recreate_move_cache()).
+        //! check if there are intervening pieces. Move_Generator does that
+        //! when it generates moves and when it checks a hash move.
         //! \param board The board on which the Move's legality is tested.
         bool is_legal(const Board& board) const noexcept;
 
+        //! \brief Checks if a move is legal on a given Board without considering the safety of the king.
+        //!
+        //! This method performs all of the checks of Move::is_legal() except for whether the king
+        //! is in check after the move.
+        //! \param board The board on which the Move's legality is tested.
+        bool is_pseudo_legal(const Board& board) const noexcept;
+
         //! \brief Check whether this move can land on an opponent-occupied square.
         //!
         //! \returns Whether this move is allowed to capture.
-        bool can_capture() const noexcept;
+        constexpr bool can_capture() const noexcept;
 
         //! \brief The Square the Move originates from.
-        Square start() const noexcept;
+        constexpr Square start() const noexcept;
 
         //! \brief The Square the Move ends on.
-        Square end() const noexcept;
+        constexpr Square end() const noexcept;
 
         //! \brief The total movement of a move.
         //!
         //! \returns A value indicating the two-dimensional movement.
         //!          Equivalent to Square_Difference(file_change(), rank_change()).
-        Square_Difference movement() const noexcept;
+        constexpr Square_Difference movement() const noexcept;
 
         //! \brief Creates a textual representation of a move suitable for a PGN game record.
         //!
@@ -117,15 +143,16 @@ class Move
         std::string coordinates() const noexcept;
 
         //! \brief Indicates whether this move is en passant, which needs special handling elsewhere.
-        //!
-        //! \returns Whether this is an instance of the En_Passant class.
-        bool is_en_passant(const Board& board) const noexcept;
+        bool is_en_passant() const noexcept;
 
         //! \brief Indicates whether the move is a castling move.
         bool is_castle() const noexcept;
 
+        //! \brief Indicates whether the move is a pawn moving two squares forward.
+        bool is_pawn_double_move() const noexcept;
+
         //! \brief Returns the piece that a pawn will be promoted to, if applicable.
-        Piece promotion() const noexcept;
+        constexpr Piece promotion() const noexcept;
 
         //! \brief Returns the symbol representing the promoted piece if this move is a pawn promotion type. All other moves return '\\0'.
         //!
@@ -151,10 +178,36 @@ class Move
         static Square_Difference attack_direction_from_index(size_t index) noexcept;
 
     private:
-        //! \brief Change the ability of this Move to capture.
+        //! \brief Identifies the kind of special move, if any.
         //!
-        //! \param capturing_ability Whether this move should be able to capture.
-        void set_capturing_ability(bool capturing_ability) noexcept;
+        //! The promotion flags occupy the values 8-15. The lowest two bits give the
+        //! promoted piece and the next bit indicates whether the move captures.
+        enum class Flag : code_t
+        {
+            NORMAL,
+            PAWN_MOVE,
+            PAWN_DOUBLE_MOVE,
+            PAWN_CAPTURE,
+            EN_PASSANT,
+            CASTLE,
+            PROMOTION = 8,
+            CAPTURING_PROMOTION = 12
+        };
+
+        //! \brief Construct a move from its parts.
+        //!
+        //! \param start The Square where move starts.
+        //! \param end   The Square where move ends.
+        //! \param flag  The kind of move.
+        constexpr Move(Square start, Square end, Flag flag) noexcept;
+
+        //! \brief Construct a move from its packed representation.
+        constexpr explicit Move(code_t code) noexcept : move_code(code)
+        {
+        }
+
+        //! \brief The kind of move.
+        constexpr Flag flag() const noexcept;
 
         //! \brief A textual representation of a move in PGN format without consequences ('+' for check, etc.).
         //!
@@ -172,22 +225,135 @@ class Move
         //! \returns The distance in squares between the start and end ranks.
         int rank_change() const noexcept;
 
-        Square origin;
-        Square destination;
+        static constexpr code_t square_bits = 6;
+        static constexpr code_t square_mask = (1 << square_bits) - 1;
+        static constexpr code_t end_shift = square_bits;
+        static constexpr code_t flag_shift = 2*square_bits;
 
-        bool able_to_capture = true;
-        bool is_castling = false;
+        //! \brief Every possible move, indexed by the high and low bytes of its code.
+        static const std::array<std::array<Move, 256>, 256> all_moves;
 
-        std::function<bool(const Board&)> extra_rule = [](const Board&) { return true; };
-        std::function<void(Board&)> side_effect = [](const Board&) {};
-
-        Piece pawn_promotion;
+        code_t move_code;
 
         bool move_specific_legal(const Board& board) const noexcept;
         std::string result_mark(Board board) const noexcept;
-        void setup_pawn_promotion(Piece_Color pawn_color, Piece promote) noexcept;
-        void setup_pawn_rules() noexcept;
-        void setup_castling_rules(Direction direction) noexcept;
+        static constexpr Flag promotion_flag(Piece promote, bool capturing) noexcept;
 };
 
+static_assert(sizeof(Move) == sizeof(Move::code_t));
+
+// Definitions of the functions that are used to build the move tables during compilation.
+
+constexpr Move::Move(const Square start, const Square end) noexcept : Move(start, end, Flag::NORMAL)
+{
+}
+
+constexpr Move::Move(const Square start, const Square end, const Flag flag) noexcept :
+    move_code(code_t(start.index() | (end.index() << end_shift) | (std::to_underlying(flag) << flag_shift)))
+{
+    assert(start.inside_board());
+    assert(end.inside_board());
+    assert(start != end);
+}
+
+constexpr const Move& Move::from_code(const code_t code) noexcept
+{
+    return all_moves[code >> 8][code & 0xFF];
+}
+
+constexpr Move::code_t Move::code() const noexcept
+{
+    return move_code;
+}
+
+constexpr Move::Flag Move::flag() const noexcept
+{
+    return static_cast<Flag>(move_code >> flag_shift);
+}
+
+constexpr Move::Flag Move::promotion_flag(const Piece promote, const bool capturing) noexcept
+{
+    if( ! promote)
+    {
+        return capturing ? Flag::PAWN_CAPTURE : Flag::PAWN_MOVE;
+    }
+
+    assert(promote.type() != Piece_Type::PAWN && promote.type() != Piece_Type::KING);
+    const auto base = capturing ? Flag::CAPTURING_PROMOTION : Flag::PROMOTION;
+    return static_cast<Flag>(std::to_underlying(base) + std::to_underlying(promote.type()) - std::to_underlying(Piece_Type::ROOK));
+}
+
+constexpr Move Move::pawn_move(Square start, Piece_Color pawn_color, Piece promote) noexcept
+{
+    assert( ! promote || start.rank() == (pawn_color == Piece_Color::WHITE ? 7 : 2));
+    assert( ! promote || pawn_color == promote.color());
+    const auto end = start + Square_Difference{0, pawn_color == Piece_Color::WHITE ? 1 : -1};
+    return Move(start, end, promotion_flag(promote, false));
+}
+
+constexpr Move Move::pawn_capture(Square start, Direction direction, Piece_Color pawn_color, Piece promote) noexcept
+{
+    assert( ! promote || start.rank() == (pawn_color == Piece_Color::WHITE ? 7 : 2));
+    assert( ! promote || pawn_color == promote.color());
+    const auto end = start + Square_Difference{direction == Direction::LEFT ? -1 : 1, pawn_color == Piece_Color::WHITE ? 1 : -1 };
+    return Move(start, end, promotion_flag(promote, true));
+}
+
+constexpr Move Move::pawn_double_move(Piece_Color pawn_color, char file) noexcept
+{
+    const auto start = Square{file, pawn_color == Piece_Color::WHITE ? 2 : 7};
+    const auto end = start + Square_Difference{0, pawn_color == Piece_Color::WHITE ? 2 : -2};
+    return Move(start, end, Flag::PAWN_DOUBLE_MOVE);
+}
+
+constexpr Move Move::en_passant(Piece_Color pawn_color, char file, Direction direction) noexcept
+{
+    const auto start = Square{file, pawn_color == Piece_Color::WHITE ? 5 : 4};
+    const auto end = start + Square_Difference{direction == Direction::LEFT ? -1 : 1, pawn_color == Piece_Color::WHITE ? 1 : -1 };
+    return Move(start, end, Flag::EN_PASSANT);
+}
+
+constexpr Move Move::castle(Piece_Color king_color, Direction direction) noexcept
+{
+    const auto start = Square{'e', king_color == Piece_Color::WHITE ? 1 : 8};
+    const auto end = start + Square_Difference{direction == Direction::LEFT ? -2 : 2, 0};
+    return Move(start, end, Flag::CASTLE);
+}
+
+constexpr bool Move::can_capture() const noexcept
+{
+    const auto move_flag = flag();
+    return move_flag == Flag::NORMAL
+        || move_flag == Flag::PAWN_CAPTURE
+        || move_flag == Flag::EN_PASSANT
+        || move_flag >= Flag::CAPTURING_PROMOTION;
+}
+
+constexpr Square Move::start() const noexcept
+{
+    return Square::from_index(move_code & square_mask);
+}
+
+constexpr Square Move::end() const noexcept
+{
+    return Square::from_index((move_code >> end_shift) & square_mask);
+}
+
+constexpr Square_Difference Move::movement() const noexcept
+{
+    return end() - start();
+}
+
+constexpr Piece Move::promotion() const noexcept
+{
+    const auto move_flag = std::to_underlying(flag());
+    if(move_flag < std::to_underlying(Flag::PROMOTION))
+    {
+        return {};
+    }
+
+    const auto type = static_cast<Piece_Type>((move_flag & 3) + std::to_underlying(Piece_Type::ROOK));
+    return {end().rank() == 8 ? Piece_Color::WHITE : Piece_Color::BLACK, type};
+}
+
 #endif // MOVE_H
@@ -0,0 +1,387 @@
+#include "Game/Move_Generator.h"
+
+#include <cassert>
+#include <utility>
+
+#include "Game/Board.h"
+#include "Game/Move.h"
+#include "Game/Piece.h"
+#include "Game/Square.h"
+#include "Game/Color.h"
+#include "Game/Bitboard.h"
+
+namespace
+{
+    //! \brief Move every square in a bitboard by the same amount.
+    //!
+    //! Squares that leave the board past the a- or h-file are dropped, but squares
+    //! that move past the first or eighth rank wrap onto a neighboring file. So, this
+    //! is only valid for squares that cannot cross those ranks, such as pawns.
+    Bitboard::bitboard_t shift(const Bitboard::bitboard_t squares, const Square_Difference step) noexcept
+    {
+        // Square indices are file-major, so moving one file moves eight bits and moving one rank moves one bit.
+        const auto offset = 8*step.file_change + step.rank_change;
+        return offset > 0 ? squares << offset : squares >> -offset;
+    }
+
+    const Bitboard::bitboard_t first_rank_squares = 0x0101010101010101;
+
+    Bitboard::bitboard_t first_rank(const Piece_Color color) noexcept
+    {
+        return color == Piece_Color::WHITE ? first_rank_squares : first_rank_squares << 7;
+    }
+
+    Bitboard::bitboard_t last_rank(const Piece_Color color) noexcept
+    {
+        return first_rank(opposite(color));
+    }
+}
+
+Move_Generator::Move_Generator(const Board& board_in, const Move* const hash_move, const bool material_changing_moves_only) noexcept :
+    board(board_in),
+    first_move(hash_move),
+    captures_only(material_changing_moves_only),
+    king_square(board.find_king(board.whose_turn())),
+    checkers(board.checking_pieces()),
+    pinned(board.pinned_pieces())
+{
+}
+
+const Move* Move_Generator::next() noexcept
+{
+    if(stage == Stage::HASH_MOVE)
+    {
+        stage = Stage::HASH_MOVE_RETURNED;
+        if(legal_hash_move())
+        {
+            return first_move;
+        }
+    }
+
+    while(true)
+    {
+        while(next_index < stage_moves.size())
+        {
+            const auto move = stage_moves[next_index++];
+            if(move != first_move && is_legal(*move))
+            {
+                return move;
+            }
+        }
+
+        if(stage == Stage::DONE)
+        {
+            return nullptr;
+        }
+
+        advance_stage();
+    }
+}
+
+const Move* Move_Generator::legal_hash_move() noexcept
+{
+    if(first_move && ! hash_move_checked && ! hash_move_is_legal())
+    {
+        first_move = nullptr;
+    }
+
+    hash_move_checked = true;
+    return first_move;
+}
+
+void Move_Generator::all_legal_moves(const Board& board, Board::move_list& moves) noexcept
+{
+    auto generator = Move_Generator(board);
+    generator.stage = generator.checkers ? Stage::CHECK_EVASIONS : Stage::ALL_MOVES;
+    generator.generate_stage_moves();
+    for(const auto move : generator.stage_moves)
+    {
+        if(generator.is_legal(*move))
+        {
+            moves.push_back(move);
+        }
+    }
+}
+
+void Move_Generator::advance_stage() noexcept
+{
+    switch(stage)
+    {
+        case Stage::HASH_MOVE:
+        case Stage::HASH_MOVE_RETURNED:
+            stage = checkers ? Stage::CHECK_EVASIONS : Stage::CAPTURES;
+            break;
+        case Stage::CAPTURES:
+            stage = captures_only ? Stage::DONE : Stage::QUIET_MOVES;
+            break;
+        default:
+            stage = Stage::DONE;
+            break;
+    }
+
+    generate_stage_moves();
+}
+
+void Move_Generator::generate_stage_moves() noexcept
+{
+    stage_moves.clear();
+    next_index = 0;
+
+    const auto own_pieces = board.color_squares[std::to_underlying(board.whose_turn())];
+    const auto enemy_pieces = board.color_squares[std::to_underlying(opposite(board.whose_turn()))];
+    const auto empty_squares = ~(own_pieces | enemy_pieces);
+    switch(stage)
+    {
+        case Stage::CAPTURES:
+            add_piece_moves(enemy_pieces, enemy_pieces);
+            add_pawn_captures(enemy_pieces);
+            add_pawn_moves(empty_squares, true, false);
+            add_en_passant();
+            break;
+
+        case Stage::QUIET_MOVES:
+            add_piece_moves(empty_squares, empty_squares);
+            add_pawn_moves(empty_squares, false, true);
+            add_castling();
+            break;
+
+        case Stage::ALL_MOVES:
+            add_piece_moves(~own_pieces, ~own_pieces);
+            add_pawn_captures(enemy_pieces);
+            add_pawn_moves(empty_squares, true, true);
+            add_en_passant();
+            add_castling();
+            break;
+
+        case Stage::CHECK_EVASIONS:
+        {
+            const auto king_targets = captures_only ? enemy_pieces : ~own_pieces;
+            if(Bitboard::count(checkers) > 1)
+            {
+                add_piece_moves(0, king_targets);
+                break;
+            }
+
+            // Other pieces must capture the checking piece or block its attack.
+            const auto blocking_squares = checkers | Bitboard::squares_between(king_square, Bitboard::first_square(checkers));
+            add_piece_moves(king_targets & blocking_squares, king_targets);
+            add_pawn_captures(enemy_pieces & blocking_squares);
+            add_pawn_moves(empty_squares & blocking_squares, true, ! captures_only);
+            add_en_passant();
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+void Move_Generator::remove_illegal_moves() noexcept
+{
+    size_t legal_count = 0;
+    for(const auto move : stage_moves)
+    {
+        if(move != first_move && is_legal(*move))
+        {
+            stage_moves[legal_count++] = move;
+        }
+    }
+
+    while(stage_moves.size() > legal_count)
+    {
+        stage_moves.pop_back();
+    }
+}
+
+bool Move_Generator::hash_move_is_legal() const noexcept
+{
+    assert(first_move);
+    const auto moving_piece = board.piece_on_square(first_move->start());
+    if( ! moving_piece
+        || moving_piece.color() != board.whose_turn()
+        || ! moving_piece.can_move(first_move)
+        || (Bitboard::squares_between(first_move->start(), first_move->end()) & board.occupied_squares()))
+    {
+        return false;
+    }
+
+    if(captures_only && ! board.piece_on_square(first_move->end()) && ! first_move->promotion() && ! first_move->is_en_passant())
+    {
+        return false;
+    }
+
+    return first_move->is_pseudo_legal(board) && is_legal(*first_move);
+}
+
+bool Move_Generator::is_legal(const Move& move) const noexcept
+{
+    // Without check, a generated move by an unpinned piece other than the king is always legal.
+    if( ! checkers && move.start() != king_square && ! (pinned & Bitboard::square_bit(move.start())) && ! move.is_en_passant())
+    {
+        return true;
+    }
+
+    // Generated moves only need extra checks for castling, which depends on the safety of the squares the king crosses.
+    if(move.is_castle() && ! move.is_pseudo_legal(board))
+    {
+        return false;
+    }
+
+    return ! board.king_is_in_check_after_move(move, checkers, pinned);
+}
+
+void Move_Generator::add_piece_moves(const Bitboard::bitboard_t targets, const Bitboard::bitboard_t king_targets) noexcept
+{
+    const auto color = board.whose_turn();
+    const auto occupied = board.occupied_squares();
+    if(targets)
+    {
+        for(const auto type : {Piece_Type::KNIGHT, Piece_Type::BISHOP, Piece_Type::ROOK, Piece_Type::QUEEN})
+        {
+            auto movers = board.pieces(color, type);
+            while(movers)
+            {
+                const auto start = Bitboard::pop_first_square(movers);
+                auto attacks = Bitboard::bitboard_t{0};
+                switch(type)
+                {
+                    case Piece_Type::KNIGHT:
+                        attacks = Bitboard::knight_attacks(start);
+                        break;
+                    case Piece_Type::BISHOP:
+                        attacks = Bitboard::bishop_attacks(start, occupied);
+                        break;
+                    case Piece_Type::ROOK:
+                        attacks = Bitboard::rook_attacks(start, occupied);
+                        break;
+                    default:
+                        attacks = Bitboard::rook_attacks(start, occupied) | Bitboard::bishop_attacks(start, occupied);
+                        break;
+                }
+
+                attacks &= targets;
+                while(attacks)
+                {
+                    add_move({start, Bitboard::pop_first_square(attacks)});
+                }
+            }
+        }
+    }
+
+    auto king_moves = Bitboard::king_attacks(king_square) & king_targets;
+    while(king_moves)
+    {
+        add_move({king_square, Bitboard::pop_first_square(king_moves)});
+    }
+}
+
+void Move_Generator::add_pawn_captures(const Bitboard::bitboard_t targets) noexcept
+{
+    const auto color = board.whose_turn();
+    const auto pawns = board.pieces(color, Piece_Type::PAWN);
+    const auto rank_step = color == Piece_Color::WHITE ? 1 : -1;
+    for(const auto direction : {Direction::LEFT, Direction::RIGHT})
+    {
+        const auto capture_step = Square_Difference{direction == Direction::LEFT ? -1 : 1, rank_step};
+        auto ends = shift(pawns, capture_step) & targets;
+        while(ends)
+        {
+            const auto end = Bitboard::pop_first_square(ends);
+            const auto start = end - capture_step;
+            if(Bitboard::square_bit(end) & last_rank(color))
+            {
+                add_promotions(start, end, true);
+            }
+            else
+            {
+                add_move(Move::pawn_capture(start, direction, color, {}));
+            }
+        }
+    }
+}
+
+void Move_Generator::add_pawn_moves(const Bitboard::bitboard_t targets, const bool promotions, const bool other_moves) noexcept
+{
+    const auto color = board.whose_turn();
+    const auto step = Square_Difference{0, color == Piece_Color::WHITE ? 1 : -1};
+    const auto empty_squares = ~board.occupied_squares();
+    const auto single_moves = shift(board.pieces(color, Piece_Type::PAWN), step) & empty_squares;
+
+    if(promotions)
+    {
+        auto ends = single_moves & targets & last_rank(color);
+        while(ends)
+        {
+            const auto end = Bitboard::pop_first_square(ends);
+            add_promotions(end - step, end, false);
+        }
+    }
+
+    if(other_moves)
+    {
+        auto ends = single_moves & targets & ~last_rank(color);
+        while(ends)
+        {
+            add_move(Move::pawn_move(Bitboard::pop_first_square(ends) - step, color, {}));
+        }
+
+        const auto third_rank = shift(shift(first_rank(color), step), step);
+        auto double_ends = shift(single_moves & third_rank, step) & empty_squares & targets;
+        while(double_ends)
+        {
+            add_move(Move::pawn_double_move(color, Bitboard::pop_first_square(double_ends).file()));
+        }
+    }
+}
+
+void Move_Generator::add_promotions(const Square start, const Square end, const bool capturing) noexcept
+{
+    const auto color = board.whose_turn();
+    const auto direction = end.file() < start.file() ? Direction::LEFT : Direction::RIGHT;
+    for(const auto type : {Piece_Type::QUEEN, Piece_Type::KNIGHT, Piece_Type::ROOK, Piece_Type::BISHOP})
+    {
+        const auto promotion = Piece{color, type};
+        add_move(capturing ? Move::pawn_capture(start, direction, color, promotion) : Move::pawn_move(start, color, promotion));
+    }
+}
+
+void Move_Generator::add_en_passant() noexcept
+{
+    if( ! board.en_passant_target.is_set())
+    {
+        return;
+    }
+
+    const auto color = board.whose_turn();
+    const auto target = board.en_passant_target;
+    auto capturers = Bitboard::pawn_attacks(target, opposite(color)) & board.pieces(color, Piece_Type::PAWN);
+    while(capturers)
+    {
+        const auto start = Bitboard::pop_first_square(capturers);
+        add_move(Move::en_passant(color, start.file(), target.file() < start.file() ? Direction::LEFT : Direction::RIGHT));
+    }
+}
+
+void Move_Generator::add_castling() noexcept
+{
+    const auto color = board.whose_turn();
+    if( ! board.castle_is_legal(color, Direction::RIGHT) && ! board.castle_is_legal(color, Direction::LEFT))
+    {
+        return;
+    }
+
+    const auto occupied = board.occupied_squares();
+    for(const auto direction : {Direction::RIGHT, Direction::LEFT})
+    {
+        const auto rook_square = Square{direction == Direction::RIGHT ? 'h' : 'a', king_square.rank()};
+        if(board.castle_is_legal(color, direction) && ! (Bitboard::squares_between(king_square, rook_square) & occupied))
+        {
+            add_move(Move::castle(color, direction));
+        }
+    }
+}
+
+void Move_Generator::add_move(const Move& move) noexcept
+{
+    stage_moves.push_back(&Move::from_code(move.code()));
+}
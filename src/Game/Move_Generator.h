@@ -0,0 +1,133 @@
+#ifndef MOVE_GENERATOR_H
+#define MOVE_GENERATOR_H
+
+#include <cstddef>
+
+#include "Game/Board.h"
+#include "Game/Square.h"
+#include "Game/Bitboard.h"
+
+#include "Utility/Fixed_Capacity_Vector.h"
+
+class Move;
+
+//! \file
+
+//! \brief Generates the legal moves of a Board in stages as they are requested.
+//!
+//! Moves are produced in the following order: the hash move (if one is given and it is legal),
+//! then moves that change material (captures and pawn promotions), then all other moves. If the
+//! king is in check, the last two stages are replaced by a single stage that only considers moves
+//! that might get the king out of check. Each stage is generated only when the previous stage has
+//! been exhausted and the legality of each move is only checked just before it is returned, so a
+//! search that stops early does not pay for moves it never looks at.
+//!
+//! The Board must not change while the generator is in use.
+class Move_Generator
+{
+    public:
+        //! \brief Prepare to generate the legal moves of a board.
+        //!
+        //! \param board The board position whose moves will be generated.
+        //! \param hash_move A move to return first--usually the best move from an earlier search. This may
+        //!        be nullptr. If this move is not legal in the current position, it is skipped.
+        //! \param material_changing_moves_only If true, only captures and pawn promotions are generated.
+        explicit Move_Generator(const Board& board, const Move* hash_move = nullptr, bool material_changing_moves_only = false) noexcept;
+
+        //! \brief Get the next legal move.
+        //!
+        //! \returns A pointer to the next legal move, or nullptr if there are no more legal moves.
+        const Move* next() noexcept;
+
+        //! \brief Get the next legal move, letting the caller reorder each stage before its moves are returned.
+        //!
+        //! All of the moves in a stage are checked for legality as soon as the stage is generated
+        //! so that the sorter only sees legal moves. Do not mix calls to this method and
+        //! Move_Generator::next() on the same generator.
+        //! \tparam Stage_Sorter A callable type that accepts a begin and end iterator to a list of const Move*.
+        //! \param sort_stage A function that reorders the moves of a new stage.
+        //! \returns A pointer to the next legal move, or nullptr if there are no more legal moves.
+        template<typename Stage_Sorter>
+        const Move* next(Stage_Sorter sort_stage) noexcept;
+
+        //! \brief Check the hash move given to the constructor without generating any other moves.
+        //!
+        //! \returns The hash move if it is legal, or nullptr otherwise.
+        const Move* legal_hash_move() noexcept;
+
+        //! \brief Generate all of the legal moves of a board in a single pass.
+        //!
+        //! This is faster than calling Move_Generator::next() until it returns nullptr
+        //! when every move is needed, but the moves are in no particular order.
+        //! \param board The board position whose moves will be generated.
+        //! \param[out] moves The list of legal moves. Moves are added to the end of the list.
+        static void all_legal_moves(const Board& board, Board::move_list& moves) noexcept;
+
+    private:
+        enum class Stage
+        {
+            HASH_MOVE,
+            HASH_MOVE_RETURNED,
+            CAPTURES,
+            QUIET_MOVES,
+            CHECK_EVASIONS,
+            ALL_MOVES,
+            DONE
+        };
+
+        const Board& board;
+        const Move* first_move;
+        bool captures_only;
+        bool hash_move_checked = false;
+        Stage stage = Stage::HASH_MOVE;
+
+        Square king_square;
+        Bitboard::bitboard_t checkers;
+        Bitboard::bitboard_t pinned;
+
+        // There are at most 218 legal moves in any position. The extra space is for pseudo-legal moves.
+        Fixed_Capacity_Vector<const Move*, 256> stage_moves;
+        size_t next_index = 0;
+
+        void advance_stage() noexcept;
+        void generate_stage_moves() noexcept;
+        void remove_illegal_moves() noexcept;
+        bool hash_move_is_legal() const noexcept;
+        bool is_legal(const Move& move) const noexcept;
+        void add_piece_moves(Bitboard::bitboard_t targets, Bitboard::bitboard_t king_targets) noexcept;
+        void add_pawn_captures(Bitboard::bitboard_t targets) noexcept;
+        void add_pawn_moves(Bitboard::bitboard_t targets, bool promotions, bool other_moves) noexcept;
+        void add_promotions(Square start, Square end, bool capturing) noexcept;
+        void add_en_passant() noexcept;
+        void add_castling() noexcept;
+        void add_move(const Move& move) noexcept;
+};
+
+template<typename Stage_Sorter>
+const Move* Move_Generator::next(Stage_Sorter sort_stage) noexcept
+{
+    if(stage == Stage::HASH_MOVE)
+    {
+        stage = Stage::HASH_MOVE_RETURNED;
+        if(legal_hash_move())
+        {
+            return first_move;
+        }
+    }
+
+    while(next_index == stage_moves.size())
+    {
+        if(stage == Stage::DONE)
+        {
+            return nullptr;
+        }
+
+        advance_stage();
+        remove_illegal_moves();
+        sort_stage(stage_moves.begin(), stage_moves.end());
+    }
+
+    return stage_moves[next_index++];
+}
+
+#endif // MOVE_GENERATOR_H
@@ -5,6 +5,7 @@
 #include "Game/Game_Result.h"
 #include "Game/Color.h"
 #include "Game/Clock.h"
+#include "Game/Position_History.h"
 
 #include "Players/Player.h"
 
@@ -99,6 +100,10 @@ namespace
     //! \param input A text input stream. The position within the input stream should be passed the opening parenthesis.
     void confirm_rav(std::istream& input, Board board)
     {
+        // The moves of the variation replace moves of the main line.
+        Position_History rav_history;
+        board.use_position_history(rav_history);
+
         const auto rav_start_position = input.tellg();
         auto token_start = input.tellg();
         auto board_before_last_move = board;
@@ -238,7 +243,9 @@ void PGN::confirm_game_record(const std::string& file_name)
     auto expect_threefold_draw = false;
     auto in_game = false;
     std::map<std::string, std::string> headers;
+    Position_History game_history;
     Board board;
+    board.use_position_history(game_history);
     Board board_before_last_move;
     Game_Result result;
     while(true)
@@ -356,6 +363,7 @@ void PGN::confirm_game_record(const std::string& file_name)
             if( ! fen.empty())
             {
                 board = Board(fen);
+                board.use_position_history(game_history);
             }
         }
 
@@ -404,6 +412,7 @@ void PGN::confirm_game_record(const std::string& file_name)
             in_game = false;
             headers.clear();
             board = Board();
+            board.use_position_history(game_history);
             board_before_last_move = Board();
             result = {};
             ++game_count;
@@ -526,7 +535,9 @@ void PGN::print_game_record(const Board& board,
     }
 
     auto game_text = std::ostringstream();
+    Position_History commentary_history;
     auto commentary_board = Board(starting_fen);
+    commentary_board.use_position_history(commentary_history);
     auto previous_move_had_comment = false;
     for(const auto next_move : game_record_listing)
     {
@@ -2,12 +2,14 @@
 
 #include <cctype>
 #include <algorithm>
+#include <numeric>
 #include <cassert>
 #include <array>
-#include <cctype>
-#include <vector>
+#include <span>
+#include <cstdint>
 #include <stdexcept>
 #include <utility>
+#include <limits>
 
 #include "Game/Square.h"
 #include "Game/Color.h"
@@ -19,116 +21,168 @@
 namespace
 {
     const std::string pgn_symbols = "PRNBQK";
-    const auto invalid_code =
-        []()
-        {
-            auto max_code = Piece(pgn_symbols.front()).index();
-            for(const auto symbol : pgn_symbols)
-            {
-                const auto max_piece_code = std::max(Piece(symbol).index(), Piece(String::tolower(symbol)).index());
-                max_code = std::max(max_code, max_piece_code);
-            }
-            return max_code + 1;
-        }();
+    constexpr size_t piece_square_count = 12*64;
 
-    using indexed_move_array = std::array<std::array<Fixed_Capacity_Vector<Fixed_Capacity_Vector<const Move*, 7>, 12>, 64>, 12>;
+    // A queen near the center of the board has the most moves from one square.
+    constexpr size_t most_moves_from_a_square = 27;
 
-    void add_pawn_moves(indexed_move_array& out, Piece_Color color) noexcept;
-    void add_rook_moves(indexed_move_array& out, Piece_Color color, Piece_Type type = Piece_Type::ROOK) noexcept;
-    void add_knight_moves(indexed_move_array& out, Piece_Color color) noexcept;
-    void add_bishop_moves(indexed_move_array& out, Piece_Color color, Piece_Type type = Piece_Type::BISHOP) noexcept;
-    void add_queen_moves(indexed_move_array& out, Piece_Color color) noexcept;
-    void add_king_moves(indexed_move_array& out, Piece_Color color) noexcept;
+    //! \brief A move and the piece that can make it.
+    //!
+    //! The properties of the move are copied so that the move tables can be built during
+    //! compilation without reading the shared instances returned by Move::from_code().
+    struct Piece_Move
+    {
+        Piece piece;
+        const Move* move = nullptr;
+        Square start;
+        Square_Difference movement{};
+        Piece promotion;
+        bool can_capture = false;
+    };
+
+    using piece_move_list = Fixed_Capacity_Vector<Piece_Move, piece_square_count*most_moves_from_a_square>;
+
+    constexpr void add_pawn_moves(piece_move_list& out, Piece_Color color) noexcept;
+    constexpr void add_rook_moves(piece_move_list& out, Piece_Color color, Piece_Type type = Piece_Type::ROOK) noexcept;
+    constexpr void add_knight_moves(piece_move_list& out, Piece_Color color) noexcept;
+    constexpr void add_bishop_moves(piece_move_list& out, Piece_Color color, Piece_Type type = Piece_Type::BISHOP) noexcept;
+    constexpr void add_queen_moves(piece_move_list& out, Piece_Color color) noexcept;
+    constexpr void add_king_moves(piece_move_list& out, Piece_Color color) noexcept;
+
+    constexpr size_t table_index(const Piece piece, const Square square) noexcept
+    {
+        return 64*piece.index() + square.index();
+    }
+
+    //! \brief The moves of all pieces from all squares stored in one array.
+    //!
+    //! This is a compressed sparse row layout. The moves array holds every list of moves one
+    //! after another, ordered by piece, starting square, and direction. List i is stored in
+    //! moves[list_starts[i]] up to moves[list_starts[i + 1]]. The lists of a piece on a square
+    //! are lists first_lists[table_index(piece, square)] up to first_lists[table_index(piece, square) + 1].
+    template<size_t move_count, size_t list_count>
+    struct Move_Table
+    {
+        std::array<const Move*, move_count> moves{};
+        std::array<uint16_t, list_count + 1> list_starts{};
+        std::array<uint16_t, piece_square_count + 1> first_lists{};
 
-    const auto legal_moves =
-        []()
+        Move_Lists lists(const Piece piece, const Square square) const noexcept
         {
-            indexed_move_array result;
-            for(auto color : {Piece_Color::WHITE, Piece_Color::BLACK})
-            {
-                add_pawn_moves(result, color);
-                add_rook_moves(result, color);
-                add_knight_moves(result, color);
-                add_bishop_moves(result, color);
-                add_queen_moves(result, color);
-                add_king_moves(result, color);
-            }
+            const auto index = table_index(piece, square);
+            return Move_Lists(moves.data(), &list_starts[first_lists[index]], size_t(first_lists[index + 1] - first_lists[index]));
+        }
 
-            return result;
-        }();
+        std::span<const Move* const> all_moves(const Piece piece, const Square square) const noexcept
+        {
+            const auto index = table_index(piece, square);
+            return std::span(moves).subspan(list_starts[first_lists[index]], size_t(list_starts[first_lists[index + 1]] - list_starts[first_lists[index]]));
+        }
+    };
+
+    //! \brief Arrange moves into a Move_Table.
+    //!
+    //! \param piece_moves All possible moves of all pieces. The moves of a piece from a square
+    //!        must be grouped by direction and ordered by distance from the starting square.
+    //! \param include Which moves to put in the table. Lists left with no moves are skipped.
+    //! \returns A table with the moves and lists at the front of its arrays. The number of lists
+    //!          is first_lists.back() and the number of moves is list_starts[first_lists.back()].
+    template<size_t move_capacity, size_t list_capacity>
+    constexpr Move_Table<move_capacity, list_capacity> fill_move_table(const piece_move_list& piece_moves, bool include(const Piece_Move&)) noexcept
+    {
+        // A counting sort by piece and starting square keeps the moves of each piece on
+        // each square in the order they were added.
+        std::array<size_t, piece_square_count + 1> index_starts{};
+        for(const auto& piece_move : piece_moves)
+        {
+            ++index_starts[table_index(piece_move.piece, piece_move.start) + 1];
+        }
+        std::partial_sum(index_starts.begin(), index_starts.end(), index_starts.begin());
 
+        piece_move_list sorted_moves = piece_moves;
+        auto next_sorted_index = index_starts;
+        for(const auto& piece_move : piece_moves)
+        {
+            sorted_moves[next_sorted_index[table_index(piece_move.piece, piece_move.start)]++] = piece_move;
+        }
 
-    const auto attack_moves =
-        []()
+        Move_Table<move_capacity, list_capacity> table;
+        size_t move_index = 0;
+        size_t list_index = 0;
+        for(size_t index = 0; index < piece_square_count; ++index)
         {
-            indexed_move_array result;
-            for(auto color : {Piece_Color::WHITE, Piece_Color::BLACK})
+            table.first_lists[index] = uint16_t(list_index);
+            auto new_list_needed = true;
+            const Piece_Move* previous_move = nullptr;
+            for(auto sorted_index = index_starts[index]; sorted_index < index_starts[index + 1]; ++sorted_index)
             {
-                for(auto type_index = 0; type_index <= std::to_underlying(Piece_Type::KING); ++type_index)
+                const auto& piece_move = sorted_moves[sorted_index];
+                if(previous_move &&
+                   ( ! same_direction(piece_move.movement, previous_move->movement) ||
+                     piece_move.promotion != previous_move->promotion))
                 {
-                    const auto piece = Piece{color, static_cast<Piece_Type>(type_index)};
-                    for(size_t index = 0; index < 64; ++index)
-                    {
-                        for(const auto& move_list : legal_moves[piece.index()][index])
-                        {
-                            result[piece.index()][index].push_back({});
-
-                            for(auto move : move_list)
-                            {
-                                // Make list of all capturing moves, excluding all but one type of pawn capture per square.
-                                if(move->can_capture()
-                                    && (move->promotion_piece_symbol() == 'Q' || move->promotion_piece_symbol() == '\0'))
-                                {
-                                    result[piece.index()][index].back().push_back(move);
-                                }
-                            }
-                        }
-                    }
+                    new_list_needed = true;
                 }
-            }
+                previous_move = &piece_move;
 
-            return result;
-        }();
+                if( ! include(piece_move))
+                {
+                    continue;
+                }
 
+                if(new_list_needed)
+                {
+                    table.list_starts[list_index++] = uint16_t(move_index);
+                    new_list_needed = false;
+                }
 
-    // Add a move to the list that is only legal when starting from a certain square
-    // (e.g., castling, pawn double move, promotion, etc.)
-    template<typename Move_Type, typename ...Parameters>
-    void add_legal_move(indexed_move_array& out, const Piece piece, const Parameters ... parameters) noexcept
-    {
-        const auto move = new Move_Type(parameters...);
-        auto& lists = out[piece.index()][move->start().index()];
-        if(lists.empty())
-        {
-            lists.push_back({});
+                table.moves[move_index++] = piece_move.move;
+            }
         }
 
-        if( ! lists.back().empty())
+        table.first_lists.back() = uint16_t(list_index);
+        table.list_starts[list_index] = uint16_t(move_index);
+        return table;
+    }
+
+    constexpr piece_move_list all_piece_moves() noexcept
+    {
+        piece_move_list result;
+        for(auto color : {Piece_Color::WHITE, Piece_Color::BLACK})
         {
-            const auto& last_move = lists.back().back();
-            if( ! same_direction(move->movement(), last_move->movement()) ||
-                move->promotion_piece_symbol() != last_move->promotion_piece_symbol())
-            {
-                lists.push_back({});
-            }
+            add_pawn_moves(result, color);
+            add_rook_moves(result, color);
+            add_knight_moves(result, color);
+            add_bishop_moves(result, color);
+            add_queen_moves(result, color);
+            add_king_moves(result, color);
         }
+        return result;
+    }
 
-        lists.back().push_back(move);
+    // Add a move to the list of moves a piece can make from the starting square
+    constexpr void add_legal_move(piece_move_list& out, const Piece piece, const Move& new_move) noexcept
+    {
+        out.push_back({piece, &Move::from_code(new_move.code()), new_move.start(), new_move.movement(), new_move.promotion(), new_move.can_capture()});
     }
 
-    void add_standard_legal_move(indexed_move_array& out, const Piece piece, const int file_step, const int rank_step) noexcept
+    constexpr void add_standard_legal_move(piece_move_list& out, const Piece piece, const int file_step, const int rank_step) noexcept
     {
-        for(auto start : Square::all_squares())
+        for(char file = 'a'; file <= 'h'; ++file)
         {
-            const auto end = start + Square_Difference{file_step, rank_step};
-            if(end.inside_board())
+            for(int rank = 1; rank <= 8; ++rank)
             {
-                add_legal_move<Move>(out, piece, start, end);
+                const auto start = Square{file, rank};
+                const auto end = start + Square_Difference{file_step, rank_step};
+                if(end.inside_board())
+                {
+                    add_legal_move(out, piece, Move(start, end));
+                }
             }
         }
     }
 
-    void add_pawn_moves(indexed_move_array& out, const Piece_Color color) noexcept
+    constexpr void add_pawn_moves(piece_move_list& out, const Piece_Color color) noexcept
     {
         const auto pawn = Piece{color, Piece_Type::PAWN};
         const auto base_rank = (color == Piece_Color::WHITE ? 2 : 7);
@@ -138,25 +192,16 @@ namespace
         {
             for(int rank = base_rank; rank != no_normal_move_rank; rank += rank_change)
             {
-                add_legal_move<Move>(out, pawn, Move::pawn_move(Square{file, rank}, color, Piece{}));
+                add_legal_move(out, pawn, Move::pawn_move(Square{file, rank}, color, Piece{}));
             }
         }
 
         for(char file = 'a'; file <= 'h'; ++file)
         {
-            add_legal_move<Move>(out, pawn, Move::pawn_double_move(color, file));
+            add_legal_move(out, pawn, Move::pawn_double_move(color, file));
         }
 
-        std::vector<Piece_Type> possible_promotions;
-        for(auto type_index = 0; type_index <= std::to_underlying(Piece_Type::KING); ++type_index)
-        {
-            const auto type = static_cast<Piece_Type>(type_index);
-            if(type == Piece_Type::PAWN || type == Piece_Type::KING)
-            {
-                continue;
-            }
-            possible_promotions.push_back(type);
-        }
+        const auto possible_promotions = {Piece_Type::ROOK, Piece_Type::KNIGHT, Piece_Type::BISHOP, Piece_Type::QUEEN};
 
         for(const auto dir : {Direction::RIGHT, Direction::LEFT})
         {
@@ -166,15 +211,17 @@ namespace
             {
                 for(int rank = base_rank; rank != no_normal_move_rank; rank += rank_change)
                 {
-                    add_legal_move<Move>(out, pawn, Move::pawn_capture(Square{file, rank}, dir, color, Piece{}));
+                    add_legal_move(out, pawn, Move::pawn_capture(Square{file, rank}, dir, color, Piece{}));
                 }
+
+                add_legal_move(out, pawn, Move::en_passant(color, file, dir));
             }
 
             for(auto promote : possible_promotions)
             {
                 for(auto file = first_file; file <= last_file; ++file)
                 {
-                    add_legal_move<Move>(out, pawn, Move::pawn_capture(Square{file, no_normal_move_rank}, dir, color, Piece{color, promote}));
+                    add_legal_move(out, pawn, Move::pawn_capture(Square{file, no_normal_move_rank}, dir, color, Piece{color, promote}));
                 }
             }
         }
@@ -183,12 +230,12 @@ namespace
         {
             for(auto file = 'a'; file <= 'h'; ++file)
             {
-                add_legal_move<Move>(out, pawn, Move::pawn_move(Square{file, no_normal_move_rank}, color, Piece{color, promote}));
+                add_legal_move(out, pawn, Move::pawn_move(Square{file, no_normal_move_rank}, color, Piece{color, promote}));
             }
         }
     }
 
-    void add_rook_moves(indexed_move_array& out, const Piece_Color color, const Piece_Type type) noexcept
+    constexpr void add_rook_moves(piece_move_list& out, const Piece_Color color, const Piece_Type type) noexcept
     {
         for(int d_file = -1; d_file <= 1; ++d_file)
         {
@@ -205,7 +252,7 @@ namespace
         }
     }
 
-    void add_knight_moves(indexed_move_array& out, const Piece_Color color) noexcept
+    constexpr void add_knight_moves(piece_move_list& out, const Piece_Color color) noexcept
     {
         for(auto d_file : {1, 2})
         {
@@ -220,7 +267,7 @@ namespace
         }
     }
 
-    void add_bishop_moves(indexed_move_array& out, const Piece_Color color, const Piece_Type type) noexcept
+    constexpr void add_bishop_moves(piece_move_list& out, const Piece_Color color, const Piece_Type type) noexcept
     {
         for(int d_rank : {-1, 1})
         {
@@ -234,13 +281,13 @@ namespace
         }
     }
 
-    void add_queen_moves(indexed_move_array& out, const Piece_Color color) noexcept
+    constexpr void add_queen_moves(piece_move_list& out, const Piece_Color color) noexcept
     {
         add_bishop_moves(out, color, Piece_Type::QUEEN);
         add_rook_moves(out, color, Piece_Type::QUEEN);
     }
 
-    void add_king_moves(indexed_move_array& out, const Piece_Color color) noexcept
+    constexpr void add_king_moves(piece_move_list& out, const Piece_Color color) noexcept
     {
         const auto king = Piece{color, Piece_Type::KING};
         for(int d_rank = -1; d_rank <= 1; ++d_rank)
@@ -254,17 +301,47 @@ namespace
                 {
                     if(d_file > 0)
                     {
-                        add_legal_move<Move>(out, king, Move::castle(color, Direction::RIGHT));
+                        add_legal_move(out, king, Move::castle(color, Direction::RIGHT));
                     }
                     else
                     {
-                        add_legal_move<Move>(out, king, Move::castle(color, Direction::LEFT));
+                        add_legal_move(out, king, Move::castle(color, Direction::LEFT));
                     }
                 }
             }
         }
     }
 
+    constexpr auto piece_moves = all_piece_moves();
+    static_assert(piece_moves.size() <= std::numeric_limits<uint16_t>::max(), "Move table indices do not fit in 16 bits.");
+
+    //! \brief Create a Move_Table that is exactly big enough for the moves that pass a filter.
+    //!
+    //! \tparam include Which moves to put in the table.
+    template<bool include(const Piece_Move&)>
+    constexpr auto make_move_table() noexcept
+    {
+        // Counting the moves and lists in a table with room for every move sets the size of the final table.
+        constexpr auto oversized_table = fill_move_table<piece_moves.size(), piece_moves.size()>(piece_moves, include);
+        constexpr size_t list_count = oversized_table.first_lists.back();
+        constexpr size_t move_count = oversized_table.list_starts[list_count];
+        return fill_move_table<move_count, list_count>(piece_moves, include);
+    }
+
+    constexpr bool any_move(const Piece_Move&) noexcept
+    {
+        return true;
+    }
+
+    // Make list of all capturing moves, excluding all but one type of pawn capture per square.
+    constexpr bool attacking_move(const Piece_Move& piece_move) noexcept
+    {
+        return piece_move.can_capture && ( ! piece_move.promotion || piece_move.promotion.type() == Piece_Type::QUEEN);
+    }
+
+    constexpr auto legal_moves = make_move_table<any_move>();
+    constexpr auto attack_moves = make_move_table<attacking_move>();
+
     Piece_Type piece_type_from_char(const char pgn_symbol)
     {
         const auto i = pgn_symbols.find(String::toupper(pgn_symbol));
@@ -276,33 +353,11 @@ namespace
     }
 }
 
-Piece::Piece() noexcept : piece_code(invalid_code)
-{
-}
-
-Piece::Piece(const Piece_Color color, const Piece_Type type) noexcept :
-    piece_code((std::to_underlying(type) << 1) | std::to_underlying(color))
-{
-    // piece_code layout: 4 bits
-    // 3 most significant bits = Piece_Type (values 0-5)
-    // least significant bit = Piece_Color (0 or 1)
-    //
-    // 101 1
-    // ^^^ ^-- Piece_Color::BLACK
-    //  +--- Piece_Type::KING
-}
-
 Piece::Piece(const char pgn_symbol) : Piece(std::isupper(pgn_symbol) ? Piece_Color::WHITE : Piece_Color::BLACK,
                                             piece_type_from_char(pgn_symbol))
 {
 }
 
-Piece_Color Piece::color() const noexcept
-{
-    assert(*this);
-    return static_cast<Piece_Color>(piece_code & 1);
-}
-
 std::string Piece::pgn_symbol() const noexcept
 {
     assert(*this);
@@ -319,41 +374,64 @@ char Piece::fen_symbol() const noexcept
 bool Piece::can_move(const Move* const move) const noexcept
 {
     assert(*this);
-    for(const auto& moves : move_lists(move->start()))
-    {
-        if(std::ranges::find(moves, move) != moves.end())
-        {
-            return true;
-        }
-    }
-
-    return false;
+    const auto moves = legal_moves.all_moves(*this, move->start());
+    return std::ranges::find(moves, move) != moves.end();
 }
 
-const Piece::list_of_move_lists& Piece::move_lists(const Square square) const noexcept
+Move_Lists Piece::move_lists(const Square square) const noexcept
 {
     assert(*this);
-    return legal_moves[index()][square.index()];
+    return legal_moves.lists(*this, square);
 }
 
-Piece_Type Piece::type() const noexcept
+Move_Lists Piece::attacking_move_lists(const Square square) const noexcept
 {
     assert(*this);
-    return static_cast<Piece_Type>(piece_code >> 1);
+    return attack_moves.lists(*this, square);
 }
 
-Piece::operator bool() const noexcept
+Move_Lists_Iterator::Move_Lists_Iterator(const Move* const* const all_moves, const uint16_t* const list_start_index) noexcept :
+    moves(all_moves),
+    list_start(list_start_index)
 {
-    return piece_code != invalid_code;
 }
 
-Piece::piece_code_t Piece::index() const noexcept
+Move_Lists_Iterator& Move_Lists_Iterator::operator++() noexcept
 {
-    return piece_code;
+    ++list_start;
+    return *this;
 }
 
-const Piece::list_of_move_lists& Piece::attacking_move_lists(const Square square) const noexcept
+Move_Lists_Iterator Move_Lists_Iterator::operator++(int) noexcept
 {
-    assert(*this);
-    return attack_moves[index()][square.index()];
+    const auto result = *this;
+    ++(*this);
+    return result;
+}
+
+std::span<const Move* const> Move_Lists_Iterator::operator*() const noexcept
+{
+    return std::span(moves + list_start[0], moves + list_start[1]);
+}
+
+Move_Lists::Move_Lists(const Move* const* const all_moves, const uint16_t* const list_start, const size_t count) noexcept :
+    moves(all_moves),
+    first_list_start(list_start),
+    list_count(count)
+{
+}
+
+Move_Lists_Iterator Move_Lists::begin() const noexcept
+{
+    return Move_Lists_Iterator(moves, first_list_start);
+}
+
+Move_Lists_Iterator Move_Lists::end() const noexcept
+{
+    return Move_Lists_Iterator(moves, first_list_start + list_count);
+}
+
+size_t Move_Lists::size() const noexcept
+{
+    return list_count;
 }
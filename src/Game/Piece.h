@@ -3,8 +3,11 @@
 
 #include <string>
 #include <utility>
-
-#include "Utility/Fixed_Capacity_Vector.h"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <cassert>
 
 #include "Game/Color.h"
 
@@ -26,6 +29,78 @@ enum class Piece_Type
 
 static_assert(std::to_underlying(Piece_Type::KING) == 5);
 
+//! \brief The iterator created by the Move_Lists container that dereferences to a list of moves.
+class Move_Lists_Iterator
+{
+    public:
+        //! \brief This iterator can be traversed more than once.
+        using iterator_category = std::forward_iterator_tag;
+        //! \brief The iterator dereferences to a list of moves.
+        using value_type = std::span<const Move* const>;
+        //! \brief The distance between iterators is a ptrdiff_t.
+        using difference_type = std::ptrdiff_t;
+        //! \brief The pointer to the data is a pointer to a list of moves.
+        using pointer = value_type*;
+        //! \brief The reference to the data is a list of moves.
+        using reference = value_type;
+
+        //! \brief Create an iterator over lists of moves stored one after another.
+        //!
+        //! \param moves The start of the array holding the moves of all lists.
+        //! \param list_start A pointer to the index in moves where the first list starts.
+        //!        The next index is where the first list ends and the second list starts.
+        Move_Lists_Iterator(const Move* const* moves, const uint16_t* list_start) noexcept;
+
+        //! \brief Create an iterator that does not refer to any list.
+        Move_Lists_Iterator() noexcept = default;
+
+        //! \brief Go to the next list of moves.
+        Move_Lists_Iterator& operator++() noexcept;
+
+        //! \brief Go to the next list of moves.
+        Move_Lists_Iterator operator++(int) noexcept;
+
+        //! \brief Iterators are equal when they refer to the same list.
+        bool operator==(const Move_Lists_Iterator& other) const noexcept = default;
+
+        //! \brief Get the list of moves referred to by the iterator.
+        std::span<const Move* const> operator*() const noexcept;
+
+    private:
+        const Move* const* moves = nullptr;
+        const uint16_t* list_start = nullptr;
+};
+
+//! \brief A pseudo-container for iterating over the lists of moves a piece can make from a square.
+//!
+//! All moves of all pieces are stored in one array ordered by piece, starting square, and
+//! direction. A separate array of starting indices marks where each list begins, so a
+//! container only needs to know the range of lists that belong to one piece on one square.
+class Move_Lists
+{
+    public:
+        //! \brief Create a container of lists of moves.
+        //!
+        //! \param moves The start of the array holding the moves of all lists.
+        //! \param first_list_start A pointer to the index in moves where the first list starts.
+        //! \param list_count The number of lists.
+        Move_Lists(const Move* const* moves, const uint16_t* first_list_start, size_t list_count) noexcept;
+
+        //! \brief Return the iterator to the first list.
+        Move_Lists_Iterator begin() const noexcept;
+
+        //! \brief Return the end iterator.
+        Move_Lists_Iterator end() const noexcept;
+
+        //! \brief The number of lists.
+        size_t size() const noexcept;
+
+    private:
+        const Move* const* moves;
+        const uint16_t* first_list_start;
+        size_t list_count;
+};
+
 //! \brief A class to represent chess pieces.
 //!
 //! Possible moves are stored within each piece.
@@ -33,17 +108,16 @@ class Piece
 {
     private:
         using piece_code_t = unsigned int;
-        using list_of_move_lists = Fixed_Capacity_Vector<Fixed_Capacity_Vector<const Move*, 7>, 12>;
 
     public:
         //! \brief Create an invalid piece that can represent an unoccupied space on a Board.
-        Piece() noexcept;
+        constexpr Piece() noexcept;
 
         //! \brief Create a piece.
         //!
         //! \param color The color of the piece.
         //! \param type The type of piece.
-        Piece(Piece_Color color, Piece_Type type) noexcept;
+        constexpr Piece(Piece_Color color, Piece_Type type) noexcept;
 
         //! \brief Create a piece from a single character FEN symbol
         //!
@@ -64,18 +138,18 @@ class Piece
         //! \brief The color of the piece.
         //!
         //! \returns The Piece_Color of the player that controls the piece.
-        Piece_Color color() const noexcept;
+        constexpr Piece_Color color() const noexcept;
 
         //! \brief Get the type of the piece.
         //!
         //! \returns The kind of piece, i.e., PAWN, ROOK, etc.
-        Piece_Type type() const noexcept;
+        constexpr Piece_Type type() const noexcept;
 
         //! \brief Returns true if the piece is valid. An invalid piece represents an empty square on a Board.
-        operator bool() const noexcept;
+        constexpr operator bool() const noexcept;
 
         //! \brief Returns an unsigned integer useful for indexing arrays.
-        piece_code_t index() const noexcept;
+        constexpr piece_code_t index() const noexcept;
 
         //! \brief Check that a piece is allowed to make a certain move.
         //!
@@ -88,13 +162,13 @@ class Piece
         //! \param square The square where the moves start.
         //! \returns A list of lists of legal moves starting from that square. The moves are grouped into
         //!          lists by direction and ordered by distance from the starting square.
-        const list_of_move_lists& move_lists(Square square) const noexcept;
+        Move_Lists move_lists(Square square) const noexcept;
 
         //! \brief Gives all moves that are allowed to capture other pieces.
         //!
         //! \param square The square where the attacking moves start.
         //! \returns A list of lists of moves grouped and ordered as in Piece::move_lists().
-        const list_of_move_lists& attacking_move_lists(Square square) const noexcept;
+        Move_Lists attacking_move_lists(Square square) const noexcept;
         
         //! \brief Check two pieces for equality
         //!
@@ -104,7 +178,48 @@ class Piece
         friend bool operator==(Piece a, Piece b) noexcept = default;
 
     private:
+        static constexpr piece_code_t invalid_code = 12;
         piece_code_t piece_code;
 };
 
+// Definitions of the functions that are used to build the move tables during compilation.
+
+constexpr Piece::Piece() noexcept : piece_code(invalid_code)
+{
+}
+
+constexpr Piece::Piece(const Piece_Color color, const Piece_Type type) noexcept :
+    piece_code((std::to_underlying(type) << 1) | std::to_underlying(color))
+{
+    // piece_code layout: 4 bits
+    // 3 most significant bits = Piece_Type (values 0-5)
+    // least significant bit = Piece_Color (0 or 1)
+    //
+    // 101 1
+    // ^^^ ^-- Piece_Color::BLACK
+    //  +--- Piece_Type::KING
+}
+
+constexpr Piece_Color Piece::color() const noexcept
+{
+    assert(*this);
+    return static_cast<Piece_Color>(piece_code & 1);
+}
+
+constexpr Piece_Type Piece::type() const noexcept
+{
+    assert(*this);
+    return static_cast<Piece_Type>(piece_code >> 1);
+}
+
+constexpr Piece::operator bool() const noexcept
+{
+    return piece_code != invalid_code;
+}
+
+constexpr Piece::piece_code_t Piece::index() const noexcept
+{
+    return piece_code;
+}
+
 #endif // PIECE_H
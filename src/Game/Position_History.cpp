@@ -0,0 +1,11 @@
+#include "Game/Position_History.h"
+
+void Position_History::record(const size_t ply, const uint64_t hash) noexcept
+{
+    hashes[ply & (capacity - 1)] = hash;
+}
+
+uint64_t Position_History::hash_at(const size_t ply) const noexcept
+{
+    return hashes[ply & (capacity - 1)];
+}
@@ -0,0 +1,47 @@
+#ifndef POSITION_HISTORY_H
+#define POSITION_HISTORY_H
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+//! \file
+
+//! \brief A record of the positions reached during a game and the search of its continuations.
+//!
+//! The Zobrist hashes of positions are stored in a ring buffer indexed by the ply of the
+//! game in which they occured. Since positions before the last pawn move or capture can
+//! never be repeated, only the last hundred or so plies need to be stored.
+//!
+//! A Board only holds a pointer to its history, which must be given to it with
+//! Board::use_position_history() before any move is played. All copies of a Board share
+//! the same history. A copy that is searched with Board::make_move() and Board::unmake_move()
+//! only writes to plies after the position where it was copied, so the game's history is left
+//! intact when the search returns. Boards that will play different moves at the same time
+//! (for example, on different threads) need their own histories.
+class Position_History
+{
+    public:
+        //! \brief The number of positions that are stored.
+        //!
+        //! This must be larger than the 100 plies of the fifty-move rule.
+        static constexpr size_t capacity = 128;
+
+        //! \brief Record the position reached at a given ply.
+        //!
+        //! \param ply The number of plies played in the game before this position.
+        //! \param hash The Zobrist hash of the position.
+        void record(size_t ply, uint64_t hash) noexcept;
+
+        //! \brief Get the hash of the position reached at a given ply.
+        //!
+        //! \param ply The number of plies played in the game before the position. This must
+        //!        be one of the last Position_History::capacity plies recorded.
+        uint64_t hash_at(size_t ply) const noexcept;
+
+    private:
+        static_assert((capacity & (capacity - 1)) == 0, "Position history capacity must be a power of two.");
+        std::array<uint64_t, capacity> hashes{};
+};
+
+#endif // POSITION_HISTORY_H
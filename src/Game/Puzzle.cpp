@@ -15,6 +15,7 @@ using namespace std::chrono_literals;
 #include "Game/Clock.h"
 #include "Game/Move.h"
 #include "Game/Game.h"
+#include "Game/Position_History.h"
 #include "Players/Genetic_AI.h"
 #include "Utility/Main_Tools.h"
 #include "Utility/String.h"
@@ -70,7 +71,9 @@ namespace Puzzle
         {
             solver->reset();
             std::println("\n=============\n\n{}", puzzle);
-            const auto board = Board{ puzzle };
+            Position_History history;
+            auto board = Board{ puzzle };
+            board.use_position_history(history);
             board.cli_print(std::cout);
             const auto clock = Clock(120s, 1);
             solver->choose_move(board, clock);
@@ -29,35 +29,6 @@ All_Squares_Iterator All_Squares::end() const noexcept
     return All_Squares_Iterator(Square{});
 }
 
-namespace
-{
-    const decltype(Square{}.index()) invalid_index = 64;
-}
-
-Square::Square() noexcept : square_index(invalid_index)
-{
-}
-
-Square::Square(const char file, const int rank) noexcept : square_index(8*(file - 'a') + (rank - 1))
-{
-    assert(inside_board());
-}
-
-char Square::file() const noexcept
-{
-    return char('a' + index()/8);
-}
-
-int Square::rank() const noexcept
-{
-    return 1 + index()%8;
-}
-
-Square::square_index_t Square::index() const noexcept
-{
-    return square_index;
-}
-
 std::string Square::text() const noexcept
 {
     return is_set() ? (file() + std::to_string(rank())) : "-";
@@ -69,30 +40,11 @@ Square_Color Square::color() const noexcept
     return (index()/8)%2 == (index()%8)%2 ? Square_Color::BLACK : Square_Color::WHITE;
 }
 
-bool Square::inside_board() const noexcept
-{
-    return index() < invalid_index;
-}
-
 bool Square::is_set() const noexcept
 {
     return inside_board();
 }
 
-Square& Square::operator+=(const Square_Difference& diff) noexcept
-{
-    assert(std::abs(diff.file_change) < 8 && std::abs(diff.rank_change) < 8);
-    const square_index_t new_rank_index = square_index + diff.rank_change;
-    if(new_rank_index/8 != square_index/8) // make sure file did not change (happens if new square is off the board vertically)
-    {
-        square_index = invalid_index;
-        return *this;
-    }
-
-    square_index = new_rank_index + 8*(diff.file_change);
-    return *this;
-}
-
 Square& Square::operator-=(const Square_Difference& diff) noexcept
 {
     return *this += -diff;
@@ -119,27 +71,11 @@ Squares_in_a_Line Square::square_line_from(const Square origin, const Square_Dif
     return Squares_in_a_Line(origin, direction);
 }
 
-bool operator==(const Square a, const Square b) noexcept
-{
-    return (a.index() == b.index()) || ( ! a.inside_board() && ! b.inside_board());
-}
-
-Square operator+(Square square, const Square_Difference& diff) noexcept
-{
-    return square += diff;
-}
-
 Square operator-(Square square, const Square_Difference& diff) noexcept
 {
     return square -= diff;
 }
 
-Square_Difference operator-(const Square a, const Square b) noexcept
-{
-    assert(a.inside_board() && b.inside_board());
-    return {a.file() - b.file(), a.rank() - b.rank()};
-}
-
 bool straight_line_move(const Square start, const Square end) noexcept
 {
     const auto move = end - start;
@@ -148,20 +84,6 @@ bool straight_line_move(const Square start, const Square end) noexcept
            std::abs(move.file_change) == std::abs(move.rank_change);
 }
 
-bool moves_are_parallel(const Square_Difference& move_1, const Square_Difference& move_2) noexcept
-{
-    // Think of the determinant of a 2x2 matrix with the two moves as column vectors.
-    // Parallel (including anti-parallel) vectors are not linearly independent, so
-    // the determinant of the matrix is zero.
-    return move_1.file_change*move_2.rank_change == move_2.file_change*move_1.rank_change;
-}
-
-bool same_direction(const Square_Difference& move_1, const Square_Difference& move_2) noexcept
-{
-    return moves_are_parallel(move_1, move_2) &&
-           move_1.file_change*move_2.file_change + move_1.rank_change*move_2.rank_change >= 0; // dot product
-}
-
 bool in_line_in_order(const Square a, const Square b, const Square c) noexcept
 {
     return same_direction(a - b, b - c);
@@ -4,6 +4,7 @@
 #include <cstddef>
 #include <string>
 #include <iterator>
+#include <cassert>
 
 #include "Game/Color.h"
 
@@ -36,7 +37,7 @@ class Square;
 //! \brief Check if two squares are the same.
 //!
 //! \returns Whether two squares have the same file and rank or are both outside the board.
-bool operator==(Square a, Square b) noexcept;
+constexpr bool operator==(Square a, Square b) noexcept;
 
 //! \brief This class represents a location on the board.
 //!
@@ -49,7 +50,7 @@ class Square
 
     public:
         //! \brief The default constructor creates an invalid square location.
-        Square() noexcept;
+        constexpr Square() noexcept;
 
         //! \brief This constructor creates a user-defined square.
         //!
@@ -58,22 +59,27 @@ class Square
         //!
         //! The validity of the square coordinates is not checked in release builds.
         //! In debug builds, invalid square coordinates (e.g., "i9") trigger an assertion failure.
-        Square(char file, int rank) noexcept;
+        constexpr Square(char file, int rank) noexcept;
+
+        //! \brief Create a square from its index.
+        //!
+        //! \param index A value returned by Square::index() for a square inside the board.
+        static constexpr Square from_index(square_index_t index) noexcept;
 
         //! \brief The file of the square.
         //!
         //! \returns The letter label of the square file.
-        char file() const noexcept;
+        constexpr char file() const noexcept;
 
         //! \brief The rank of the square.
         //!
         //! \returns The numerical label of the rank.
-        int rank() const noexcept;
+        constexpr int rank() const noexcept;
 
         //! \brief The index of the square.
         //!
         //! \returns An unsigned integer index.
-        square_index_t index() const noexcept;
+        constexpr square_index_t index() const noexcept;
 
         //! \brief Text representation of square.
         std::string text() const noexcept;
@@ -91,7 +97,7 @@ class Square
         //! \param diff A pair of integers representing the change in file and rank
         //! \returns A reference to the now-modified square. This may create a square that is off
         //!          the board ("h8" + (1,1), for example).
-        Square& operator+=(const Square_Difference& diff) noexcept;
+        constexpr Square& operator+=(const Square_Difference& diff) noexcept;
 
         //! \brief Apply an offset to a square in the opposite direction.
         //!
@@ -102,7 +108,7 @@ class Square
         //! \brief Check if the square is a valid Board position.
         //!
         //! \returns Whether the square is on the Board ("i10" returns false).
-        bool inside_board() const noexcept;
+        constexpr bool inside_board() const noexcept;
 
         //! \brief Check whether a square has been set with a valid coordinate.
         //!
@@ -155,6 +161,7 @@ class Square
         static Squares_in_a_Line square_line_from(Square origin, const Square_Difference& direction) noexcept;
 
     private:
+        static constexpr square_index_t invalid_index = 64;
         square_index_t square_index;
 
         //! \brief Go to the next Square when iterating over Square::all_squares().
@@ -169,7 +176,7 @@ class Square
 //!
 //! \param square The original square.
 //! \param diff An offset between two squares.
-Square operator+(Square square, const Square_Difference& diff) noexcept;
+constexpr Square operator+(Square square, const Square_Difference& diff) noexcept;
 
 //! \brief Add an offset to a square in the opposite direction, returning a new Square.
 //!
@@ -184,7 +191,7 @@ Square operator-(Square square, const Square_Difference& diff) noexcept;
 //! \returns A pair of integers representing the signed difference in file and rank.
 //!
 //! For all valid squares on a board, a + (b - a) == b.
-Square_Difference operator-(Square a, Square b) noexcept;
+constexpr Square_Difference operator-(Square a, Square b) noexcept;
 
 
 //! \brief Returns whether a rook or bishop could move from one square to another in one move.
@@ -201,7 +208,7 @@ bool straight_line_move(Square a, Square b) noexcept;
 //!
 //! \param move_1 A movement direction (length of the move does not matter).
 //! \param move_2 A movement direction (length of the move does not matter).
-bool moves_are_parallel(const Square_Difference& move_1, const Square_Difference& move_2) noexcept;
+constexpr bool moves_are_parallel(const Square_Difference& move_1, const Square_Difference& move_2) noexcept;
 
 //! \brief Returns whether two Square_Differences are parallel in the same direction.
 //!
@@ -212,7 +219,7 @@ bool moves_are_parallel(const Square_Difference& move_1, const Square_Difference
 //!
 //! \param move_1 A movement direction (length of the move does not matter).
 //! \param move_2 A movement direction (length of the move does not matter).
-bool same_direction(const Square_Difference& move_1, const Square_Difference& move_2) noexcept;
+constexpr bool same_direction(const Square_Difference& move_1, const Square_Difference& move_2) noexcept;
 
 //! \brief Returns whether the three squares form a line in the order given.
 //!
@@ -347,4 +354,87 @@ class Squares_in_a_Line
         Square_Difference step;
 };
 
+// Definitions of the functions that are used to build the move tables during compilation.
+
+constexpr Square::Square() noexcept : square_index(invalid_index)
+{
+}
+
+constexpr Square::Square(const char file, const int rank) noexcept : square_index(square_index_t(8*(file - 'a') + (rank - 1)))
+{
+    assert(inside_board());
+}
+
+constexpr Square Square::from_index(const square_index_t index) noexcept
+{
+    assert(index < invalid_index);
+    auto square = Square{};
+    square.square_index = index;
+    return square;
+}
+
+constexpr char Square::file() const noexcept
+{
+    return char('a' + index()/8);
+}
+
+constexpr int Square::rank() const noexcept
+{
+    return int(1 + index()%8);
+}
+
+constexpr Square::square_index_t Square::index() const noexcept
+{
+    return square_index;
+}
+
+constexpr bool Square::inside_board() const noexcept
+{
+    return index() < invalid_index;
+}
+
+constexpr Square& Square::operator+=(const Square_Difference& diff) noexcept
+{
+    assert(-8 < diff.file_change && diff.file_change < 8 && -8 < diff.rank_change && diff.rank_change < 8);
+    const square_index_t new_rank_index = square_index + square_index_t(diff.rank_change);
+    if(new_rank_index/8 != square_index/8) // make sure file did not change (happens if new square is off the board vertically)
+    {
+        square_index = invalid_index;
+        return *this;
+    }
+
+    square_index = new_rank_index + square_index_t(8*(diff.file_change));
+    return *this;
+}
+
+constexpr bool operator==(const Square a, const Square b) noexcept
+{
+    return (a.index() == b.index()) || ( ! a.inside_board() && ! b.inside_board());
+}
+
+constexpr Square operator+(Square square, const Square_Difference& diff) noexcept
+{
+    return square += diff;
+}
+
+constexpr Square_Difference operator-(const Square a, const Square b) noexcept
+{
+    assert(a.inside_board() && b.inside_board());
+    return {a.file() - b.file(), a.rank() - b.rank()};
+}
+
+constexpr bool moves_are_parallel(const Square_Difference& move_1, const Square_Difference& move_2) noexcept
+{
+    // Think of the determinant of a 2x2 matrix with the two moves as column vectors.
+    // Parallel (including anti-parallel) vectors are not linearly independent, so
+    // the determinant of the matrix is zero.
+    return move_1.file_change*move_2.rank_change == move_2.file_change*move_1.rank_change;
+}
+
+constexpr bool same_direction(const Square_Difference& move_1, const Square_Difference& move_2) noexcept
+{
+    return moves_are_parallel(move_1, move_2) &&
+           move_1.file_change*move_2.file_change + move_1.rank_change*move_2.rank_change >= 0; // dot product
+}
+
 #endif // SQUARE_H
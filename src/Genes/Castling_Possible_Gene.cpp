@@ -60,6 +60,11 @@ double Castling_Possible_Gene::score_board(const Board& board, const Piece_Color
     }
 }
 
+bool Castling_Possible_Gene::score_depends_on_move_history() const noexcept
+{
+    return true;
+}
+
 void Castling_Possible_Gene::gene_specific_mutation() noexcept
 {
     if(Random::coin_flip())
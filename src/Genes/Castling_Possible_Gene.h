@@ -17,6 +17,9 @@ class Castling_Possible_Gene : public Clonable_Gene<Castling_Possible_Gene>
     public:
         Castling_Possible_Gene() noexcept;
 
+        //! \brief The score depends on how many moves ago castling happened during the search.
+        bool score_depends_on_move_history() const noexcept override;
+
     private:
         Gene_Value kingside_preference = {"Kingside Preference", 1.0, 0.02};
         Gene_Value queenside_preference = {"Queenside Preference", 1.0, 0.02};
@@ -259,6 +259,11 @@ void Gene::reset_piece_strength_gene(const Piece_Strength_Gene*) noexcept
 {
 }
 
+bool Gene::score_depends_on_move_history() const noexcept
+{
+    return false;
+}
+
 bool Gene::has_priority() const noexcept
 {
     return list_properties().count(priorities.name(Game_Stage::OPENING)) != 0;
@@ -81,6 +81,11 @@ class Gene
         //! \param psg A pointer to the correct Piece Strength Gene.
         virtual void reset_piece_strength_gene(const Piece_Strength_Gene* psg) noexcept;
 
+        //! \brief Whether the gene's score depends on the moves that led to a position and not just the position itself.
+        //!
+        //! The scores of genes that only depend on the position can be cached by position.
+        virtual bool score_depends_on_move_history() const noexcept;
+
         //! Tests the board-scoring method of the Gene.
         //
         //! \brief Tests the board-scoring method of the Gene.
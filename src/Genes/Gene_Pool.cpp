@@ -18,14 +18,20 @@ using namespace std::chrono_literals;
 #include <string>
 #include <numeric>
 #include <sstream>
-#include <semaphore>
 #include <ranges>
 #include <print>
 #include <format>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <cassert>
+#include <span>
+#include <functional>
 
 #include "Players/Genetic_AI.h"
 
 #include "Game/Game.h"
+#include "Game/Color.h"
 #include "Game/Board.h"
 #include "Game/Clock.h"
 #include "Game/Game_Result.h"
@@ -34,6 +40,7 @@ using namespace std::chrono_literals;
 #include "Utility/Configuration.h"
 #include "Utility/Random.h"
 #include "Utility/Exceptions.h"
+#include "Utility/Thread_Pool.h"
 
 namespace
 {
@@ -44,6 +51,10 @@ namespace
     std::atomic_int space_counter = 0;
     void quit_gene_pool(int);
 
+    // Short gene pool games need much less than the transposition table of a player in a
+    // full game, and every offspring allocates a new table.
+    constexpr size_t default_transposition_table_size = 1; // megabytes
+
     Clock get_pool_clock(const Configuration& config);
     std::chrono::duration<double> get_start_delay(const Configuration& config);
     std::chrono::duration<double> get_duration(const std::string& parameter);
@@ -57,13 +68,129 @@ namespace
     size_t count_still_alive_lines(const std::string& genome_file_name) noexcept;
     std::vector<Genetic_AI> fill_pool(const std::string& genome_file_name, size_t gene_pool_population, size_t mutation_rate);
     void load_previous_game_stats(const std::string& game_record_file, Clock::seconds& game_time, std::array<size_t, 3>& color_wins);
-    Game_Result pool_game(const Board& board,
-                          const Clock::seconds game_time,
-                          Genetic_AI white,
-                          Genetic_AI black,
-                          const std::string& game_record_file,
-                          std::counting_semaphore<>& limiter) noexcept;
+
+    //! \brief The result of a gene pool game and the new AI that will replace the loser.
+    struct Pool_Game_Outcome
+    {
+        Game_Result result;
+
+        //! \brief The player that will survive. A draw picks one at random.
+        Winner_Color mating_winner;
+
+        Genetic_AI offspring;
+    };
+
+    //! \brief Play a game between two AIs and create the offspring that will replace the loser.
+    //!
+    //! The offspring is created and calibrated on the same thread as the game, so the
+    //! slow work of a round is spread across all simultaneous games. The random numbers
+    //! for the offspring come from random_bits, which is made by Random::new_task_generator()
+    //! when the game is submitted, so that they do not depend on the order games are run.
+    Pool_Game_Outcome pool_game(const Board& board,
+                                const Clock& game_clock,
+                                Genetic_AI white,
+                                Genetic_AI black,
+                                int offspring_id,
+                                size_t mutation_rate,
+                                const std::string& game_record_file,
+                                const Random::Random_Bits_Generator& random_bits) noexcept;
     Genetic_AI best_living_ai(const std::vector<Genetic_AI>& pool) noexcept;
+    //! \brief Play one game for every player and replace the losers with offspring.
+    //!
+    //! \param game_threads The threads that play the games.
+    //! \param players The players of the round. They are shuffled to pick the pairings.
+    //! \param board The starting position of each game.
+    //! \param game_clock The clock for each game.
+    //! \param mutation_rate The number of mutations of each offspring.
+    //! \param genome_file_name The gene pool file where offspring are recorded.
+    //! \param game_record_file The file where games are recorded.
+    //! \param color_wins The win counts for each color.
+    //! \param result_printer A record of game results for verbose output.
+    //! \param show_progress Whether to print a mark when each game starts and finishes.
+    void play_generational_round(Thread_Pool& game_threads,
+                                 std::span<Genetic_AI> players,
+                                 const Board& board,
+                                 const Clock& game_clock,
+                                 size_t mutation_rate,
+                                 const std::string& genome_file_name,
+                                 const std::string& game_record_file,
+                                 std::array<size_t, 3>& color_wins,
+                                 std::stringstream& result_printer,
+                                 bool show_progress);
+
+    //! \brief Move random players from each island to the next one.
+    //!
+    //! The islands are consecutive blocks of the pool. Players from the last island move to the first.
+    //! \param pool The gene pool.
+    //! \param island_count The number of islands.
+    //! \param migration_count The number of players that leave each island.
+    void migrate(std::vector<Genetic_AI>& pool, size_t island_count, size_t migration_count) noexcept;
+
+    // Islands record offspring in the gene pool file from several threads.
+    std::mutex genome_file_lock;
+
+    //! \brief Record the result of a game and replace the losing player with the offspring.
+    //!
+    //! \param outcome The finished game.
+    //! \param white The pool's copy of the player with the white pieces.
+    //! \param black The pool's copy of the player with the black pieces.
+    //! \param genome_file_name The gene pool file where the offspring is recorded.
+    //! \param color_wins The win counts for each color.
+    //! \param result_printer A record of game results for verbose output.
+    void apply_game_outcome(const Pool_Game_Outcome& outcome,
+                            Genetic_AI& white,
+                            Genetic_AI& black,
+                            const std::string& genome_file_name,
+                            std::array<size_t, 3>& color_wins,
+                            std::stringstream& result_printer);
+
+    //! \brief Gene pool games that start whenever a thread is free instead of in rounds.
+    //!
+    //! In the steady-state mode, two players that are not in a game are picked at random
+    //! as soon as a game thread is free. Each finished game replaces its loser right away,
+    //! so a long game only occupies its own thread.
+    class Steady_State_Schedule
+    {
+        public:
+            //! \brief A finished game and the IDs of its players.
+            struct Finished_Game
+            {
+                int white_id;
+                int black_id;
+                Pool_Game_Outcome outcome;
+            };
+
+            //! \brief Start games until every game thread is busy or there are not enough idle players.
+            //!
+            //! \param game_threads The threads that play the games. They must not outlive this schedule.
+            //! \param pool The gene pool.
+            //! \param board The starting position of each game.
+            //! \param game_clock The clock for each game.
+            //! \param mutation_rate The number of mutations of each offspring.
+            //! \param game_record_file The file where games are recorded.
+            void start_games(Thread_Pool& game_threads,
+                             const std::vector<Genetic_AI>& pool,
+                             const Board& board,
+                             const Clock& game_clock,
+                             size_t mutation_rate,
+                             const std::string& game_record_file) noexcept;
+
+            //! \brief The number of games that have started but have not been returned by wait_for_finished_game().
+            size_t games_in_progress() const noexcept;
+
+            //! \brief Wait for the next game to finish.
+            //!
+            //! The players of the game can be picked for a new game after this returns.
+            //! \exception assertion_failure If no games are in progress.
+            Finished_Game wait_for_finished_game() noexcept;
+
+        private:
+            std::vector<int> playing_ids;
+            std::mutex finished_lock;
+            std::condition_variable game_finished;
+            std::deque<Finished_Game> finished_games;
+    };
+
     void record_best_ai(const std::vector<Genetic_AI>& pool, const std::string& best_file_name) noexcept;
     void print_round_header(const std::vector<Genetic_AI>& pool,
                             const std::string& genome_file_name,
@@ -72,7 +199,7 @@ namespace
                             size_t first_mutation_interval,
                             size_t second_mutation_interval,
                             size_t mutation_rate,
-                            Clock::seconds game_time,
+                            const Clock& game_clock,
                             const Clock& pool_time) noexcept;
     void print_verbose_output(const std::stringstream& result_printer, const std::vector<Genetic_AI>& pool);
 }
@@ -80,12 +207,29 @@ namespace
 void gene_pool(const std::string& config_file)
 {
     const auto config = Configuration(config_file);
-    const auto maximum_simultaneous_games = config.as_positive_number<int>("maximum simultaneous games");
+    const auto maximum_simultaneous_games = config.as_positive_number<size_t>("maximum simultaneous games");
     const auto gene_pool_population = config.as_positive_number<size_t>("gene pool population");
     if(gene_pool_population % 2 != 0)
     {
         throw std::invalid_argument("Gene pool population must be even so every AI plays every round.");
     }
+    const auto pin_games_to_processors = config.has_parameter("pin games to processors") && config.as_boolean("pin games to processors", "yes", "no");
+    const auto steady_state = config.has_parameter("pool schedule") && config.as_boolean("pool schedule", "steady state", "generational");
+    const auto island_count = config.has_parameter("island count") ? config.as_positive_number<size_t>("island count") : size_t{1};
+    if(gene_pool_population % (2*island_count) != 0)
+    {
+        throw std::invalid_argument("Gene pool population must be divisible by twice the island count so every AI plays every round.");
+    }
+    if(steady_state && island_count > 1)
+    {
+        throw std::invalid_argument("The steady state pool schedule cannot be used with more than one island.");
+    }
+    const auto migration_interval = island_count > 1 ? config.as_positive_number<size_t>("migration interval") : size_t{1};
+    const auto migration_count = island_count > 1 ? config.as_number<size_t>("migration count") : size_t{0};
+    if(migration_count > gene_pool_population/island_count)
+    {
+        throw std::invalid_argument("The migration count cannot be larger than the population of an island.");
+    }
     const auto genome_file_name = config.as_text("gene pool file");
     if(genome_file_name.empty())
     {
@@ -97,15 +241,39 @@ void gene_pool(const std::string& config_file)
     const auto second_mutation_rate = config.as_positive_number<size_t>("second mutation rate");
     const auto second_mutation_interval = config.as_positive_number<size_t>("second mutation interval");
 
-    const auto minimum_game_time = config.as_positive_time_duration<Clock::seconds>("minimum game time");
-    const auto maximum_game_time = config.as_positive_time_duration<Clock::seconds>("maximum game time");
-    if(maximum_game_time < minimum_game_time)
+    const auto game_node_budget = config.has_parameter("game node budget") ? config.as_positive_number<size_t>("game node budget") : size_t{0};
+    const auto move_node_budget = config.has_parameter("move node budget") ? config.as_positive_number<size_t>("move node budget") : size_t{0};
+    const auto use_node_budget = game_node_budget > 0 || move_node_budget > 0;
+    const auto transposition_table_size = config.has_parameter("transposition table size") ? config.as_positive_number<size_t>("transposition table size") : default_transposition_table_size;
+    const auto use_thread_cpu_time = config.has_parameter("game clock") && config.as_boolean("game clock", "thread cpu time", "wall time");
+    const auto time_source = use_thread_cpu_time ? Time_Source::THREAD_CPU_TIME : Time_Source::WALL_TIME;
+
+    // Game times are not used when games have a node budget.
+    auto minimum_game_time = Clock::seconds{};
+    auto maximum_game_time = Clock::seconds{};
+    auto game_time_increment = Clock::seconds{};
+    if( ! use_node_budget)
     {
-        std::println(std::cerr, "Minimum game time = {}", minimum_game_time.count());
-        std::println(std::cerr, "Maximum game time = {}", maximum_game_time.count());
-        throw std::invalid_argument("Maximum game time must be greater than the minimum game time.");
+        minimum_game_time = config.as_positive_time_duration<Clock::seconds>("minimum game time");
+        maximum_game_time = config.as_positive_time_duration<Clock::seconds>("maximum game time");
+        if(maximum_game_time < minimum_game_time)
+        {
+            std::println(std::cerr, "Minimum game time = {}", minimum_game_time.count());
+            std::println(std::cerr, "Maximum game time = {}", maximum_game_time.count());
+            throw std::invalid_argument("Maximum game time must be greater than the minimum game time.");
+        }
+        game_time_increment = config.as_time_duration<Clock::seconds>("game time increment");
+    }
+    const auto game_clock = [=](const Clock::seconds game_time)
+                            {
+                                return use_node_budget ? Clock::node_budget(game_node_budget, move_node_budget) :
+                                                         Clock(game_time, 0, 0.0s, Time_Reset_Method::ADDITION, {}, time_source);
+                            };
+
+    if(config.has_parameter("random seed"))
+    {
+        Random::set_seed(config.as_number<uint64_t>("random seed"));
     }
-    const auto game_time_increment = config.as_time_duration<Clock::seconds>("game time increment");
 
     const auto board = Board{config.as_text_or_default("FEN", Board().fen())};
     const auto verbose_output = config.as_boolean("output volume", "verbose", "quiet");
@@ -127,8 +295,16 @@ void gene_pool(const std::string& config_file)
     }
     std::this_thread::sleep_for(start_delay);
 
+    Genetic_AI::use_calibration_cache_file(std::format("{}_calibration.txt", genome_file_name));
     auto round_count = count_still_alive_lines(genome_file_name);
     auto pool = fill_pool(genome_file_name, gene_pool_population, first_mutation_rate);
+    for(const auto& ai : pool)
+    {
+        // Offspring and the copies that play games keep this size.
+        ai.set_transposition_table_size(transposition_table_size);
+    }
+    auto steady_state_games = Steady_State_Schedule();
+    auto game_threads = Thread_Pool(std::min(maximum_simultaneous_games, gene_pool_population/2), pin_games_to_processors);
 
     const auto game_record_file = std::format("{}_games.pgn", genome_file_name);
     auto game_time = game_time_increment > 0.0s ? minimum_game_time : maximum_game_time;
@@ -140,64 +316,99 @@ void gene_pool(const std::string& config_file)
 
     pool_clock.start(Piece_Color::WHITE);
     signal(QUIT_SIGNAL, quit_gene_pool);
+    const auto mutation_rate_for_round = [&](const size_t round)
+                                         {
+                                             const auto mutation_phase = round % (first_mutation_interval + second_mutation_interval);
+                                             return mutation_phase < first_mutation_interval ? first_mutation_rate : second_mutation_rate;
+                                         };
+    const auto island_size = pool.size()/island_count;
     while(keep_going(pool_clock))
     {
-        const auto mutation_phase = round_count++ % (first_mutation_interval + second_mutation_interval);
-        const auto mutation_rate = mutation_phase < first_mutation_interval ? first_mutation_rate : second_mutation_rate;
-
-        print_round_header(pool, genome_file_name, color_wins, round_count, first_mutation_interval, second_mutation_interval, mutation_rate, game_time, pool_clock);
+        const auto mutation_rate = mutation_rate_for_round(round_count++);
+        size_t rounds_played = 1;
 
-        Random::shuffle(pool);
-        std::vector<std::future<Game_Result>> results;
-        auto limiter = std::counting_semaphore(maximum_simultaneous_games);
-        for(const auto& players : pool | std::views::chunk(2))
-        {
-            const auto& white = players[0];
-            const auto& black = players[1];
-            results.emplace_back(std::async(std::launch::async, pool_game, std::cref(board), game_time, white, black, std::cref(game_record_file), std::ref(limiter)));
-            std::print("=");
-            std::cout.flush();
-        }
-        std::println("");
-        std::cout.flush();
+        print_round_header(pool, genome_file_name, color_wins, round_count, first_mutation_interval, second_mutation_interval, mutation_rate, game_clock(game_time), pool_clock);
 
         std::stringstream result_printer;
-        for(const auto& [future_result, players] : std::ranges::zip_view(results, pool | std::views::chunk(2)))
+        if(steady_state)
         {
-            auto& white = players[0];
-            auto& black = players[1];
-
-            const auto result = future_result.get();
-            const auto winner = result.winner();
-            std::println(result_printer, "{} vs {}: {} ({})", white.id(), black.id(), color_text(winner), result.ending_reason());
-            std::print("^");
-            std::cout.flush();
-            ++space_counter;
+            // A round is as many games as a generational round. When quitting, the round
+            // lasts until the games in progress finish so that no results are lost.
+            for(size_t games_finished = 0;
+                games_finished < pool.size()/2 || ( ! keep_going(pool_clock) && steady_state_games.games_in_progress() > 0);
+                ++games_finished)
+            {
+                if(keep_going(pool_clock))
+                {
+                    steady_state_games.start_games(game_threads, pool, board, game_clock(game_time), mutation_rate, game_record_file);
+                }
 
-            const auto mating_winner = (winner == Winner_Color::NONE ? (Random::coin_flip() ? Winner_Color::WHITE : Winner_Color::BLACK) : winner);
-            auto& winning_player = (mating_winner == Winner_Color::WHITE ? white : black);
-            auto& losing_player = (winning_player.id() == white.id() ? black : white);
+                if(steady_state_games.games_in_progress() == 0)
+                {
+                    break;
+                }
 
-            auto offspring = Genetic_AI(white, black);
-            offspring.mutate(mutation_rate);
-            offspring.print(genome_file_name);
-            losing_player = offspring;
+                const auto game = steady_state_games.wait_for_finished_game();
+                const auto find_player = [&pool](const int id) -> Genetic_AI& { return *std::ranges::find(pool, id, &Genetic_AI::id); };
+                apply_game_outcome(game.outcome, find_player(game.white_id), find_player(game.black_id), genome_file_name, color_wins, result_printer);
+                std::print("^");
+                std::cout.flush();
+                ++space_counter;
+            }
+        }
+        else if(island_count == 1)
+        {
+            play_generational_round(game_threads, pool, board, game_clock(game_time), mutation_rate, genome_file_name, game_record_file, color_wins, result_printer, true);
+        }
+        else
+        {
+            // Each island plays its rounds on its own thread, pairing and replacing only its
+            // own players. The islands only wait for each other at migrations.
+            const auto first_round = round_count - 1;
+            std::vector<size_t> island_rounds(island_count);
+            std::vector<std::array<size_t, 3>> island_color_wins(island_count);
+            std::vector<std::stringstream> island_results(island_count);
+            {
+                std::vector<std::jthread> islands;
+                for(size_t island = 0; island < island_count; ++island)
+                {
+                    islands.emplace_back([&, island, random_bits = Random::new_task_generator()]()
+                                         {
+                                             Random::thread_generator() = random_bits;
+                                             const auto players = std::span(pool).subspan(island*island_size, island_size);
+                                             auto& rounds = island_rounds[island];
+                                             for(auto island_game_time = game_time; rounds < migration_interval && keep_going(pool_clock); ++rounds)
+                                             {
+                                                 play_generational_round(game_threads, players, board, game_clock(island_game_time), mutation_rate_for_round(first_round + rounds),
+                                                                         genome_file_name, game_record_file, island_color_wins[island], island_results[island], false);
+                                                 island_game_time = std::clamp(island_game_time + game_time_increment, minimum_game_time, maximum_game_time);
+                                             }
+                                         });
+                }
+            }
 
-            ++color_wins[std::to_underlying(winner)];
-            if(winner == Winner_Color::NONE)
+            for(size_t island = 0; island < island_count; ++island)
             {
-                winning_player.add_draw();
+                std::ranges::transform(color_wins, island_color_wins[island], color_wins.begin(), std::plus<>{});
+                result_printer << island_results[island].str();
             }
-            else
+
+            rounds_played = std::ranges::max(island_rounds);
+            round_count += rounds_played - 1;
+            std::print("Rounds played on each island: {}", rounds_played);
+            if(keep_going(pool_clock))
             {
-                winning_player.add_win();
+                migrate(pool, island_count, migration_count);
             }
         }
         std::println("");
         std::cout.flush();
         space_counter = 0;
 
-        std::sort(pool.begin(), pool.end());
+        for(auto island : pool | std::views::chunk(island_size))
+        {
+            std::ranges::sort(island);
+        }
         record_the_living(pool, genome_file_name);
         record_best_ai(pool, best_file_name);
 
@@ -206,7 +417,7 @@ void gene_pool(const std::string& config_file)
             print_verbose_output(result_printer, pool);
         }
 
-        game_time = std::clamp(game_time + game_time_increment, minimum_game_time, maximum_game_time);
+        game_time = std::clamp(game_time + double(rounds_played)*game_time_increment, minimum_game_time, maximum_game_time);
     }
     std::println("Done.");
 }
@@ -266,7 +477,7 @@ namespace
                             const size_t first_mutation_interval,
                             const size_t second_mutation_interval,
                             const size_t mutation_rate,
-                            const Clock::seconds game_time,
+                            const Clock& game_clock,
                             const Clock& pool_time) noexcept
     {
         const auto games_played = std::accumulate(color_wins.begin(), color_wins.end(), size_t{0});
@@ -274,15 +485,16 @@ namespace
         const auto black_wins = color_wins[std::to_underlying(Winner_Color::BLACK)];
         const auto draws = color_wins[std::to_underlying(Winner_Color::NONE)];
         const auto mutation_phase = round_count % (first_mutation_interval + second_mutation_interval);
+        const auto game_length = game_clock.limits_nodes() ? game_clock.time_control_string() : std::format("{:.4f} sec", game_clock.initial_time().count());
         std::print("\n\nGene pool size: {}  Gene pool file name: {}"
                    "\nGames: {}  White wins: {}  Black wins: {}  Draws: {}"
                    "\nRounds: {}  Mutation rate phase: {} ({}/{})"
-                   "\nMutation rate: {}  Game time: {:.4f} sec"
+                   "\nMutation rate: {}  Game time: {}"
                    "\nFinish time: {}\n\n",
                    pool.size(), genome_file_name,
                    games_played, white_wins, black_wins, draws,
                    round_count, mutation_phase, first_mutation_interval, second_mutation_interval,
-                   mutation_rate, game_time.count(),
+                   mutation_rate, game_length,
                    future_timestamp(pool_time.running_time_left()));
 
         const auto best_living = best_living_ai(pool);
@@ -327,7 +539,14 @@ namespace
             line = String::trim_outer_whitespace(line);
             if(line.starts_with("[TimeControl"))
             {
-                game_time = String::to_duration<Clock::seconds>(String::extract_delimited_text(line, '"', '"'));
+                try
+                {
+                    game_time = String::to_duration<Clock::seconds>(String::extract_delimited_text(line, '"', '"'));
+                }
+                catch(const std::invalid_argument&)
+                {
+                    // Games with a node budget do not have a game time.
+                }
             }
             else if(line.starts_with("[Result"))
             {
@@ -352,17 +571,172 @@ namespace
         }
     }
 
-    Game_Result pool_game(const Board& board,
-                          const Clock::seconds game_time,
-                          Genetic_AI white,
-                          Genetic_AI black,
-                          const std::string& game_record_file,
-                          std::counting_semaphore<>& limiter) noexcept
+    Pool_Game_Outcome pool_game(const Board& board,
+                                const Clock& game_clock,
+                                Genetic_AI white,
+                                Genetic_AI black,
+                                const int offspring_id,
+                                const size_t mutation_rate,
+                                const std::string& game_record_file,
+                                const Random::Random_Bits_Generator& random_bits) noexcept
     {
-        limiter.acquire();
-        const auto result = play_game(board, Clock{game_time}, white, black, "Gene pool", "Local computer", game_record_file, false);
-        limiter.release();
-        return result;
+        Random::thread_generator() = random_bits;
+        const auto result = play_game(board, game_clock, white, black, "Gene pool", "Local computer", game_record_file, false);
+        const auto winner = result.winner();
+        const auto mating_winner = (winner == Winner_Color::NONE ? (Random::coin_flip() ? Winner_Color::WHITE : Winner_Color::BLACK) : winner);
+        return {result, mating_winner, Genetic_AI(white, black, offspring_id, mutation_rate)};
+    }
+
+    void play_generational_round(Thread_Pool& game_threads,
+                                 const std::span<Genetic_AI> players,
+                                 const Board& board,
+                                 const Clock& game_clock,
+                                 const size_t mutation_rate,
+                                 const std::string& genome_file_name,
+                                 const std::string& game_record_file,
+                                 std::array<size_t, 3>& color_wins,
+                                 std::stringstream& result_printer,
+                                 const bool show_progress)
+    {
+        const auto print_progress = [show_progress](const auto mark)
+                                    {
+                                        if(show_progress)
+                                        {
+                                            std::print("{}", mark);
+                                            std::cout.flush();
+                                        }
+                                    };
+
+        Random::shuffle(players);
+        std::vector<std::future<Pool_Game_Outcome>> results;
+        auto offspring_id = Genome::reserve_ids(int(players.size()/2));
+        for(const auto& pairing : players | std::views::chunk(2))
+        {
+            const auto& white = pairing[0];
+            const auto& black = pairing[1];
+            results.emplace_back(game_threads.submit([&board, game_clock, white, black, offspring_id = offspring_id++, mutation_rate, &game_record_file, random_bits = Random::new_task_generator()]()
+                                                     {
+                                                         return pool_game(board, game_clock, white, black, offspring_id, mutation_rate, game_record_file, random_bits);
+                                                     }));
+            print_progress("=");
+        }
+        print_progress("\n");
+
+        for(const auto& [future_result, pairing] : std::ranges::zip_view(results, players | std::views::chunk(2)))
+        {
+            // Results are collected in the order the games were started, so the output
+            // does not depend on which games finish first.
+            apply_game_outcome(future_result.get(), pairing[0], pairing[1], genome_file_name, color_wins, result_printer);
+            print_progress("^");
+            if(show_progress)
+            {
+                ++space_counter;
+            }
+        }
+    }
+
+    void migrate(std::vector<Genetic_AI>& pool, const size_t island_count, const size_t migration_count) noexcept
+    {
+        // After shuffling, the first players of each island are the migrants. Swapping the
+        // first island's migrants with each other island's in turn moves every group of
+        // migrants to the next island.
+        const auto island_size = pool.size()/island_count;
+        for(auto island : pool | std::views::chunk(island_size))
+        {
+            Random::shuffle(island);
+        }
+
+        const auto migrants_begin = pool.begin();
+        const auto migrants_end = std::next(migrants_begin, std::ptrdiff_t(migration_count));
+        for(size_t island = 1; island < island_count; ++island)
+        {
+            std::swap_ranges(migrants_begin, migrants_end, std::next(migrants_begin, std::ptrdiff_t(island*island_size)));
+        }
+    }
+
+    void apply_game_outcome(const Pool_Game_Outcome& outcome,
+                            Genetic_AI& white,
+                            Genetic_AI& black,
+                            const std::string& genome_file_name,
+                            std::array<size_t, 3>& color_wins,
+                            std::stringstream& result_printer)
+    {
+        const auto winner = outcome.result.winner();
+        std::println(result_printer, "{} vs {}: {} ({})", white.id(), black.id(), color_text(winner), outcome.result.ending_reason());
+
+        auto& winning_player = (outcome.mating_winner == Winner_Color::WHITE ? white : black);
+        auto& losing_player = (winning_player.id() == white.id() ? black : white);
+
+        {
+            const auto lock = std::lock_guard(genome_file_lock);
+            outcome.offspring.print(genome_file_name);
+        }
+        losing_player = outcome.offspring;
+
+        ++color_wins[std::to_underlying(winner)];
+        if(winner == Winner_Color::NONE)
+        {
+            winning_player.add_draw();
+        }
+        else
+        {
+            winning_player.add_win();
+        }
+    }
+
+    void Steady_State_Schedule::start_games(Thread_Pool& game_threads,
+                                            const std::vector<Genetic_AI>& pool,
+                                            const Board& board,
+                                            const Clock& game_clock,
+                                            const size_t mutation_rate,
+                                            const std::string& game_record_file) noexcept
+    {
+        std::vector<const Genetic_AI*> idle_players;
+        for(const auto& ai : pool)
+        {
+            if(std::ranges::find(playing_ids, ai.id()) == playing_ids.end())
+            {
+                idle_players.push_back(&ai);
+            }
+        }
+        Random::shuffle(idle_players);
+
+        while(games_in_progress() < game_threads.size() && idle_players.size() >= 2)
+        {
+            const auto white = *idle_players.back();
+            idle_players.pop_back();
+            const auto black = *idle_players.back();
+            idle_players.pop_back();
+
+            playing_ids.push_back(white.id());
+            playing_ids.push_back(black.id());
+            game_threads.submit([this, &board, game_clock, white, black, offspring_id = Genome::reserve_ids(1), mutation_rate, &game_record_file, random_bits = Random::new_task_generator()]()
+                                {
+                                    auto outcome = pool_game(board, game_clock, white, black, offspring_id, mutation_rate, game_record_file, random_bits);
+                                    {
+                                        const auto lock = std::lock_guard(finished_lock);
+                                        finished_games.push_back({white.id(), black.id(), std::move(outcome)});
+                                    }
+                                    game_finished.notify_one();
+                                });
+        }
+    }
+
+    size_t Steady_State_Schedule::games_in_progress() const noexcept
+    {
+        return playing_ids.size()/2;
+    }
+
+    Steady_State_Schedule::Finished_Game Steady_State_Schedule::wait_for_finished_game() noexcept
+    {
+        assert(games_in_progress() > 0);
+        auto lock = std::unique_lock(finished_lock);
+        game_finished.wait(lock, [this]() { return ! finished_games.empty(); });
+        auto game = std::move(finished_games.front());
+        finished_games.pop_front();
+        std::erase(playing_ids, game.white_id);
+        std::erase(playing_ids, game.black_id);
+        return game;
     }
 
     void record_best_ai(const std::vector<Genetic_AI>& pool, const std::string& best_file_name) noexcept
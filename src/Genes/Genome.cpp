@@ -8,6 +8,9 @@
 #include <functional>
 #include <print>
 #include <format>
+#include <sstream>
+#include <atomic>
+#include <cstdint>
 
 #include "Game/Color.h"
 #include "Game/Clock.h"
@@ -35,7 +38,7 @@
 
 namespace
 {
-    int next_id = 0;
+    std::atomic_int next_id = 0;
 }
 
 Genome::Genome() noexcept :
@@ -121,7 +124,7 @@ Genome::Genome(std::istream& is, int id_in) : Genome()
                 throw Genome_Creation_Error(add_details(e));
             }
 
-            next_id = std::max(next_id, id() + 1);
+            next_id = std::max(next_id.load(), id() + 1);
             return;
         }
     }
@@ -146,7 +149,11 @@ Genome& Genome::operator=(const Genome& other) noexcept
     return *this;
 }
 
-Genome::Genome(const Genome& A, const Genome& B) noexcept : id_number(next_id++)
+Genome::Genome(const Genome& A, const Genome& B) noexcept : Genome(A, B, next_id++)
+{
+}
+
+Genome::Genome(const Genome& A, const Genome& B, const int id_in) noexcept : id_number(id_in)
 {
     std::ranges::transform(A.genome, B.genome,
                            genome.begin(),
@@ -158,6 +165,11 @@ Genome::Genome(const Genome& A, const Genome& B) noexcept : id_number(next_id++)
     reset_piece_strength_gene();
 }
 
+int Genome::reserve_ids(const int count) noexcept
+{
+    return next_id.fetch_add(count);
+}
+
 void Genome::read_from(std::istream& is)
 {
     for(std::string line; std::getline(is, line);)
@@ -213,11 +225,36 @@ double Genome::score_board(const Board& board, const Piece_Color perspective, si
                            });
 }
 
+double Genome::score_board(const Board& board, const Piece_Color perspective, size_t depth, const bool move_history_genes) const noexcept
+{
+    const auto progress_in_game = game_progress(board);
+    return std::accumulate(genome.begin(), genome.end(), 0.0,
+                           [&](auto sum, const auto& gene)
+                           {
+                               if(gene->score_depends_on_move_history() != move_history_genes)
+                               {
+                                   return sum;
+                               }
+
+                               return sum + gene->evaluate(board, perspective, depth, progress_in_game);
+                           });
+}
+
 double Genome::evaluate(const Board& board, const Piece_Color perspective, size_t depth) const noexcept
 {
     return score_board(board, perspective, depth) - score_board(board, opposite(perspective), depth);
 }
 
+double Genome::evaluate_position(const Board& board, const Piece_Color perspective) const noexcept
+{
+    return score_board(board, perspective, 0, false) - score_board(board, opposite(perspective), 0, false);
+}
+
+double Genome::evaluate_move_history(const Board& board, const Piece_Color perspective, size_t depth) const noexcept
+{
+    return score_board(board, perspective, depth, true) - score_board(board, opposite(perspective), depth, true);
+}
+
 void Genome::mutate(const size_t mutation_count) noexcept
 {
     // Create copies of genes equal in number to the number of mutatable components.
@@ -259,11 +296,26 @@ void Genome::print(std::ostream& os) const noexcept
     std::print(os, "END\n\n");
 }
 
+uint64_t Genome::content_hash() const noexcept
+{
+    std::ostringstream genes;
+    for(const auto& gene : genome)
+    {
+        gene->print(genes);
+    }
+    return String::hash(genes.str());
+}
+
 Clock::seconds Genome::time_to_examine(const Board& board, const Clock& clock) const noexcept
 {
     return gene_reference<Look_Ahead_Gene>().time_to_examine(board, clock);
 }
 
+size_t Genome::nodes_to_examine(const Board& board, const Clock& clock) const noexcept
+{
+    return gene_reference<Look_Ahead_Gene>().nodes_to_examine(board, clock);
+}
+
 double Genome::speculation_time_factor(const double game_progress) const noexcept
 {
     return gene_reference<Look_Ahead_Gene>().speculation_time_factor(game_progress);
@@ -5,6 +5,7 @@
 #include <memory>
 #include <iosfwd>
 #include <cassert>
+#include <cstdint>
 
 #include "Game/Color.h"
 #include "Game/Clock.h"
@@ -43,6 +44,20 @@ class Genome
         //! \param B The second parent.
         Genome(const Genome& A, const Genome& B) noexcept;
 
+        //! \brief Create a new genome from two existing genomes via mating with a given ID number.
+        //!
+        //! This is safe to call on any thread as long as the ID number comes from reserve_ids().
+        //! \param A The first parent.
+        //! \param B The second parent.
+        //! \param id_in The ID number of the new genome.
+        Genome(const Genome& A, const Genome& B, int id_in) noexcept;
+
+        //! \brief Set aside a block of ID numbers for genomes that will be created later.
+        //!
+        //! \param count The number of IDs to reserve.
+        //! \returns The first ID of the block. The rest follow consecutively.
+        static int reserve_ids(int count) noexcept;
+
         //! \brief Inject another genome's data into this one (i.e., assignment operator)
         //!
         //! \param other The originating genome.
@@ -67,6 +82,21 @@ class Genome
         //!        (i.e., at the root of the game tree).
         double evaluate(const Board& board, Piece_Color perspective, size_t depth) const noexcept;
 
+        //! \brief Evaluate a board position using only the genes whose scores depend on the position alone.
+        //!
+        //! Since the result only depends on the position, it can be cached. The sum of this
+        //! and Genome::evaluate_move_history() is equal to Genome::evaluate().
+        //! \param board The board position to be evaluated.
+        //! \param perspective The player for whom a higher score means a greater chance of victory.
+        double evaluate_position(const Board& board, Piece_Color perspective) const noexcept;
+
+        //! \brief Evaluate a board position using only the genes whose scores depend on the moves that led to it.
+        //!
+        //! \param board The board position to be evaluated.
+        //! \param perspective The player for whom a higher score means a greater chance of victory.
+        //! \param depth The current search depth on the game tree.
+        double evaluate_move_history(const Board& board, Piece_Color perspective, size_t depth) const noexcept;
+
         //! \brief Apply a number of random mutation to one gene in the genome.
         //!
         //! \param mutation_count The number of times to mutate the genome.
@@ -91,6 +121,12 @@ class Genome
         //! \param clock The game clock.
         Clock::seconds time_to_examine(const Board& board, const Clock& clock) const noexcept;
 
+        //! \brief Determine how many positions should be searched to choose a move when the clock has a node budget.
+        //!
+        //! \param board The current board position.
+        //! \param clock The game clock.
+        size_t nodes_to_examine(const Board& board, const Clock& clock) const noexcept;
+
         //! \brief Returns a factor that is multiplied by the time allocated to examine a branch of the game tree.
         //!
         //! \param game_progress An estimate of the amount of the game that has been played on a scale from 0.0 to 1.0.
@@ -120,11 +156,17 @@ class Genome
         //! \param os The output stream.
         void print(std::ostream& os) const noexcept;
 
+        //! \brief A hash of the gene data that ignores the ID number.
+        //!
+        //! Genomes with the same genes have the same hash in every run of the program.
+        uint64_t content_hash() const noexcept;
+
     private:
         int id_number;
         std::array<std::unique_ptr<Gene>, 14> genome;
 
         double score_board(const Board& board, Piece_Color perspective, size_t depth) const noexcept;
+        double score_board(const Board& board, Piece_Color perspective, size_t depth, bool move_history_genes) const noexcept;
         void reset_piece_strength_gene() noexcept;
 
         template<typename Gene_Type>
@@ -42,7 +42,7 @@ void Look_Ahead_Gene::load_gene_properties(const std::map<std::string, std::stri
 
 Clock::seconds Look_Ahead_Gene::time_to_examine(const Board& board, const Clock& clock) const noexcept
 {
-    const auto time_left = clock.running_time_left();
+    const auto time_left = clock.time_left(board.whose_turn());
     const auto moves_to_reset = clock.moves_until_reset(board.whose_turn());
     const auto moves_left = expected_moves_left(board);
     const auto time_to_use = time_left/std::min(moves_left, double(moves_to_reset));
@@ -50,6 +50,13 @@ Clock::seconds Look_Ahead_Gene::time_to_examine(const Board& board, const Clock&
     return time_to_use < increment ? std::min(increment, time_left) : time_to_use;
 }
 
+size_t Look_Ahead_Gene::nodes_to_examine(const Board& board, const Clock& clock) const noexcept
+{
+    // The allowance for each move cannot be saved for later, so it is always used.
+    const auto game_nodes_left = double(clock.game_nodes_left(board.whose_turn()));
+    return size_t(game_nodes_left/expected_moves_left(board)) + clock.nodes_per_move();
+}
+
 void Look_Ahead_Gene::gene_specific_mutation() noexcept
 {
     switch(Random::random_integer(1, 6))
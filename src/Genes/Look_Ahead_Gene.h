@@ -31,17 +31,24 @@ class Look_Ahead_Gene : public Clonable_Gene<Look_Ahead_Gene>
         //! \returns The total time in seconds to spend on searching for a move.
         Clock::seconds time_to_examine(const Board& board, const Clock& clock) const noexcept;
 
+        //! \brief How many positions to search for the next move when the clock has a node budget.
+        //!
+        //! \param board The current board position.
+        //! \param clock The game clock. See Clock::node_budget().
+        //! \returns The number of positions to examine while searching for a move.
+        size_t nodes_to_examine(const Board& board, const Clock& clock) const noexcept;
+
         //! \brief When searching for a move, determine how much to overcommit on time.
         //!
         //! \param game_progress An estimate of how much of the game has been played (0.0 - 1.0).
-        //! With alpha-beta pruning, only a portion of a branch will be searched, so time
-        //! will be saved that can be spent on other branches. So, this factor controls
-        //! how much extra time to allocate knowing that not all of it will be used.
+        //! A deeper search is only started if it is expected to finish within the allocated
+        //! time multiplied by this factor.
         //! \returns A factor that gets multiplied by the allocated time to overallocate.
         double speculation_time_factor(double game_progress) const noexcept;
 
         //! \brief Returns an estimate of the number of moves in an average board position (i.e., the branching factor of the game tree).
         //!
+        //! This is used to predict how much longer a search one ply deeper will take.
         //! \param game_progress An estimate of how much of the game has been played (0.0 to 1.0).
         double branching_factor(double game_progress) const noexcept;
 
@@ -21,12 +21,11 @@ double Opponent_Pieces_Targeted_Gene::score_board(const Board& board, const Piec
     double score = 0.0;
     const auto values = piece_strength_source->piece_values();
 
-    for(const auto square : Square::all_squares())
+    for(const auto square : board.piece_squares(opposite(perspective)))
     {
-        const auto piece = board.piece_on_square(square);
-        if(piece && piece.color() != perspective && board.attacked_by(square, perspective))
+        if(board.attacked_by(square, perspective))
         {
-            score += values[std::to_underlying(piece.type())];
+            score += values[std::to_underlying(board.piece_on_square(square).type())];
         }
     }
 
@@ -1,6 +1,7 @@
 #include "Genes/Passed_Pawn_Gene.h"
 
 #include <array>
+#include <algorithm>
 
 #include "Genes/Gene.h"
 
@@ -14,41 +15,53 @@ Passed_Pawn_Gene::Passed_Pawn_Gene() noexcept : Clonable_Gene("Passed Pawn Gene"
 
 double Passed_Pawn_Gene::score_board(const Board& board, const Piece_Color perspective, size_t) const noexcept
 {
-    double score = 0.0;
-    const auto own_pawn = Piece{perspective, Piece_Type::PAWN};
-    const auto other_pawn = Piece{opposite(perspective), Piece_Type::PAWN};
-    const auto near_rank = (perspective == Piece_Color::WHITE ? 1 : 8);
-    const auto far_rank  = (perspective == Piece_Color::WHITE ? 7 : 2);
     const auto rank_step = (perspective == Piece_Color::WHITE ? 1 : -1);
-    auto other_pawn_ranks_occupied = std::array<int, 8>{};
 
-    for(char file = 'a'; file <= 'h'; ++file)
+    // For each file, the ranks of the opposing pawns that are farthest back and
+    // farthest forward from the perspective of the player (zero if there are none).
+    auto rearmost_other_pawn_rank = std::array<int, 8>{};
+    auto foremost_other_pawn_rank = std::array<int, 8>{};
+    for(const auto square : board.piece_squares(opposite(perspective), Piece_Type::PAWN))
     {
+        const auto file_index = size_t(square.file() - 'a');
+        auto& rearmost = rearmost_other_pawn_rank[file_index];
+        auto& foremost = foremost_other_pawn_rank[file_index];
+        if(rearmost == 0 || (rearmost - square.rank())*rank_step > 0)
+        {
+            rearmost = square.rank();
+        }
+        if(foremost == 0 || (square.rank() - foremost)*rank_step > 0)
+        {
+            foremost = square.rank();
+        }
+    }
+
+    double score = 0.0;
+    for(const auto square : board.piece_squares(perspective, Piece_Type::PAWN))
+    {
+        const auto file = square.file();
         const auto left_file  = std::max<char>('a', file - 1);
         const auto right_file = std::min<char>('h', file + 1);
         const auto score_diff = 1.0/(right_file - left_file + 1);
 
-        for(int rank = far_rank; rank != near_rank; rank -= rank_step)
+        score += 1.0;
+
+        // An opposing pawn on the file to the left that is not beside this pawn
+        if(left_file != file)
         {
-            const auto piece = board.piece_on_square({file, rank});
-            if(piece == own_pawn)
-            {
-                score += 1.0;
-
-                for(char pawn_file = left_file; pawn_file <= right_file; ++pawn_file)
-                {
-                    const auto other_pawn_rank = other_pawn_ranks_occupied[size_t(pawn_file - 'a')];
-                    if(other_pawn_rank != 0 && other_pawn_rank != rank)
-                    {
-                        score -= score_diff;
-                    }
-                }
-            }
-            else if(piece == other_pawn)
+            const auto other_pawn_rank = rearmost_other_pawn_rank[size_t(left_file - 'a')];
+            if(other_pawn_rank != 0 && other_pawn_rank != square.rank())
             {
-                other_pawn_ranks_occupied[size_t(file - 'a')] = rank;
+                score -= score_diff;
             }
         }
+
+        // An opposing pawn ahead on the same file
+        const auto other_pawn_rank = foremost_other_pawn_rank[size_t(file - 'a')];
+        if(other_pawn_rank != 0 && (other_pawn_rank - square.rank())*rank_step > 0)
+        {
+            score -= score_diff;
+        }
     }
 
     return score/8; // maximum score == 1
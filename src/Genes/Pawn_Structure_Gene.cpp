@@ -24,24 +24,21 @@ double Pawn_Structure_Gene::score_board(const Board& board, Piece_Color perspect
     const auto guard_direction = perspective == Piece_Color::WHITE ? -1 : 1;
 
     auto score = 0.0;
-    for(const auto square : Square::all_squares())
+    for(const auto square : board.piece_squares(perspective, Piece_Type::PAWN))
     {
-        if(board.piece_on_square(square) == pawn)
+        if(const auto guard0 = square + Square_Difference{1, guard_direction};
+           guard0.inside_board() && board.piece_on_square(guard0) == pawn)
         {
-            if(const auto guard0 = square + Square_Difference{1, guard_direction};
-               guard0.inside_board() && board.piece_on_square(guard0) == pawn)
-            {
-                score += guarded_by_pawn.value();
-            }
-            else if(const auto guard1 = square + Square_Difference{-1, guard_direction};
-                    guard1.inside_board() && board.piece_on_square(guard1) == pawn)
-            {
-                score += guarded_by_pawn.value();
-            }
-            else if(board.attacked_by(square, perspective))
-            {
-                score += guarded_by_piece.value();
-            }
+            score += guarded_by_pawn.value();
+        }
+        else if(const auto guard1 = square + Square_Difference{-1, guard_direction};
+                guard1.inside_board() && board.piece_on_square(guard1) == pawn)
+        {
+            score += guarded_by_pawn.value();
+        }
+        else if(board.attacked_by(square, perspective))
+        {
+            score += guarded_by_piece.value();
         }
     }
 
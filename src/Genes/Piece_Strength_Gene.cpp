@@ -5,6 +5,7 @@
 #include <map>
 #include <numeric>
 #include <utility>
+#include <algorithm>
 
 #include "Genes/Gene.h"
 #include "Game/Piece.h"
@@ -115,14 +116,17 @@ double Piece_Strength_Gene::score_board(const Board&, Piece_Color, size_t) const
 double Piece_Strength_Gene::game_progress(const Board& board) const noexcept
 {
     std::array<double, 2> piece_value_left{};
-    for(auto square : Square::all_squares())
+    for(const auto color : {Piece_Color::WHITE, Piece_Color::BLACK})
     {
-        if(const auto piece = board.piece_on_square(square))
+        for(size_t type_index = 0; type_index < piece_strength.size(); ++type_index)
         {
-            piece_value_left[std::to_underlying(piece.color())] += std::abs(piece_value(piece));
+            const auto type = static_cast<Piece_Type>(type_index);
+            piece_value_left[std::to_underlying(color)] += board.piece_count(color, type)*std::abs(piece_value(type));
         }
     }
 
+    // Summing by piece type can round the starting material to slightly more than 1.0,
+    // so keep the result from going negative, which would turn off every gene.
     const auto piece_score_left = std::min(piece_value_left[0], piece_value_left[1]);
-    return 1.0 - piece_score_left;
+    return std::max(0.0, 1.0 - piece_score_left);
 }
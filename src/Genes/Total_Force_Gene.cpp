@@ -1,6 +1,5 @@
 #include "Genes/Total_Force_Gene.h"
 
-#include <numeric>
 #include <cassert>
 
 #include "Game/Board.h"
@@ -19,19 +18,12 @@ double Total_Force_Gene::score_board(const Board& board, const Piece_Color persp
 {
     assert(piece_strength_source);
     const auto& values = piece_strength_source->piece_values();
-    return std::accumulate(Square::all_squares().begin(), Square::all_squares().end(), 0.0,
-                           [&values, &board, perspective](auto sum, auto square)
-                           {
-                               const auto piece = board.piece_on_square(square);
-                               if(piece && piece.color() == perspective)
-                               {
-                                   return sum + values[std::to_underlying(piece.type())];
-                               }
-                               else
-                               {
-                                   return sum;
-                               }
-                           });
+    auto score = 0.0;
+    for(size_t type_index = 0; type_index < values.size(); ++type_index)
+    {
+        score += board.piece_count(perspective, static_cast<Piece_Type>(type_index))*values[type_index];
+    }
+    return score;
 }
 
 void Total_Force_Gene::reset_piece_strength_gene(const Piece_Strength_Gene* const psg) noexcept
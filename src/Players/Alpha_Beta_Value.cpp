@@ -1,48 +1,30 @@
 #include "Players/Alpha_Beta_Value.h"
 
-#include <cmath>
-#include <utility>
-
-#include "Players/Game_Tree_Node_Result.h"
 #include "Game/Color.h"
-#include "Utility/Math.h"
+#include "Players/Score.h"
 
-Alpha_Beta_Value::Alpha_Beta_Value(const double score_in, const Piece_Color perspective_in, const size_t depth_in) noexcept :
+Alpha_Beta_Value::Alpha_Beta_Value(const Score score_in, const Piece_Color perspective_in) noexcept :
     score(score_in),
-    perspective(perspective_in),
-    variation_depth(depth_in)
-{
-}
-
-size_t Alpha_Beta_Value::depth() const noexcept
+    perspective(perspective_in)
 {
-    return variation_depth;
 }
 
 bool Alpha_Beta_Value::is_winning_for(const Piece_Color player_color) const noexcept
 {
-    return std::isinf(score) && ((score > 0) == (player_color == perspective));
+    return value(player_color).is_win();
 }
 
-std::pair<double, int> Alpha_Beta_Value::value(const Piece_Color player_color) const noexcept
+Score Alpha_Beta_Value::value(const Piece_Color player_color) const noexcept
 {
-    const auto this_score = perspective == player_color ? score : -score;
-    if(std::isinf(this_score))
-    {
-        return {this_score, -Math::sign(this_score)*int(depth())};
-    }
-    else
-    {
-        return {this_score, 0};
-    }
+    return perspective == player_color ? score : -score;
 }
 
 Alpha_Beta_Value Alpha_Beta_Value::alpha_start(Piece_Color perspective) noexcept
 {
-    return {Game_Tree_Node_Result::lose_score, perspective, 0};
+    return {Score::loss(0), perspective};
 }
 
 Alpha_Beta_Value Alpha_Beta_Value::beta_start(Piece_Color perspective) noexcept
 {
-    return {Game_Tree_Node_Result::win_score, perspective, 0};
+    return {Score::win(0), perspective};
 }
@@ -1,9 +1,8 @@
 #ifndef ALPHA_BETA_VALUE_H
 #define ALPHA_BETA_VALUE_H
 
-#include <utility>
-
 #include "Game/Color.h"
+#include "Players/Score.h"
 
 //! \brief A class for tracking Alpha and Beta values through a minimax search.
 //!
@@ -16,11 +15,7 @@ class Alpha_Beta_Value
         //!
         //! \param score_in The board score.
         //! \param perspective_in The player perspective from which the score is derived.
-        //! \param depth_in The depth of the search that produced the score.
-        Alpha_Beta_Value(double score_in, Piece_Color perspective_in, size_t depth_in) noexcept;
-
-        //! \brief The depth of search that created this value
-        size_t depth() const noexcept;
+        Alpha_Beta_Value(Score score_in, Piece_Color perspective_in) noexcept;
 
         //! \brief Does this value represent a winning position?
         //!
@@ -32,7 +27,7 @@ class Alpha_Beta_Value
         //! \param player_color The perspective from which to order values.
         //!
         //! See Game_Tree_Node_Result::value() for details
-        std::pair<double, int> value(Piece_Color player_color) const noexcept;
+        Score value(Piece_Color player_color) const noexcept;
 
         //! \brief Create a value for alpha at the beginning of a minimax search with alpha-beta pruning.
         //!
@@ -45,9 +40,8 @@ class Alpha_Beta_Value
         static Alpha_Beta_Value beta_start(Piece_Color perspective) noexcept;
 
     private:
-        double score;
+        Score score;
         Piece_Color perspective;
-        size_t variation_depth;
 };
 
 #endif // ALPHA_BETA_VALUE_H
@@ -0,0 +1,93 @@
+#include "Players/Calibration_Cache.h"
+
+#include <cstdint>
+#include <string>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <format>
+#include <print>
+#include <stdexcept>
+
+#include "Utility/String.h"
+
+void Calibration_Cache::use_file(const std::string& new_file_name) noexcept
+{
+    const auto lock = std::lock_guard(access);
+    file_name = new_file_name;
+    calibrations.clear();
+    if(file_name.empty())
+    {
+        return;
+    }
+
+    const auto platform = platform_fingerprint();
+    auto ifs = std::ifstream(file_name);
+    for(std::string line; std::getline(ifs, line);)
+    {
+        const auto fields = String::split(line);
+        try
+        {
+            if(fields.size() == 3 && String::to_number<uint64_t>(fields[1]) == platform)
+            {
+                calibrations.insert_or_assign(String::to_number<uint64_t>(fields[0]), String::to_number<double>(fields[2]));
+            }
+        }
+        catch(const std::invalid_argument&)
+        {
+            // A damaged line only means a genome has to be calibrated again.
+        }
+    }
+}
+
+std::optional<double> Calibration_Cache::find(const uint64_t genome_hash) const noexcept
+{
+    const auto lock = std::lock_guard(access);
+    const auto found = calibrations.find(genome_hash);
+    if(found == calibrations.end())
+    {
+        return {};
+    }
+
+    return found->second;
+}
+
+void Calibration_Cache::store(const uint64_t genome_hash, const double calibration) noexcept
+{
+    const auto lock = std::lock_guard(access);
+    if( ! calibrations.insert_or_assign(genome_hash, calibration).second || file_name.empty())
+    {
+        return;
+    }
+
+    auto ofs = std::ofstream(file_name, std::ios::app);
+    if(ofs)
+    {
+        std::println(ofs, "{} {} {}", genome_hash, platform_fingerprint(), calibration);
+    }
+}
+
+uint64_t Calibration_Cache::platform_fingerprint() noexcept
+{
+    auto platform = std::format("calibration version {}", calibration_version);
+#if defined(__VERSION__)
+    platform += " compiler " __VERSION__;
+#elif defined(_MSC_FULL_VER)
+    platform += std::format(" compiler MSVC {}", _MSC_FULL_VER);
+#endif
+#if defined(__x86_64__) || defined(_M_X64)
+    platform += " x86-64";
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    platform += " arm64";
+#endif
+#ifdef __FMA__
+    platform += " fma";
+#endif
+#ifdef __AVX2__
+    platform += " avx2";
+#endif
+#ifdef __AVX512F__
+    platform += " avx512";
+#endif
+    return String::hash(platform);
+}
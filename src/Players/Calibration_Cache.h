@@ -0,0 +1,60 @@
+#ifndef CALIBRATION_CACHE_H
+#define CALIBRATION_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <map>
+#include <mutex>
+#include <optional>
+
+//! \file
+
+//! \brief A record of the calibration results of genomes, saved to a file.
+//!
+//! Calibrating a Genetic_AI means evaluating many board positions, which dominates the
+//! time it takes to load an AI. Since the result only depends on the genes, it can be
+//! saved and reused whenever a genome with the same genes is loaded or created.
+//!
+//! Each line of the file holds the Genome::content_hash() of a genome, the
+//! platform_fingerprint() of the program that calibrated it, and the result. Lines from
+//! other platforms are ignored, so one file can be shared by different computers.
+//!
+//! The cache can be used by several threads at the same time.
+class Calibration_Cache
+{
+    public:
+        //! \brief Change this number whenever the calibration procedure changes so that old results are not used.
+        static constexpr int calibration_version = 2;
+
+        //! \brief Start using a different cache file.
+        //!
+        //! Results in the file from this platform are loaded and new results are appended to it.
+        //! \param file_name The name of the cache file. It does not need to exist yet. If the
+        //!        name is empty, results are only kept until the program exits.
+        void use_file(const std::string& file_name) noexcept;
+
+        //! \brief Look up the saved calibration of a genome.
+        //!
+        //! \param genome_hash The Genome::content_hash() of the genome.
+        std::optional<double> find(uint64_t genome_hash) const noexcept;
+
+        //! \brief Save the calibration of a genome.
+        //!
+        //! If the cache file cannot be written, the result is only kept until the program exits.
+        //! \param genome_hash The Genome::content_hash() of the genome.
+        //! \param calibration The result of the calibration.
+        void store(uint64_t genome_hash, double calibration) noexcept;
+
+        //! \brief An identifier for the compiler and processor instructions used to build this program.
+        //!
+        //! Floating-point arithmetic and the standard random number distributions may give
+        //! different results on different platforms, so results from elsewhere are not used.
+        static uint64_t platform_fingerprint() noexcept;
+
+    private:
+        std::string file_name;
+        std::map<uint64_t, double> calibrations;
+        mutable std::mutex access;
+};
+
+#endif // CALIBRATION_CACHE_H
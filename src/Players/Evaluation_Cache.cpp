@@ -0,0 +1,68 @@
+#include "Players/Evaluation_Cache.h"
+
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <bit>
+
+Evaluation_Cache::Evaluation_Cache(const Evaluation_Cache&) noexcept
+{
+}
+
+Evaluation_Cache& Evaluation_Cache::operator=(const Evaluation_Cache&) noexcept
+{
+    clear();
+    return *this;
+}
+
+void Evaluation_Cache::allocate() noexcept
+{
+    if( ! entries)
+    {
+        // Without enough memory, the cache stays empty and every probe misses.
+        entries.reset(new(std::nothrow) Entry[entry_count]());
+    }
+}
+
+void Evaluation_Cache::clear() noexcept
+{
+    entries.reset();
+}
+
+std::optional<double> Evaluation_Cache::probe(const uint64_t key) const noexcept
+{
+    // An empty entry would match a key of zero.
+    if( ! entries || key == 0)
+    {
+        return {};
+    }
+
+    const auto& entry = entry_for(key);
+    const auto score = entry.score.load(std::memory_order_relaxed);
+    if((entry.checked_key.load(std::memory_order_relaxed) ^ score) == key)
+    {
+        return std::bit_cast<double>(score);
+    }
+
+    return {};
+}
+
+void Evaluation_Cache::store(const uint64_t key, const double score) noexcept
+{
+    if( ! entries || key == 0)
+    {
+        return;
+    }
+
+    auto& entry = entry_for(key);
+    const auto score_bits = std::bit_cast<uint64_t>(score);
+    entry.checked_key.store(key ^ score_bits, std::memory_order_relaxed);
+    entry.score.store(score_bits, std::memory_order_relaxed);
+}
+
+Evaluation_Cache::Entry& Evaluation_Cache::entry_for(const uint64_t key) const noexcept
+{
+    static_assert(std::has_single_bit(entry_count), "Evaluation cache size must be a power of two.");
+    return entries[key & (entry_count - 1)];
+}
@@ -0,0 +1,82 @@
+#ifndef EVALUATION_CACHE_H
+#define EVALUATION_CACHE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <atomic>
+#include <optional>
+
+//! \file
+
+//! \brief A cache of board evaluations keyed by position.
+//!
+//! The cache is direct-mapped: each position can only be stored in the one entry picked
+//! by its key, and a new evaluation always replaces the old one.
+//!
+//! As in the Transposition_Table, each entry is stored as two 64-bit words: the score
+//! and the key XOR'd with the score. Threads can share the cache without locks because
+//! a torn write fails the key check when read.
+//!
+//! Memory for the cache is not allocated until allocate() is called, and copies of a
+//! cache start empty.
+class Evaluation_Cache
+{
+    public:
+        //! \brief The number of entries in the cache.
+        static constexpr size_t entry_count = size_t{1} << 16;
+
+        //! \brief Hit and miss counts for reporting the effectiveness of the cache.
+        struct Statistics
+        {
+            //! \brief The number of evaluations found in the cache.
+            size_t hits = 0;
+
+            //! \brief The number of evaluations not found in the cache.
+            size_t misses = 0;
+        };
+
+        //! \brief Create an empty cache.
+        Evaluation_Cache() noexcept = default;
+
+        //! \brief Create an empty cache. Nothing is copied.
+        Evaluation_Cache(const Evaluation_Cache& other) noexcept;
+
+        //! \brief Delete all entries and release the cache's memory. Nothing is copied.
+        Evaluation_Cache& operator=(const Evaluation_Cache& other) noexcept;
+
+        //! \brief Allocate memory for the cache if it has not been already.
+        //!
+        //! This should not be called while other threads are using the cache.
+        void allocate() noexcept;
+
+        //! \brief Delete all entries and release the cache's memory.
+        //!
+        //! This should not be called while other threads are using the cache.
+        void clear() noexcept;
+
+        //! \brief Look up the evaluation of a board position.
+        //!
+        //! \param key The Zobrist hash of the position from Board::board_hash(), which includes the side to move.
+        //! \returns The stored score, if any.
+        std::optional<double> probe(uint64_t key) const noexcept;
+
+        //! \brief Store the evaluation of a board position.
+        //!
+        //! \param key The Zobrist hash of the position from Board::board_hash(), which includes the side to move.
+        //! \param score The evaluation of the position.
+        void store(uint64_t key, double score) noexcept;
+
+    private:
+        struct Entry
+        {
+            std::atomic<uint64_t> checked_key{0};
+            std::atomic<uint64_t> score{0};
+        };
+
+        std::unique_ptr<Entry[]> entries;
+
+        Entry& entry_for(uint64_t key) const noexcept;
+};
+
+#endif // EVALUATION_CACHE_H
@@ -11,14 +11,25 @@ using namespace std::chrono_literals;
 #include <fstream>
 #include <print>
 #include <format>
+#include <optional>
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <utility>
 
 #include "Players/Game_Tree_Node_Result.h"
 #include "Players/Alpha_Beta_Value.h"
 #include "Players/Thinking.h"
+#include "Players/Transposition_Table.h"
+#include "Players/Calibration_Cache.h"
 #include "Game/Board.h"
 #include "Game/Clock.h"
 #include "Game/Game_Result.h"
 #include "Game/Move.h"
+#include "Game/Move_Generator.h"
+#include "Game/Position_History.h"
 
 #include "Utility/String.h"
 #include "Utility/Random.h"
@@ -26,9 +37,22 @@ using namespace std::chrono_literals;
 #include "Utility/Math.h"
 #include "Utility/Exceptions.h"
 #include "Utility/Algorithm.h"
+#include "Utility/Thread_Pool.h"
 
 namespace
 {
+    //! \brief The calibration results shared by all Genetic_AIs.
+    Calibration_Cache& calibration_cache() noexcept;
+
+    //! \brief Create a board position for calibrating the value of a centipawn.
+    //!
+    //! \param index Each index gives a different board position, and the same index always
+    //!        gives the same position.
+    //! \param history The record of positions used by both returned boards.
+    //! \returns A position after 40 random moves that has pawns on the board and the same
+    //!          position with a random pawn removed.
+    std::pair<Board, Board> calibration_position(size_t index, Position_History& history) noexcept;
+
     //! \brief Create a PGN variation string.
     //!
     //! \param board The board state just before any of the variation moves are played.
@@ -64,11 +88,21 @@ Genetic_AI::Genetic_AI(std::istream&& is, int id) : Genetic_AI(is, id)
 {
 }
 
-Genetic_AI::Genetic_AI(const Genetic_AI& a, const Genetic_AI& b) noexcept : genome(a.genome, b.genome)
+Genetic_AI::Genetic_AI(const Genetic_AI& a, const Genetic_AI& b) noexcept :
+    genome(a.genome, b.genome),
+    transposition_table(a.transposition_table)
 {
     recalibrate_self();
 }
 
+Genetic_AI::Genetic_AI(const Genetic_AI& a, const Genetic_AI& b, const int id, const size_t mutation_rate) noexcept :
+    genome(a.genome, b.genome, id),
+    transposition_table(a.transposition_table)
+{
+    genome.mutate(mutation_rate);
+    recalibrate_self();
+}
+
 std::string Genetic_AI::name() const noexcept
 {
     return genome.name();
@@ -84,34 +118,275 @@ int Genetic_AI::id() const noexcept
     return genome.id();
 }
 
+//! \brief A search started by Genetic_AI::ponder() that runs on its own thread.
+struct Genetic_AI::Ponder_Search
+{
+    //! \brief Prepare to search a position. The search starts when a worker thread is assigned.
+    //!
+    //! \param board_in The position to search.
+    explicit Ponder_Search(const Board& board_in) noexcept : board(board_in)
+    {
+        // The game's board will have moves played on it while this search runs.
+        board.use_position_history(history);
+    }
+
+    //! \brief Stop the search and wait for the worker thread to finish.
+    ~Ponder_Search()
+    {
+        control.stopped = true;
+    }
+
+    Position_History history;
+    Board board;
+    Search_Control control;
+
+    // Declared last so that the thread is joined before the data it uses is destroyed.
+    std::jthread worker;
+};
+
 const Move& Genetic_AI::choose_move(const Board& board, const Clock& clock) const noexcept
 {
+    if(ponder_search.search)
+    {
+        auto& search = *ponder_search.search;
+        if(search.board.board_hash() == board.board_hash() && search.board.played_ply_count() == board.played_ply_count())
+        {
+            // The opponent played the expected move, so the search continues with time limits.
+            search.control.pondering = false;
+            search.worker.join();
+            const auto& move = report_chosen_move(board, search.control);
+            ponder_search.search.reset();
+            return move;
+        }
+
+        stop_pondering();
+    }
+
+    reset_search_stats(board);
+    Search_Control control;
+    choose_move_minimax(board, clock, control);
+    return report_chosen_move(board, control);
+}
+
+void Genetic_AI::ponder(const Board& board, const Clock& clock) const noexcept
+{
+    stop_pondering();
+    if(board.no_legal_moves())
+    {
+        return;
+    }
+
     reset_search_stats(board);
-    return choose_move_minimax(board, clock);
+
+    // The opponent's thinking time is not counted against this player.
+    auto ponder_clock = clock;
+    ponder_clock.stop();
+
+    ponder_search.search = std::make_unique<Ponder_Search>(board);
+    auto& search = *ponder_search.search;
+    search.control.pondering = true;
+    search.worker = std::jthread([this, &search, ponder_clock]()
+                                 {
+                                     choose_move_minimax(search.board, ponder_clock, search.control);
+                                 });
 }
 
-const Move& Genetic_AI::choose_move_minimax(const Board& board, const Clock& clock) const noexcept
+void Genetic_AI::stop_pondering() const noexcept
 {
-    auto principal_variation = get_legal_principal_variation(board);
+    ponder_search.search.reset();
+}
+
+const Move* Genetic_AI::expected_response(const Board& board) const noexcept
+{
+    if(commentary.empty())
+    {
+        return nullptr;
+    }
+
+    const auto& variation = commentary.back().variation_line();
+    if(variation.size() < 2 || variation.front() != board.last_move() || ! board.is_in_legal_moves_list(*variation[1]))
+    {
+        return nullptr;
+    }
+
+    return variation[1];
+}
+
+void Genetic_AI::choose_move_minimax(const Board& board, const Clock& clock, Search_Control& control) const noexcept
+{
+    const auto principal_variation = get_legal_principal_variation(board);
     const auto progress_of_game = game_progress(board);
-    const auto time_to_use = time_to_examine(board, clock);
-    const auto minimum_search_depth = size_t(std::log(time_to_use/node_evaluation_time)/std::log(branching_factor(progress_of_game)));
+    const auto soft_time_limit = time_to_examine(board, clock)*speculation_time_factor(progress_of_game);
+    const auto soft_node_limit = clock.limits_nodes() ? size_t(double(nodes_to_examine(board, clock))*speculation_time_factor(progress_of_game)) : size_t{0};
+
+    control.start_time = std::chrono::steady_clock::now();
+    control.timing_start_time = clock.time_reading();
+    control.timing_started = ! control.pondering;
+    control.time_limit = std::min(hard_time_limit_factor*soft_time_limit, clock.time_left(board.whose_turn()));
+    if(clock.limits_nodes())
+    {
+        const auto nodes_left = clock.nodes_left(board.whose_turn());
+        const auto node_safety_margin = std::min(nodes_left, search_thread_count*nodes_between_limit_checks);
+        control.node_limit = std::min(size_t(hard_time_limit_factor*double(soft_node_limit)), nodes_left - node_safety_margin);
+    }
+    for(size_t index = 0; index < search_thread_count; ++index)
+    {
+        control.threads.emplace_back(control, index);
+    }
+
+    // Each thread needs its own board and record of repeated positions.
+    auto search_boards = std::vector<Board>(search_thread_count, board);
+    auto helper_histories = std::vector<Position_History>(search_thread_count - 1);
+    for(size_t index = 1; index < search_thread_count; ++index)
+    {
+        search_boards[index].use_position_history(helper_histories[index - 1]);
+    }
+
+    {
+        std::vector<std::jthread> helpers;
+        for(size_t index = 1; index < search_thread_count; ++index)
+        {
+            helpers.emplace_back([&, index]()
+                                 {
+                                     iterative_deepening_search(search_boards[index], clock, progress_of_game, soft_time_limit, soft_node_limit, principal_variation, control.threads[index]);
+                                 });
+        }
+
+        iterative_deepening_search(search_boards.front(), clock, progress_of_game, soft_time_limit, soft_node_limit, principal_variation, control.threads.front());
+        control.stopped = true;
+    }
+}
+
+const Move& Genetic_AI::report_chosen_move(const Board& board, const Search_Control& control) const noexcept
+{
+    // Use the deepest completed search, preferring the main thread.
+    const auto& chosen_thread = *std::ranges::max_element(control.threads, {}, &Search_Thread::completed_depth);
+    nodes_searched_last_move = control.nodes_searched();
+    evaluation_cache_statistics_last_move = control.evaluation_cache_statistics();
+    report_final_search_stats(chosen_thread, board);
+
+    return *chosen_thread.result->variation_line().front();
+}
+
+void Genetic_AI::iterative_deepening_search(Board& board,
+                                            const Clock& clock,
+                                            const double progress_of_game,
+                                            const Clock::seconds soft_time_limit,
+                                            const size_t soft_node_limit,
+                                            std::vector<const Move*> principal_variation,
+                                            Search_Thread& thread) const noexcept
+{
+    // Half of the helper threads search one ply deeper than the main thread so that
+    // the threads explore different parts of the game tree.
+    const auto first_depth = size_t{1} + thread.index % 2;
+    for(thread.search_depth = first_depth; true; ++thread.search_depth)
+    {
+        const auto iteration_start_time = clock.time_reading();
+        const auto iteration_start_nodes = thread.control.nodes_searched();
+        auto iteration_result = search_with_aspiration_window(board, clock, progress_of_game, principal_variation, thread);
+        if(thread.control.stopped)
+        {
+            // An interrupted search is only used if no search finished.
+            if(thread.result)
+            {
+                thread.search_depth = thread.completed_depth;
+            }
+            else
+            {
+                thread.result = iteration_result;
+            }
+            break;
+        }
 
-    current_variation_store current_variation;
-    auto result = search_game_tree(board,
-                                   time_to_use,
-                                   minimum_search_depth,
-                                   maximum_variation_depth,
-                                   clock,
-                                   progress_of_game,
-                                   Alpha_Beta_Value::alpha_start(board.whose_turn()),
-                                   Alpha_Beta_Value::beta_start(board.whose_turn()),
-                                   principal_variation,
-                                   current_variation);
+        thread.result = iteration_result;
+        thread.completed_depth = thread.search_depth;
+        if(thread.result->is_winning_for(board.whose_turn()) ||
+           thread.result->is_losing_for(board.whose_turn()) ||
+           thread.search_depth == maximum_variation_depth)
+        {
+            break;
+        }
 
-    report_final_search_stats(result, board);
+        // The first two items of a principal variation are the moves that led to the current board.
+        principal_variation = {nullptr, nullptr};
+        principal_variation.insert(principal_variation.end(), thread.result->variation_line().begin(), thread.result->variation_line().end());
 
-    return *result.variation_line().front();
+        if(thread.is_main_thread())
+        {
+            // Only start another iteration if it is expected to finish in time.
+            if(thread.control.is_timed(clock))
+            {
+                if(thread.control.node_limit)
+                {
+                    const auto nodes_searched = thread.control.nodes_searched();
+                    const auto next_iteration_nodes = double(nodes_searched - iteration_start_nodes)*branching_factor(progress_of_game);
+                    if(double(thread.control.nodes_searched_since_timing_start()) + next_iteration_nodes > double(soft_node_limit))
+                    {
+                        break;
+                    }
+                }
+                else
+                {
+                    const auto now = clock.time_reading();
+                    const auto next_iteration_time = (now - iteration_start_time)*branching_factor(progress_of_game);
+                    if((now - thread.control.timing_start_time) + next_iteration_time > soft_time_limit)
+                    {
+                        break;
+                    }
+                }
+            }
+
+            output_thinking(*thread.result, board.whose_turn(), thread);
+        }
+    }
+}
+
+Game_Tree_Node_Result Genetic_AI::search_with_aspiration_window(Board& board,
+                                                                const Clock& clock,
+                                                                const double progress_of_game,
+                                                                const std::vector<const Move*>& principal_variation,
+                                                                Search_Thread& thread) const noexcept
+{
+    const auto perspective = board.whose_turn();
+    const auto& previous_result = thread.result;
+    const auto full_window = ! previous_result || previous_result->value(perspective).is_checkmate();
+    const auto expected_score = full_window ? 0 : previous_result->value(perspective).centipawns();
+    auto alpha_width = aspiration_window_centipawns;
+    auto beta_width = alpha_width;
+    while(true)
+    {
+        const auto alpha = full_window || alpha_width > maximum_aspiration_window_centipawns ?
+                               Alpha_Beta_Value::alpha_start(perspective) :
+                               Alpha_Beta_Value{Score::from_centipawns(expected_score - alpha_width), perspective};
+        const auto beta = full_window || beta_width > maximum_aspiration_window_centipawns ?
+                              Alpha_Beta_Value::beta_start(perspective) :
+                              Alpha_Beta_Value{Score::from_centipawns(expected_score + beta_width), perspective};
+
+        current_variation_store current_variation;
+        auto search_principal_variation = principal_variation;
+        const auto search_result = search_game_tree(board, clock, progress_of_game, alpha, beta, search_principal_variation, current_variation, thread);
+        const auto result = Game_Tree_Node_Result{search_result.value(perspective),
+                                                  perspective,
+                                                  thread.line_from_root(0, current_variation)};
+        if(thread.control.stopped)
+        {
+            return result;
+        }
+
+        // If the score is outside the window, search again with a wider window on that side.
+        if(result.value(perspective) <= alpha.value(perspective) && ! result.is_losing_for(perspective) && ! alpha.value(perspective).is_checkmate())
+        {
+            alpha_width *= aspiration_window_growth;
+        }
+        else if(result.value(perspective) >= beta.value(perspective) && ! result.is_winning_for(perspective) && ! beta.value(perspective).is_checkmate())
+        {
+            beta_width *= aspiration_window_growth;
+        }
+        else
+        {
+            return result;
+        }
+    }
 }
 
 std::vector<const Move*> Genetic_AI::get_legal_principal_variation(const Board& board) const noexcept
@@ -147,16 +422,23 @@ std::vector<const Move*> Genetic_AI::get_legal_principal_variation(const Board&
     return principal_variation;
 }
 
-void Genetic_AI::report_final_search_stats(const Game_Tree_Node_Result& result, const Board& board) const noexcept
+void Genetic_AI::report_final_search_stats(const Search_Thread& thread, const Board& board) const noexcept
 {
-    output_thinking(result, board.whose_turn());
+    output_thinking(*thread.result, board.whose_turn(), thread);
 
-    commentary.push_back(result);
-
-    if(nodes_evaluated > 0)
+    const auto format = thinking_mode();
+    const auto& cache_statistics = evaluation_cache_statistics_last_move;
+    if(format == Thinking_Output_Type::XBOARD)
     {
-        node_evaluation_time = total_evaluation_time/nodes_evaluated;
+        std::println("# evaluation cache hits {} misses {}", cache_statistics.hits, cache_statistics.misses);
     }
+    else if(format == Thinking_Output_Type::UCI)
+    {
+        std::println("info string evaluation cache hits {} misses {}", cache_statistics.hits, cache_statistics.misses);
+    }
+    std::cout.flush();
+
+    commentary.push_back(*thread.result);
 }
 
 void Genetic_AI::reset_search_stats(const Board& board) const noexcept
@@ -172,76 +454,99 @@ void Genetic_AI::reset_search_stats(const Board& board) const noexcept
         commentary.emplace_back();
     }
 
-    nodes_searched = 0;
-    clock_start_time = std::chrono::steady_clock::now();
-    maximum_depth = 0;
+    transposition_table.start_search();
+    evaluation_cache.allocate();
 
-    nodes_evaluated = 0;
-    total_evaluation_time = 0.0s;
+    nodes_searched_last_move = 0;
+    evaluation_cache_statistics_last_move = {};
     time_at_last_output = std::chrono::steady_clock::now();
 }
 
-Game_Tree_Node_Result Genetic_AI::search_game_tree(const Board& board,
-                                                   const Clock::seconds time_to_examine,
-                                                   const size_t minimum_search_depth,
-                                                   const size_t maximum_search_depth,
+Game_Tree_Node_Result Genetic_AI::search_game_tree(Board& board,
                                                    const Clock& clock,
                                                    const double progress_of_game,
                                                    Alpha_Beta_Value alpha,
                                                    const Alpha_Beta_Value& beta,
                                                    std::vector<const Move*>& principal_variation,
-                                                   current_variation_store& current_variation) const noexcept
+                                                   current_variation_store& current_variation,
+                                                   Search_Thread& thread) const noexcept
 {
-    const auto time_end = std::chrono::steady_clock::now() + time_to_examine;
-    const auto depth = current_variation.size() + 1;
-    maximum_depth = std::max(maximum_depth, depth);
-    auto all_legal_moves = board.legal_moves();
+    const auto ply = current_variation.size();
+    const auto depth = ply + 1;
+    const auto draft = thread.search_depth + 1 - depth;
+    thread.maximum_depth = std::max(thread.maximum_depth, depth);
+    const auto perspective = board.whose_turn();
 
     // The first two items in the principal variation are the last two moves of
     // the non-hypothetical board. So, the first item in the principal variation to
     // consider is at index depth + 1 (since depth starts at 1).
-    if(principal_variation.size() > depth + 1)
+    const auto following_principal_variation = principal_variation.size() > depth + 1;
+    if( ! following_principal_variation)
     {
-        const auto next_principal_variation_move = principal_variation[depth + 1];
-        const auto move_iter = std::ranges::find(all_legal_moves, next_principal_variation_move);
+        principal_variation.clear();
+    }
 
-        assert(move_iter != all_legal_moves.end());
+    // Consider the principal variation move first to allow the most pruning later.
+    // Otherwise, the best move from an earlier search of this position goes first.
+    const auto stored_result = transposition_table.probe(board.board_hash());
+    const auto first_move = following_principal_variation ? principal_variation[depth + 1] : stored_result ? stored_result->best_move : nullptr;
+    auto move_generator = Move_Generator(board, first_move);
+    assert( ! following_principal_variation || move_generator.legal_hash_move());
 
-        // Put principal variation move at start of list to allow
-        // the most pruning later.
-        std::iter_swap(all_legal_moves.begin(), move_iter);
-    }
-    else
+    if(stored_result && ! current_variation.empty() && ! following_principal_variation && ! stored_result->score.is_checkmate())
     {
-        principal_variation.clear();
+        // Use the stored result if it came from a search at least as deep as this one
+        // and its score is outside the alpha-beta window (or is exact).
+        const auto stored_value = Alpha_Beta_Value{stored_result->score, perspective};
+        if(stored_result->draft >= draft &&
+           (stored_result->bound == Score_Bound::EXACT ||
+            (stored_result->bound == Score_Bound::LOWER && stored_value.value(perspective) >= beta.value(perspective)) ||
+            (stored_result->bound == Score_Bound::UPPER && stored_value.value(perspective) <= alpha.value(perspective))))
+        {
+            auto& best_line = thread.best_lines[ply];
+            best_line.clear();
+            if(const auto hash_move = move_generator.legal_hash_move())
+            {
+                best_line.push_back(hash_move);
+            }
+            return {stored_result->score, perspective};
+        }
     }
 
-    // Consider principal variation move first, if any.
-    const auto partition_start = std::next(all_legal_moves.begin(), principal_variation.empty() ? 0 : 1);
-    sort_moves(partition_start, all_legal_moves.end(), board, progress_of_game);
+    // Captures are generated and sorted only after the first move is searched, and quiet
+    // moves only after the captures.
+    const auto sort_stage = [this, &board, progress_of_game](const auto begin, const auto end)
+                            {
+                                sort_moves(begin, end, board, progress_of_game);
+                            };
 
-    const auto perspective = board.whose_turn();
-    Game_Tree_Node_Result best_result = {Game_Tree_Node_Result::lose_score,
-                                         perspective,
-                                         {current_variation.empty() ? all_legal_moves.front() : current_variation.front()}};
+    const auto original_alpha = alpha;
+    Game_Tree_Node_Result best_result = {Score::loss(1), perspective};
+    thread.best_lines[ply].clear();
 
-    auto moves_left = all_legal_moves.size();
-    for(const auto move : all_legal_moves)
+    Board::Undo_Record undo;
+    while(const auto move = move_generator.next(sort_stage))
     {
-        const auto evaluate_start_time = std::chrono::steady_clock::now();
-        ++nodes_searched;
+        if(current_variation.empty() && thread.best_lines[ply].empty())
+        {
+            // Have a move ready at the root in case the search stops before any move is scored.
+            thread.best_lines[ply].push_back(move);
+        }
+
+        thread.add_nodes(1);
 
         const auto variation_guard = Algorithm::scoped_push_back(current_variation, move);
-        auto next_board = board;
-        auto move_result = next_board.play_move(*move);
+        auto move_result = board.make_move(*move, undo);
 
         if(move_result.winner() != Winner_Color::NONE)
         {
             // This move results in checkmate, no other move can be better.
-            best_result = evaluate(move_result, next_board, current_variation, perspective, evaluate_start_time);
+            best_result = evaluate(move_result, board, current_variation, perspective, thread);
+            thread.update_best_line(ply, move);
+            board.unmake_move(undo);
             break;
         }
-        else if(next_board.repeat_count_from_depth(depth) >= 2)
+        else if(board.repeat_count_from_depth(depth) >= 2)
         {
             // This move repeats a searched position. If this is the best line,
             // then searching further will find this position again, resulting
@@ -249,7 +554,7 @@ Game_Tree_Node_Result Genetic_AI::search_game_tree(const Board& board,
             move_result = Game_Result(Winner_Color::NONE, Game_Result_Type::THREEFOLD_REPETITION);
         }
 
-        if(alpha.depth() <= depth + 2 && alpha.is_winning_for(perspective))
+        if(alpha.value(perspective) >= Score::win(depth + 2))
         {
             // This move will take a longer path to victory
             // than one already found. Use "depth + 2" since,
@@ -257,20 +562,19 @@ Game_Tree_Node_Result Genetic_AI::search_game_tree(const Board& board,
             // we're here), then the earliest move that can
             // win is the next one, which is two away (after
             // opponent's move).
+            board.unmake_move(undo);
             continue;
         }
 
-        const auto time_left = Clock::seconds(time_end - std::chrono::steady_clock::now());
-        const auto time_allotted_for_this_move = std::min(time_left*speculation_time_factor(game_progress(next_board)),
-                                                          clock.running_time_left())/(moves_left--);
-
-        const auto result = search_further(move_result, depth, next_board, principal_variation, minimum_search_depth, maximum_search_depth, time_allotted_for_this_move) ?
-            search_game_tree(next_board, time_allotted_for_this_move, minimum_search_depth, maximum_search_depth, clock, progress_of_game, beta, alpha, principal_variation, current_variation) :
-            evaluate(move_result, next_board, current_variation, perspective, evaluate_start_time);
+        const auto result = search_further(move_result, depth, thread) ?
+            search_game_tree(board, clock, progress_of_game, beta, alpha, principal_variation, current_variation, thread) :
+            evaluate(move_result, board, current_variation, perspective, thread);
+        board.unmake_move(undo);
 
         if(result.value(perspective) > best_result.value(perspective))
         {
             best_result = result;
+            thread.update_best_line(ply, move);
             if(best_result.value(perspective) > alpha.value(perspective))
             {
                 alpha = best_result.alpha_beta_value();
@@ -278,135 +582,208 @@ Game_Tree_Node_Result Genetic_AI::search_game_tree(const Board& board,
                 {
                     break;
                 }
-                else if(time_since_last_output() > 1s)
+                else if(thread.is_main_thread() && time_since_last_output() > 1s)
                 {
-                    output_thinking(best_result,
-                                    depth % 2 == 1 ? perspective : opposite(perspective));
+                    output_thinking({best_result.value(perspective), perspective, thread.line_from_root(ply, current_variation)},
+                                    depth % 2 == 1 ? perspective : opposite(perspective),
+                                    thread);
                 }
             }
         }
 
         principal_variation.clear(); // only the first move is part of the principal variation
 
-        if(clock.running_time_left() < 0.0s || must_pick_move_now())
+        if(search_must_stop(clock, thread))
         {
             break;
         }
     }
 
+    if( ! thread.control.stopped)
+    {
+        const auto bound = best_result.value(perspective) >= beta.value(perspective) ? Score_Bound::LOWER :
+                           best_result.value(perspective) <= original_alpha.value(perspective) ? Score_Bound::UPPER :
+                           Score_Bound::EXACT;
+        const auto& best_line = thread.best_lines[ply];
+        const auto best_move = best_line.empty() ? nullptr : best_line.front();
+        transposition_table.store(board.board_hash(), {best_result.value(perspective), bound, draft, best_move});
+    }
+
     return best_result;
 }
 
-Game_Tree_Node_Result Genetic_AI::evaluate(const Game_Result& move_result,
-                                           Board& next_board,
-                                           Genetic_AI::current_variation_store& current_variation,
-                                           const Piece_Color perspective,
-                                           const std::chrono::steady_clock::time_point evaluate_start_time) const noexcept
+bool Genetic_AI::search_must_stop(const Clock& clock, const Search_Thread& thread) const noexcept
 {
-    struct [[nodiscard]] evaluate_time_guard
+    auto& control = thread.control;
+    if( ! control.stopped.load(std::memory_order_relaxed) && thread.is_main_thread() && control.is_timed(clock))
     {
-        Clock::seconds& evaluation_time_total;
-        const std::chrono::steady_clock::time_point evaluation_start_time;
-
-        evaluate_time_guard(Clock::seconds& evaluation_time, std::chrono::steady_clock::time_point evaluation_time_start) noexcept :
-            evaluation_time_total(evaluation_time),
-            evaluation_start_time(evaluation_time_start)
+        const auto out_of_time = control.node_limit ?
+                                 control.nodes_searched_since_timing_start() >= *control.node_limit :
+                                 (clock.time_reading() - control.timing_start_time > control.time_limit ||
+                                  clock.running_time_left() < 0.0s);
+        if(out_of_time || must_pick_move_now())
         {
+            control.stopped = true;
         }
-        ~evaluate_time_guard() noexcept { evaluation_time_total += std::chrono::steady_clock::now() - evaluation_start_time; }
-    };
-    const auto guard = evaluate_time_guard{total_evaluation_time, evaluate_start_time};
-
-    const auto quiescent_moves = move_result.game_has_ended() ? std::vector<const Move*>{} : next_board.quiescent(piece_values());
-    for(auto quiescent_move : quiescent_moves)
-    {
-        next_board.play_move(*quiescent_move);
     }
-    const auto quiescent_guard = Algorithm::scoped_push_back(current_variation, quiescent_moves.begin(), quiescent_moves.end());
-    nodes_searched += quiescent_moves.size();
-    ++nodes_evaluated;
-    return create_result(next_board, perspective, move_result, current_variation);
+
+    return control.stopped.load(std::memory_order_relaxed);
 }
 
-bool Genetic_AI::search_further(const Game_Result& move_result,
-                                const size_t depth,
-                                const Board& next_board,
-                                const std::vector<const Move*>& principal_variation,
-                                const size_t minimum_search_depth,
-                                const size_t maximum_search_depth,
-                                const Clock::seconds time_allotted_for_this_move) const noexcept
+bool Genetic_AI::Search_Control::is_timed(const Clock& clock) noexcept
 {
-    if(move_result.game_has_ended())
+    if( ! timing_started && ! pondering.load(std::memory_order_relaxed))
     {
-        return false;
+        timing_started = true;
+        timing_start_time = clock.time_reading();
+        timing_start_nodes = nodes_searched();
     }
-    else if(depth >= maximum_search_depth)
-    {
-        return false;
-    }
-    else if( ! principal_variation.empty())
+
+    return timing_started;
+}
+
+size_t Genetic_AI::Search_Control::nodes_searched() const noexcept
+{
+    return std::accumulate(threads.begin(), threads.end(), size_t{0},
+                           [](const auto sum, const auto& thread)
+                           {
+                               return sum + thread.nodes_searched.load(std::memory_order_relaxed);
+                           });
+}
+
+size_t Genetic_AI::Search_Control::nodes_searched_since_timing_start() const noexcept
+{
+    return nodes_searched() - timing_start_nodes;
+}
+
+Evaluation_Cache::Statistics Genetic_AI::Search_Control::evaluation_cache_statistics() const noexcept
+{
+    Evaluation_Cache::Statistics total;
+    for(const auto& thread : threads)
     {
-        return true;
+        total.hits += thread.evaluation_cache_statistics.hits;
+        total.misses += thread.evaluation_cache_statistics.misses;
     }
-    else if(depth < minimum_search_depth)
+    return total;
+}
+
+Genetic_AI::Search_Thread::Search_Thread(Search_Control& control_in, const size_t index_in) noexcept :
+    control(control_in),
+    index(index_in)
+{
+}
+
+bool Genetic_AI::Search_Thread::is_main_thread() const noexcept
+{
+    return index == 0;
+}
+
+void Genetic_AI::Search_Thread::add_nodes(const size_t count) noexcept
+{
+    nodes_searched.store(nodes_searched.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+}
+
+void Genetic_AI::Search_Thread::update_best_line(const size_t ply, const Move* const move) noexcept
+{
+    auto& best_line = best_lines[ply];
+    best_line.clear();
+    best_line.push_back(move);
+    if(ply + 1 < best_lines.size())
     {
-        return true;
+        const auto& next_line = best_lines[ply + 1];
+        best_line.insert(best_line.end(), next_line.begin(), next_line.end());
     }
-    else if(next_board.king_is_in_check())
+}
+
+std::vector<const Move*> Genetic_AI::Search_Thread::line_from_root(const size_t ply, const current_variation_store& current_variation) const noexcept
+{
+    auto line = std::vector<const Move*>(current_variation.begin(), std::next(current_variation.begin(), ply));
+    line.insert(line.end(), best_lines[ply].begin(), best_lines[ply].end());
+    return line;
+}
+
+Game_Tree_Node_Result Genetic_AI::evaluate(const Game_Result& move_result,
+                                           Board& next_board,
+                                           Genetic_AI::current_variation_store& current_variation,
+                                           const Piece_Color perspective,
+                                           Search_Thread& thread) const noexcept
+{
+    const auto ply = current_variation.size();
+    const auto quiescent_moves = move_result.game_has_ended() ? Board::quiescent_move_list{} : next_board.quiescent(piece_values());
+    Fixed_Capacity_Vector<Board::Undo_Record, maximum_quiescent_captures> quiescent_undo_records;
+    for(auto quiescent_move : quiescent_moves)
     {
-        return true;
+        quiescent_undo_records.push_back({});
+        next_board.make_move(*quiescent_move, quiescent_undo_records.back());
     }
-    else
+    const auto quiescent_guard = Algorithm::scoped_push_back(current_variation, quiescent_moves.begin(), quiescent_moves.end());
+    thread.add_nodes(quiescent_moves.size());
+    thread.maximum_depth = std::max(thread.maximum_depth, current_variation.size());
+    const auto result = create_result(next_board, perspective, move_result, current_variation, thread.evaluation_cache_statistics);
+
+    // The line from a leaf of the search is the series of captures that leads to a quiescent position.
+    auto& best_line = thread.best_lines[ply];
+    best_line.clear();
+    best_line.insert(best_line.end(), quiescent_moves.begin(), quiescent_moves.end());
+
+    while( ! quiescent_undo_records.empty())
     {
-        const auto minimum_time_to_recurse = next_board.legal_moves().size()*node_evaluation_time;
-        return time_allotted_for_this_move > minimum_time_to_recurse;
+        next_board.unmake_move(quiescent_undo_records.back());
+        quiescent_undo_records.pop_back();
     }
+
+    return result;
+}
+
+bool Genetic_AI::search_further(const Game_Result& move_result, const size_t depth, const Search_Thread& thread) const noexcept
+{
+    return ! move_result.game_has_ended() && depth < thread.search_depth;
 }
 
 void Genetic_AI::output_thinking(const Game_Tree_Node_Result& thought,
-                                 const Piece_Color perspective) const noexcept
+                                 const Piece_Color perspective,
+                                 const Search_Thread& thread) const noexcept
 {
     const auto format = thinking_mode();
     if(format == Thinking_Output_Type::XBOARD)
     {
-        output_thinking_xboard(thought, perspective);
+        output_thinking_xboard(thought, perspective, thread);
     }
     else if(format == Thinking_Output_Type::UCI)
     {
-        output_thinking_uci(thought, perspective);
+        output_thinking_uci(thought, perspective, thread);
     }
     time_at_last_output = std::chrono::steady_clock::now();
 }
 
 void Genetic_AI::output_thinking_xboard(const Game_Tree_Node_Result& thought,
-                                        const Piece_Color perspective) const noexcept
+                                        const Piece_Color perspective,
+                                        const Search_Thread& thread) const noexcept
 {
-    const auto score = [this, &thought, perspective]()
+    const auto score = [&thought, perspective]()
     {
-        // Indicate "mate in N moves" where N == thought.depth
-        const auto mate_score = 100000 + int(thought.depth());
-        if(thought.is_winning_for(perspective))
-        {
-            return mate_score;
-        }
-        else if(thought.is_losing_for(perspective))
+        // Indicate "mate in N moves" where N == the depth of the checkmate
+        const auto thought_score = thought.value(perspective);
+        if(thought_score.is_checkmate())
         {
-            return -mate_score;
+            const auto mate_score = 100000 + int(thought_score.checkmate_depth());
+            return thought_score.is_win() ? mate_score : -mate_score;
         }
         else
         {
-            return int(thought.corrected_score(perspective)/centipawn_value());
+            return int(thought_score.centipawns());
         }
     }();
 
-    const auto time_so_far = std::chrono::steady_clock::now() - clock_start_time;
+    const auto time_so_far = std::chrono::steady_clock::now() - thread.control.start_time;
+    const auto nodes_searched = thread.control.nodes_searched();
     using centiseconds = std::chrono::duration<int, std::centi>;
     std::print("{} {} {} {} {} {}\t", 
-               thought.depth(), 
+               thread.search_depth, 
                score, 
                std::chrono::duration_cast<centiseconds>(time_so_far).count(), 
                nodes_searched, 
-               maximum_depth, 
+               thread.maximum_depth, 
                int(double(nodes_searched)/Clock::seconds(time_so_far).count()));
 
     // Principal variation
@@ -420,11 +797,14 @@ void Genetic_AI::output_thinking_xboard(const Game_Tree_Node_Result& thought,
 }
 
 void Genetic_AI::output_thinking_uci(const Game_Tree_Node_Result& thought,
-                                     const Piece_Color perspective) const noexcept
+                                     const Piece_Color perspective,
+                                     const Search_Thread& thread) const noexcept
 {
-    const auto time_so_far = std::chrono::steady_clock::now() - clock_start_time;
-    std::print("info depth {} time {} nodes {} nps {} pv ",
-               thought.depth(),
+    const auto time_so_far = std::chrono::steady_clock::now() - thread.control.start_time;
+    const auto nodes_searched = thread.control.nodes_searched();
+    std::print("info depth {} seldepth {} time {} nodes {} nps {} pv ",
+               thread.search_depth,
+               thread.maximum_depth,
                std::chrono::duration_cast<std::chrono::milliseconds>(time_so_far).count(),
                nodes_searched,
                int(double(nodes_searched) / Clock::seconds(time_so_far).count()));
@@ -435,17 +815,18 @@ void Genetic_AI::output_thinking_uci(const Game_Tree_Node_Result& thought,
     }
 
     std::print("score ");
-    if(thought.is_winning_for(perspective))
+    const auto score = thought.value(perspective);
+    if(score.is_win())
     {
-        std::print("mate {}", (1 + thought.depth())/2); // moves, not plies
+        std::print("mate {}", (1 + score.checkmate_depth())/2); // moves, not plies
     }
-    else if(thought.is_losing_for(perspective))
+    else if(score.is_loss())
     {
-        std::print("mate -{}", (1 + thought.depth())/2); // moves, not plies
+        std::print("mate -{}", (1 + score.checkmate_depth())/2); // moves, not plies
     }
     else
     {
-        std::print("cp {}", int(thought.corrected_score(perspective)/centipawn_value()));
+        std::print("cp {}", score.centipawns());
     }
 
     std::println(" currmove {}", thought.variation_line().front()->coordinates());
@@ -460,46 +841,40 @@ std::chrono::duration<double> Genetic_AI::time_since_last_output() const noexcep
 Game_Tree_Node_Result Genetic_AI::create_result(const Board& board,
                                                 const Piece_Color perspective,
                                                 const Game_Result& move_result,
-                                                const current_variation_store& move_list) const noexcept
-{
-    return {assign_score(board, move_result, perspective, move_list.size()),
-            perspective,
-            {move_list.begin(), move_list.end()}};
-}
-
-void Genetic_AI::calibrate_thinking_speed() const noexcept
-{
-    node_evaluation_time = 1ms; // very conservative initial guess
-    Board board;
-    Clock clock(0.1s);
-    clock.start(board.whose_turn());
-    choose_move(board, clock);
-    reset();
-}
-
-double Genetic_AI::assign_score(const Board& board, const Game_Result& move_result, Piece_Color perspective, size_t depth) const noexcept
+                                                const current_variation_store& move_list,
+                                                Evaluation_Cache::Statistics& cache_statistics) const noexcept
 {
+    const auto depth = move_list.size();
     if(move_result.game_has_ended())
     {
         if(move_result.winner() == Winner_Color::NONE) // draw by rule
         {
-            return Game_Tree_Node_Result::draw_score;
+            return {Score{}, perspective};
         }
         else if(move_result.winner() == static_cast<Winner_Color>(perspective)) // checkmate win
         {
-            return Game_Tree_Node_Result::win_score;
+            return {Score::win(depth), perspective};
         }
         else // checkmate loss
         {
-            return Game_Tree_Node_Result::lose_score;
+            return {Score::loss(depth), perspective};
         }
     }
 
-    const auto score = internal_evaluate(board, perspective, depth);
+    const auto score = assign_score(board, perspective, depth, cache_statistics);
+    return {Score::from_centipawns(score/centipawn_value()), perspective};
+}
+
+double Genetic_AI::assign_score(const Board& board,
+                                Piece_Color perspective,
+                                size_t depth,
+                                Evaluation_Cache::Statistics& cache_statistics) const noexcept
+{
+    const auto score = internal_evaluate(board, perspective, depth, cache_statistics);
     const auto non_progress_moves = board.moves_since_pawn_or_capture();
     if(non_progress_moves >= depth)
     {
-        return std::lerp(score, Game_Tree_Node_Result::draw_score, double(non_progress_moves)/100.0);
+        return std::lerp(score, 0.0, double(non_progress_moves)/100.0);
     }
     else
     {
@@ -507,9 +882,28 @@ double Genetic_AI::assign_score(const Board& board, const Game_Result& move_resu
     }
 }
 
-double Genetic_AI::internal_evaluate(const Board& board, Piece_Color perspective, size_t depth) const noexcept
+double Genetic_AI::internal_evaluate(const Board& board,
+                                     Piece_Color perspective,
+                                     size_t depth,
+                                     Evaluation_Cache::Statistics& cache_statistics) const noexcept
 {
-    return genome.evaluate(board, perspective, depth);
+    // Cached scores are from White's perspective. Evaluations are antisymmetric, so
+    // Black's score is the negative of White's.
+    const auto key = board.board_hash();
+    auto white_position_score = evaluation_cache.probe(key);
+    if(white_position_score)
+    {
+        ++cache_statistics.hits;
+    }
+    else
+    {
+        ++cache_statistics.misses;
+        white_position_score = genome.evaluate_position(board, Piece_Color::WHITE);
+        evaluation_cache.store(key, *white_position_score);
+    }
+
+    const auto position_score = perspective == Piece_Color::WHITE ? *white_position_score : -*white_position_score;
+    return position_score + genome.evaluate_move_history(board, perspective, depth);
 }
 
 const std::array<double, 6>& Genetic_AI::piece_values() const noexcept
@@ -522,6 +916,11 @@ Clock::seconds Genetic_AI::time_to_examine(const Board& board, const Clock& cloc
     return genome.time_to_examine(board, clock);
 }
 
+size_t Genetic_AI::nodes_to_examine(const Board& board, const Clock& clock) const noexcept
+{
+    return genome.nodes_to_examine(board, clock);
+}
+
 double Genetic_AI::speculation_time_factor(double game_progress) const noexcept
 {
     return genome.speculation_time_factor(game_progress);
@@ -544,38 +943,26 @@ double Genetic_AI::centipawn_value() const noexcept
 
 void Genetic_AI::calculate_centipawn_value() const noexcept
 {
-    auto sum_of_diffs = 0.0;
-    auto count = 0;
-    while(true)
+    std::array<double, calibration_position_count> pawn_values;
+    Thread_Pool::shared().parallel_for(pawn_values.size(),
+                                       [this, &pawn_values](const size_t index)
+                                       {
+                                           Evaluation_Cache::Statistics cache_statistics;
+                                           Position_History history;
+                                           const auto [board, board_without_pawn] = calibration_position(index, history);
+                                           const auto original_board_result = assign_score(board, Piece_Color::WHITE, 0, cache_statistics);
+                                           const auto minus_pawn_result = assign_score(board_without_pawn, Piece_Color::WHITE, 0, cache_statistics);
+                                           pawn_values[index] = std::abs(original_board_result - minus_pawn_result);
+                                       });
+
+    // Summing in a fixed order gives the same result with any number of threads.
+    value_of_centipawn = std::accumulate(pawn_values.begin(), pawn_values.end(), 0.0)/double(pawn_values.size())/100;
+    if( ! (value_of_centipawn > 0.0))
     {
-        Board board;
-        auto board_is_good = true;
-        for(int move = 0; move < 40; ++move)
-        {
-            const auto next_move = Random::random_element(board.legal_moves());
-            if(board.play_move(*next_move).game_has_ended() || board.fen().find_first_of("pP") == std::string::npos)
-            {
-                board_is_good = false;
-                break;
-            }
-        }
-
-        if(board_is_good)
-        {
-            const auto board_without_pawn = board.without_random_pawn();
-            const auto original_board_result = assign_score(board, {}, Piece_Color::WHITE, 0);
-            const auto minus_pawn_result = assign_score(board_without_pawn, {}, Piece_Color::WHITE, 0);
-            const auto diff = std::abs(original_board_result - minus_pawn_result);
-            sum_of_diffs += diff;
-
-            if((++count > 100 && diff < 0.01*sum_of_diffs) || count > 1000)
-            {
-                break;
-            }
-        }
+        // Search scores are measured in centipawns, so the unit cannot be zero even if
+        // the genome ignores pawns.
+        value_of_centipawn = 1.0;
     }
-
-    value_of_centipawn = sum_of_diffs/count/100;
 }
 
 std::string Genetic_AI::commentary_for_next_move(const Board& board) const noexcept
@@ -588,12 +975,44 @@ std::string Genetic_AI::commentary_for_next_move(const Board& board) const noexc
 
     const auto& comment = commentary.at(comment_index);
     const auto& variation = comment.variation_line();
-    const auto score = comment.corrected_score(board.whose_turn())/centipawn_value()/100.0;
+    const auto score = comment.value(board.whose_turn()).centipawns()/100.0;
     return variation_line(board, variation, score);
 }
 
 namespace
 {
+    Calibration_Cache& calibration_cache() noexcept
+    {
+        static Calibration_Cache cache;
+        return cache;
+    }
+
+    std::pair<Board, Board> calibration_position(const size_t index, Position_History& history) noexcept
+    {
+        auto generator = Random::Random_Bits_Generator(index);
+        while(true)
+        {
+            Board board;
+            board.use_position_history(history);
+            auto board_is_good = true;
+            for(int move = 0; move < 40; ++move)
+            {
+                const auto next_move = Random::random_element(board.legal_moves(), generator);
+                if(board.play_move(*next_move).game_has_ended() || board.fen().find_first_of("pP") == std::string::npos)
+                {
+                    board_is_good = false;
+                    break;
+                }
+            }
+
+            if(board_is_good)
+            {
+                const auto board_without_pawn = board.without_random_pawn(generator);
+                return {board, board_without_pawn};
+            }
+        }
+    }
+
     std::string variation_line(Board board,
                                const std::vector<const Move*>& variation,
                                const double score) noexcept
@@ -642,18 +1061,74 @@ void Genetic_AI::undo_move(const Move* const last_move) const noexcept
 
 void Genetic_AI::recalibrate_self() const noexcept
 {
-    calibrate_thinking_speed();
+    const auto genome_hash = genome.content_hash();
+    if(const auto cached_value = calibration_cache().find(genome_hash))
+    {
+        value_of_centipawn = *cached_value;
+        return;
+    }
+
     calculate_centipawn_value();
+    calibration_cache().store(genome_hash, value_of_centipawn);
+}
+
+void Genetic_AI::use_calibration_cache_file(const std::string& file_name) noexcept
+{
+    calibration_cache().use_file(file_name);
 }
 
 void Genetic_AI::reset() const noexcept
 {
+    stop_pondering();
     commentary.clear();
+    transposition_table.clear();
+    evaluation_cache.clear();
+}
+
+void Genetic_AI::set_transposition_table_size(const size_t megabytes) const noexcept
+{
+    stop_pondering();
+    transposition_table.resize(megabytes);
+}
+
+void Genetic_AI::set_search_thread_count(const size_t thread_count) const noexcept
+{
+    search_thread_count = std::max(thread_count, size_t{1});
+}
+
+Genetic_AI::Ponder_Search_Handle::Ponder_Search_Handle() noexcept = default;
+
+Genetic_AI::Ponder_Search_Handle::Ponder_Search_Handle(const Ponder_Search_Handle&) noexcept
+{
+}
+
+Genetic_AI::Ponder_Search_Handle& Genetic_AI::Ponder_Search_Handle::operator=(const Ponder_Search_Handle&) noexcept
+{
+    search.reset();
+    return *this;
+}
+
+Genetic_AI::Ponder_Search_Handle::~Ponder_Search_Handle() = default;
+
+size_t Genetic_AI::nodes_searched_for_last_move() const noexcept
+{
+    return nodes_searched_last_move;
+}
+
+Evaluation_Cache::Statistics Genetic_AI::evaluation_cache_statistics_for_last_move() const noexcept
+{
+    return evaluation_cache_statistics_last_move;
+}
+
+std::optional<Transposition_Table::Entry> Genetic_AI::stored_search_result(const Board& board) const noexcept
+{
+    return transposition_table.probe(board.board_hash());
 }
 
 void Genetic_AI::mutate(const size_t mutation_rate) noexcept
 {
     genome.mutate(mutation_rate);
+    reset(); // Stored scores came from the old genome.
     recalibrate_self();
 }
 
@@ -10,12 +10,20 @@
 #include <string>
 #include <iosfwd>
 #include <compare>
+#include <optional>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
 
 #include "Game/Color.h"
 #include "Game/Clock.h"
 
 #include "Players/Game_Tree_Node_Result.h"
 #include "Players/Alpha_Beta_Value.h"
+#include "Players/Transposition_Table.h"
+#include "Players/Evaluation_Cache.h"
+#include "Players/Score.h"
 #include "Utility/Fixed_Capacity_Vector.h"
 #include "Genes/Genome.h"
 
@@ -25,7 +33,11 @@ class Game_Result;
 
 //! \file
 
-//! \brief This Player uses a variable-depth minimax algorithm with alpha-beta pruning. Scoring and time controlled are evolved via a genetic algorithm.
+//! \brief This Player uses an iterative-deepening minimax algorithm with alpha-beta pruning. Scoring and time controlled are evolved via a genetic algorithm.
+//!
+//! The search is iteratively deepened: it searches one ply deep, then two, and so on until
+//! time runs out, using the result of each search to order moves and set the alpha-beta
+//! window for the next.
 //!
 //! Minimax algorithm: https://en.wikipedia.org/wiki/Minimax
 //! Alpha-beta pruning: https://en.wikipedia.org/wiki/Alpha%E2%80%93beta_pruning
@@ -55,22 +67,43 @@ class Genetic_AI : public Player
 
         //! Create a new AI by mating two existing ones.
         //!
+        //! The new AI's transposition table is the same size as the first AI's.
         //! \param a The first AI.
         //! \param b The second AI.
         Genetic_AI(const Genetic_AI& a, const Genetic_AI& b) noexcept;
 
+        //! Create a new AI by mating two existing ones and mutating the result.
+        //!
+        //! The new AI is only calibrated once, after mutation. This is safe to call on any
+        //! thread as long as the ID number comes from Genome::reserve_ids(). The new AI's
+        //! transposition table is the same size as the first AI's.
+        //! \param a The first AI.
+        //! \param b The second AI.
+        //! \param id The ID number of the new AI.
+        //! \param mutation_rate The number of discrete mutations to apply to the new AI.
+        Genetic_AI(const Genetic_AI& a, const Genetic_AI& b, int id, size_t mutation_rate) noexcept;
+
         std::string name() const noexcept override;
         std::string author() const noexcept override;
 
         //! A numeric identifier for this AI.
         int id() const noexcept;
 
-        //! \brief Genetic_AI uses a variable-depth minimax algorithm with alpha-beta pruning.
+        //! \brief Genetic_AI uses an iterative-deepening minimax algorithm with alpha-beta pruning.
+        //!
+        //! The depth of the search is determined by how much time is available. Searches
+        //! of increasing depth are run until the next one is not expected to finish within
+        //! the time chosen by the genome. A search that runs far over time is stopped, and
+        //! the result of the last completed search is used. If the clock has a node budget
+        //! (see Clock::node_budget()), the number of positions searched is limited in the
+        //! same way instead of time.
         //!
-        //! The depth of the search is determined by how much time is available.
-        //! At first, equal time is allocated to each legal move for examination. Time
-        //! is overcommitted with the expectation that not all of the time will be used
-        //! due to search cutoffs due to alpha-beta pruning.
+        //! If more than one search thread is allowed (see set_search_thread_count()), helper
+        //! threads search the same position at the same time, sharing results through the
+        //! transposition table, and the result of the deepest completed search is used.
+        //!
+        //! If the position is the one given to ponder(), the search started while pondering
+        //! continues with the usual time limits.
         //! \param board The current state of the game.
         //! \param clock The game clock telling how much time is left in the game.
         const Move& choose_move(const Board& board, const Clock& clock) const noexcept override;
@@ -84,8 +117,49 @@ class Genetic_AI : public Player
 
         void reset() const noexcept override;
 
+        void set_transposition_table_size(size_t megabytes) const noexcept override;
+
+        void set_search_thread_count(size_t thread_count) const noexcept override;
+
+        //! \brief Search a position in the background without time limits until choose_move() or stop_pondering() is called.
+        //!
+        //! \param board The position expected after the opponent's next move.
+        //! \param clock The game clock. The time for the move is planned from the time left for
+        //!        the player to move in the board, but is not counted until choose_move() is called.
+        void ponder(const Board& board, const Clock& clock) const noexcept override;
+
+        void stop_pondering() const noexcept override;
+
+        //! \brief The opponent's move in the principal variation of the last move chosen.
+        //!
+        //! \param board The board position after this player's last move.
+        const Move* expected_response(const Board& board) const noexcept override;
+
+        //! \brief The number of positions examined by all threads while choosing the last move.
+        size_t nodes_searched_for_last_move() const noexcept override;
+
+        //! \brief How often board evaluations were found in the evaluation cache while choosing the last move.
+        Evaluation_Cache::Statistics evaluation_cache_statistics_for_last_move() const noexcept;
+
+        //! \brief The search result stored in the transposition table for a position, if any.
+        //!
+        //! \param board The position to look up.
+        std::optional<Transposition_Table::Entry> stored_search_result(const Board& board) const noexcept;
+
+        //! \brief Save the calibrations of all Genetic_AIs in a file so they can be reused.
+        //!
+        //! Loading or creating a genome that was calibrated before reads the result from the file
+        //! instead of repeating the calibration. This should be called before any Genetic_AI is
+        //! created on another thread. See Calibration_Cache.
+        //! \param file_name The name of the cache file. If empty, results are only kept until the program exits.
+        static void use_calibration_cache_file(const std::string& file_name) noexcept;
+
+        //! \brief The board evaluation score that is equal to one centipawn, found by calibration.
+        double centipawn_value() const noexcept;
+
         //! \brief Randomly mutate the AI.
         //!
+        //! Search results and evaluations from before the mutation are discarded.
         //! \param mutation_rate The number of discrete mutations to apply to the AI
         void mutate(size_t mutation_rate) noexcept;
 
@@ -124,11 +198,168 @@ class Genetic_AI : public Player
         //! A datatype for storing the moves that are played to reach the current board position during a search.
         using current_variation_store = Fixed_Capacity_Vector<const Move*, variation_store_size>;
 
+        //! \brief How far past the planned search time a search may run before it is stopped, as a multiple of the planned time.
+        static constexpr double hard_time_limit_factor = 3.0;
+
+        //! \brief The most positions one search thread examines between checks of the node limit.
+        //!
+        //! A search with a node budget stops this many positions per thread early so that it
+        //! does not search more positions than the clock allows.
+        static constexpr size_t nodes_between_limit_checks = maximum_quiescent_captures + 1;
+
+        //! \brief The half-width of the first search window around the score of the previous iteration.
+        static constexpr Score::value_type aspiration_window_centipawns = 25;
+
+        //! \brief How much a search window is widened after the score falls outside of it.
+        static constexpr Score::value_type aspiration_window_growth = 4;
+
+        //! \brief Search windows wider than this are replaced by a full window.
+        static constexpr Score::value_type maximum_aspiration_window_centipawns = 1000;
+
+        struct Search_Thread;
+
+        //! \brief Data shared by all threads searching for the same move.
+        struct Search_Control
+        {
+            //! \brief When the search started.
+            std::chrono::steady_clock::time_point start_time;
+
+            //! \brief When the time limits started counting: the start of the search or when pondering stopped.
+            //!
+            //! This is a Clock::time_reading() of the game clock so that the search measures time in the same way as the clock.
+            Clock::seconds timing_start_time;
+
+            //! \brief How long the search may take before it is stopped.
+            Clock::seconds time_limit;
+
+            //! \brief How many positions may be searched before the search is stopped if the clock has a node budget.
+            //!
+            //! If the clock measures time, this is empty and time_limit is used.
+            std::optional<size_t> node_limit;
+
+            //! \brief The number of positions searched before the limits started counting.
+            size_t timing_start_nodes = 0;
+
+            //! \brief Whether all threads should stop searching.
+            std::atomic<bool> stopped = false;
+
+            //! \brief Whether the search is running on the opponent's time, so time limits do not apply.
+            std::atomic<bool> pondering = false;
+
+            //! \brief Whether the time limits have started counting. Only the main thread uses this.
+            bool timing_started = true;
+
+            //! \brief Check whether the time limits apply, starting the time limits if pondering has stopped.
+            //!
+            //! Only the main thread should call this.
+            //! \param clock The game clock.
+            bool is_timed(const Clock& clock) noexcept;
+
+            //! \brief The threads taking part in the search. The first is the main thread.
+            std::deque<Search_Thread> threads;
+
+            //! \brief The total number of positions examined by all threads.
+            size_t nodes_searched() const noexcept;
+
+            //! \brief The number of positions examined by all threads since the limits started counting.
+            size_t nodes_searched_since_timing_start() const noexcept;
+
+            //! \brief The total evaluation cache hits and misses of all threads.
+            //!
+            //! This should only be called after the search threads have finished.
+            Evaluation_Cache::Statistics evaluation_cache_statistics() const noexcept;
+        };
+
+        //! \brief Data belonging to one thread of a search.
+        struct Search_Thread
+        {
+            //! \brief Create the data for a search thread.
+            //!
+            //! \param control_in The data shared by all threads of the search.
+            //! \param index_in The index of this thread in Search_Control::threads.
+            Search_Thread(Search_Control& control_in, size_t index_in) noexcept;
+
+            //! \brief The data shared by all threads of the search.
+            Search_Control& control;
+
+            //! \brief The index of this thread in Search_Control::threads.
+            const size_t index;
+
+            //! \brief The main thread manages time and reports search progress.
+            bool is_main_thread() const noexcept;
+
+            //! \brief The depth of the search in progress.
+            size_t search_depth = 0;
+
+            //! \brief The deepest position reached in the search so far, including quiescence.
+            size_t maximum_depth = 0;
+
+            //! \brief The depth of the last completed search.
+            size_t completed_depth = 0;
+
+            //! \brief The result of the last completed search (or the partial result if none were completed).
+            std::optional<Game_Tree_Node_Result> result;
+
+            //! \brief The number of positions examined by this thread.
+            //!
+            //! Only this thread writes the count, but other threads may read it for reporting.
+            std::atomic<size_t> nodes_searched = 0;
+
+            //! \brief Add to the number of positions examined by this thread.
+            void add_nodes(size_t count) noexcept;
+
+            //! \brief How often this thread found board evaluations in the evaluation cache.
+            Evaluation_Cache::Statistics evaluation_cache_statistics;
+
+            //! \brief The best lines found so far at each ply of the search in progress.
+            //!
+            //! best_lines[ply] is the best line from the position reached by the first ply moves of
+            //! the current variation. When a better move is found, it is recorded along with the
+            //! best line from the next ply, so the best line of the whole search ends up in
+            //! best_lines[0] without allocating memory during the search.
+            std::array<current_variation_store, maximum_variation_depth + 1> best_lines;
+
+            //! \brief Record a new best move at a ply, followed by the best line from the next ply.
+            //!
+            //! \param ply The number of moves from the start of the search to the position where the move is played.
+            //! \param move The new best move.
+            void update_best_line(size_t ply, const Move* move) noexcept;
+
+            //! \brief The best line found from the start of the search through a position in the current variation.
+            //!
+            //! \param ply The number of moves from the start of the search to the position.
+            //! \param current_variation The moves played to reach the current position.
+            std::vector<const Move*> line_from_root(size_t ply, const current_variation_store& current_variation) const noexcept;
+        };
+
+        struct Ponder_Search;
+
+        //! \brief Owns the search started by ponder(), if any.
+        //!
+        //! Searches are not copied or shared, so a copy of a Genetic_AI is not pondering.
+        struct Ponder_Search_Handle
+        {
+            //! \brief Create an empty handle.
+            Ponder_Search_Handle() noexcept;
+
+            //! \brief Create an empty handle. Nothing is copied.
+            Ponder_Search_Handle(const Ponder_Search_Handle& other) noexcept;
+
+            //! \brief Stop any search owned by this handle. Nothing is copied.
+            Ponder_Search_Handle& operator=(const Ponder_Search_Handle& other) noexcept;
+
+            //! \brief Stop any search owned by this handle and wait for it to finish.
+            ~Ponder_Search_Handle();
+
+            //! \brief The search in progress, or nullptr.
+            std::unique_ptr<Ponder_Search> search;
+        };
+
         //! \brief Recalculate values that will last the lifetime of the instance.
         //!
-        //! In this case, the values are an initial estimate of the speed of
-        //! searching the game tree and the value of a centipawn for reporting
-        //! scores of board positions.
+        //! In this case, the value is the value of a centipawn for reporting
+        //! scores of board positions. Results are looked up in and saved to the
+        //! calibration cache (see use_calibration_cache_file()).
         void recalibrate_self() const noexcept;
 
         //! \brief Resets the values of internal search stats (node counts, time used, etc.) before the next search.
@@ -138,9 +369,9 @@ class Genetic_AI : public Player
 
         //! \brief Output final stats for the move chosen and record the commentary for the chosen move.
         //!
-        //! \param result The data (variation and score) for the chosen move.
+        //! \param thread The search thread whose result was chosen.
         //! \param board The current board position.
-        void report_final_search_stats(const Game_Tree_Node_Result& result, const Board& board) const noexcept;
+        void report_final_search_stats(const Search_Thread& thread, const Board& board) const noexcept;
 
         //! \brief Returns how much time to spend choosing this move.
         //!
@@ -149,6 +380,12 @@ class Genetic_AI : public Player
         //! \returns A time duration indicating how much time to use.
         Clock::seconds time_to_examine(const Board& board, const Clock& clock) const noexcept;
 
+        //! \brief Returns how many positions to search to choose this move when the clock has a node budget.
+        //!
+        //! \param board The current board position.
+        //! \param clock The game clock.
+        size_t nodes_to_examine(const Board& board, const Clock& clock) const noexcept;
+
         //! \brief An estimate of the average number of moves that will be searched per board position.
         //!
         //! \param game_progress An estimate of how much of the game has been played (0.0 at the beginning, 1.0 at the end).
@@ -164,29 +401,61 @@ class Genetic_AI : public Player
         //! \param board The current board position.
         double game_progress(const Board& board) const noexcept;
 
-        //! \brief Search the game tree using the minimax (actually negamax) algorithm with alpha-beta pruning
+        //! \brief Run searches of increasing depth on one thread until the search is stopped.
+        //!
+        //! The results are stored in the thread's data.
+        //! \param board The current board position.
+        //! \param clock The game clock.
+        //! \param progress_of_game An estimate of how much of the game has been played (0.0 at the beginning, 1.0 at the end).
+        //! \param soft_time_limit The main thread does not start a deeper search that is not expected to finish in this time.
+        //! \param soft_node_limit If the clock has a node budget, the main thread does not start a deeper search
+        //!        that is not expected to finish within this number of positions.
+        //! \param principal_variation The best line found from the previous move's search.
+        //! \param thread The data for this search thread.
+        void iterative_deepening_search(Board& board,
+                                        const Clock& clock,
+                                        double progress_of_game,
+                                        Clock::seconds soft_time_limit,
+                                        size_t soft_node_limit,
+                                        std::vector<const Move*> principal_variation,
+                                        Search_Thread& thread) const noexcept;
+
+        //! \brief Search the game tree to one more ply than the last search, starting with a narrow window around the last score.
         //!
+        //! If the score falls outside the window, the search is repeated with a wider window.
         //! \param board The current board position.
-        //! \param time_to_examine How much time to use choosing this move.
-        //! \param minimum_search_depth The minimum depth to search before evaluating a variation.
-        //! \param maximum_search_depth The maximum depth to search.
+        //! \param clock The game clock.
+        //! \param progress_of_game An estimate of how much of the game has been played (0.0 at the beginning, 1.0 at the end).
+        //! \param principal_variation The best line found from the previous search--used to order moves in the current search.
+        //! \param thread The data for this search thread, including the result of the last completed search.
+        //! \returns The best variation and its score.
+        Game_Tree_Node_Result search_with_aspiration_window(Board& board,
+                                                            const Clock& clock,
+                                                            double progress_of_game,
+                                                            const std::vector<const Move*>& principal_variation,
+                                                            Search_Thread& thread) const noexcept;
+
+        //! \brief Search the game tree using the minimax (actually negamax) algorithm with alpha-beta pruning
+        //!
+        //! Every variation is searched to Search_Thread::search_depth plies, followed by a quiescence search.
+        //! \param board The current board position. Moves are made and unmade on this board during the
+        //!        search, so it is returned to its original state at the end.
         //! \param clock The game clock.
         //! \param alpha The current value for alpha: the best variation score found that the current player can force.
         //! \param beta The current value for beta: the variation score that, if the current variation scores better, will result
         //!        in the opponent choosing different earlier moves to avoid the current variation.
         //! \param principal_variation The best line found from the previous search--used to order moves in the current search.
         //! \param current_variation The list of moves to reach the current board position.
+        //! \param thread The data for this search thread.
         //! \returns The best variation and its score.
-        Game_Tree_Node_Result search_game_tree(const Board& board,
-                                               Clock::seconds time_to_examine,
-                                               size_t minimum_search_depth,
-                                               size_t maximum_search_depth,
+        Game_Tree_Node_Result search_game_tree(Board& board,
                                                const Clock& clock,
                                                double progress_of_game,
                                                Alpha_Beta_Value alpha,
                                                const Alpha_Beta_Value& beta,
                                                std::vector<const Move*>& principal_variation,
-                                               current_variation_store& current_variation) const noexcept;
+                                               current_variation_store& current_variation,
+                                               Search_Thread& thread) const noexcept;
 
         // The brains of the Minimax algorithm that provides board evaluation and time management.
         Genome genome;
@@ -194,15 +463,23 @@ class Genetic_AI : public Player
         // Data for writing commentary for each move choice to PGN files.
         mutable std::vector<Game_Tree_Node_Result> commentary;
 
-        // Monitor search speed to adapt to different computers/competing workloads
-        mutable Clock::seconds node_evaluation_time;
-        mutable size_t nodes_searched;
-        mutable std::chrono::steady_clock::time_point clock_start_time;
-        mutable size_t maximum_depth;
+        // Results of earlier searches of board positions
+        mutable Transposition_Table transposition_table;
+
+        // Results of earlier evaluations of board positions
+        mutable Evaluation_Cache evaluation_cache;
+
+        // Search running while the opponent is thinking
+        mutable Ponder_Search_Handle ponder_search;
+
+        // Number of threads that search for each move
+        mutable size_t search_thread_count = 1;
+
+        // Search statistics for the last move
+        mutable size_t nodes_searched_last_move = 0;
+        mutable Evaluation_Cache::Statistics evaluation_cache_statistics_last_move;
 
         // For thinking output
-        mutable int nodes_evaluated;
-        mutable Clock::seconds total_evaluation_time;
         mutable std::chrono::steady_clock::time_point time_at_last_output;
 
         //! \brief Sort moves before searching further in the game tree.
@@ -218,70 +495,86 @@ class Genetic_AI : public Player
 
         // Evaluation method
         double assign_score(const Board& board,
-                            const Game_Result& move_result,
                             Piece_Color perspective,
-                            size_t depth) const noexcept;
+                            size_t depth,
+                            Evaluation_Cache::Statistics& cache_statistics) const noexcept;
         double internal_evaluate(const Board& board,
                                  Piece_Color perspective,
-                                 size_t depth) const noexcept;
+                                 size_t depth,
+                                 Evaluation_Cache::Statistics& cache_statistics) const noexcept;
 
         const std::array<double, 6>& piece_values() const noexcept;
 
         // Scoring output
-        double centipawn_value() const noexcept;
-
         Game_Tree_Node_Result evaluate(const Game_Result& move_result,
                                        Board& next_board,
                                        Genetic_AI::current_variation_store& current_variation,
                                        Piece_Color perspective,
-                                       std::chrono::steady_clock::time_point evaluate_start_time) const noexcept;
+                                       Search_Thread& thread) const noexcept;
 
-        bool search_further(const Game_Result& move_result,
-                            size_t depth,
-                            const Board& next_board,
-                            const std::vector<const Move*>& principal_variation,
-                            size_t minimum_search_depth,
-                            size_t maximum_search_depth,
-                            Clock::seconds time_allotted_for_this_move) const noexcept;
+        bool search_further(const Game_Result& move_result, size_t depth, const Search_Thread& thread) const noexcept;
+
+        //! \brief Check whether the search should stop because time is up or a move was demanded.
+        //!
+        //! Only the main thread checks the time. Once this returns true, it keeps returning true
+        //! until the next search starts.
+        //! \param clock The game clock.
+        //! \param thread The data for this search thread.
+        bool search_must_stop(const Clock& clock, const Search_Thread& thread) const noexcept;
 
         //! \brief Assign a score to the current board state.
         //!
+        //! The genome's evaluation is converted to integer centipawns here, so the rest of the
+        //! search only compares integers.
         //! \param board The current state of the Board.
         //! \param perspective From whose perspective (Black or White) the board should be scored.
         //! \param move_result The possibly game-ending result of the move.
         //! \param move_list The current move list from the game tree search.
+        //! \param cache_statistics The hit and miss counts of the evaluation cache to update.
         Game_Tree_Node_Result create_result(const Board& board,
                                             Piece_Color perspective,
                                             const Game_Result& move_result,
-                                            const current_variation_store& move_list) const noexcept;
+                                            const current_variation_store& move_list,
+                                            Evaluation_Cache::Statistics& cache_statistics) const noexcept;
 
         // Output thinking to stdout
         void output_thinking(const Game_Tree_Node_Result& thought,
-                             Piece_Color perspective) const noexcept;
+                             Piece_Color perspective,
+                             const Search_Thread& thread) const noexcept;
         void output_thinking_xboard(const Game_Tree_Node_Result& thought,
-                                  Piece_Color perspective) const noexcept;
+                                    Piece_Color perspective,
+                                    const Search_Thread& thread) const noexcept;
         void output_thinking_uci(const Game_Tree_Node_Result& thought,
-                                 Piece_Color perspective) const noexcept;
+                                 Piece_Color perspective,
+                                 const Search_Thread& thread) const noexcept;
 
         std::chrono::duration<double> time_since_last_output() const noexcept;
 
         mutable double value_of_centipawn;
 
+        //! \brief The number of random positions evaluated to find the value of a centipawn.
+        static const size_t calibration_position_count = 256;
+
         //! \brief Approximate the value of 0.01 pawns for reporting scores.
         //!
-        //! \returns A numerical value to normalize the scores returned by board evaluations
-        //!          so that the loss of a random pawn changes the score by about 1.0.
+        //! Every genome is measured with the same set of random positions, so the result only
+        //! depends on the genes. The positions are divided among the threads of Thread_Pool::shared().
+        //! The result is a numerical value to normalize the scores returned by board evaluations
+        //! so that the loss of a random pawn changes the score by about 1.0.
         void calculate_centipawn_value() const noexcept;
 
-        //! \brief Initial measurement of evaluation speed of the engine.
+        //! \brief Run the search threads until the search is stopped or runs out of time.
         //!
-        //! The method Genetic_AI::choose_move() keeps track of the time it takes
-        //! and the number of positions it evaluates. But, it needs an accurate
-        //! starting value for the first move search. So, this practice move will
-        //! update the evaluation speed to a more reasonable starting value.
-        void calibrate_thinking_speed() const noexcept;
+        //! \param board The current board position.
+        //! \param clock The game clock.
+        //! \param control The data shared by the search threads. The results are stored here.
+        void choose_move_minimax(const Board& board, const Clock& clock, Search_Control& control) const noexcept;
 
-        const Move& choose_move_minimax(const Board& board, const Clock& clock) const noexcept;
+        //! \brief Pick the move from the best search thread and report the search results.
+        //!
+        //! \param board The board position that was searched.
+        //! \param control The data from the finished search.
+        const Move& report_chosen_move(const Board& board, const Search_Control& control) const noexcept;
 
         std::vector<const Move*> get_legal_principal_variation(const Board& board) const noexcept;
 };
@@ -8,6 +8,7 @@
 #include <format>
 
 #include "Game/Color.h"
+#include "Game/Board.h"
 #include "Players/Proxy_Player.h"
 
 #include "Players/Xboard_Mediator.h"
@@ -68,6 +69,11 @@ void Outside_Communicator::record_opponent_name(const std::string& name, const s
     }
 }
 
+void Outside_Communicator::record_game_positions(Board& board) noexcept
+{
+    board.use_position_history(game_history);
+}
+
 Proxy_Player Outside_Communicator::create_proxy_player() const noexcept
 {
     return Proxy_Player{remote_opponent_name};
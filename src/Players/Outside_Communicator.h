@@ -12,6 +12,7 @@
 #include <ostream>
 
 #include "Game/Color.h"
+#include "Game/Position_History.h"
 
 #include "Utility/String.h"
 #include "Utility/Random.h"
@@ -68,9 +69,18 @@ class Outside_Communicator
         //! \param board The Board used for the game.
         //! \param move The move picked by the local AI.
         //! \param move_list The list of moves in the game so far.
+        //! \param player The local AI.
         virtual Game_Result handle_move(Board& board,
                                         const Move& move,
-                                        std::vector<const Move*>& move_list) const = 0;
+                                        std::vector<const Move*>& move_list,
+                                        const Player& player) const = 0;
+
+        //! \brief Record the positions of the game board so that repeated positions can be detected.
+        //!
+        //! This must be called on the game board before it is first passed to setup_turn(). The
+        //! derived classes call it again whenever they replace the game board.
+        //! \param board The Board used for the game.
+        void record_game_positions(Board& board) noexcept;
 
         //! \brief Create a player for the purposes of calling Board::print_game_record()
         Proxy_Player create_proxy_player() const noexcept;
@@ -133,6 +143,7 @@ class Outside_Communicator
         mutable std::ofstream ofs;
         std::string remote_opponent_name;
         std::future<std::string> last_listening_result;
+        Position_History game_history;
 
         virtual std::string listener(Clock& clock) = 0;
 };
@@ -6,6 +6,8 @@
 #include "Players/Thinking.h"
 
 class Board;
+class Clock;
+class Move;
 
 namespace
 {
@@ -17,6 +19,32 @@ void Player::reset() const noexcept
 {
 }
 
+void Player::set_transposition_table_size(size_t) const noexcept
+{
+}
+
+void Player::set_search_thread_count(size_t) const noexcept
+{
+}
+
+void Player::ponder(const Board&, const Clock&) const noexcept
+{
+}
+
+void Player::stop_pondering() const noexcept
+{
+}
+
+const Move* Player::expected_response(const Board&) const noexcept
+{
+    return nullptr;
+}
+
+size_t Player::nodes_searched_for_last_move() const noexcept
+{
+    return 0;
+}
+
 std::string Player::commentary_for_next_move(const Board&) const noexcept
 {
     return {};
@@ -2,6 +2,7 @@
 #define PLAYER_H
 
 #include <string>
+#include <cstddef>
 
 #include "Players/Thinking.h"
 
@@ -26,6 +27,43 @@ class Player
         //! \brief Reset player internals (if any) for a new game
         virtual void reset() const noexcept;
 
+        //! \brief Set the size of the table used to remember the results of searching board positions.
+        //!
+        //! Players that do not search the game tree ignore this setting.
+        //! \param megabytes The amount of memory the table may use.
+        virtual void set_transposition_table_size(size_t megabytes) const noexcept;
+
+        //! \brief Set the number of threads the player may use to search for a move.
+        //!
+        //! Players that do not search the game tree ignore this setting.
+        //! \param thread_count The number of threads.
+        virtual void set_search_thread_count(size_t thread_count) const noexcept;
+
+        //! \brief Start thinking about a position while the opponent is choosing a move.
+        //!
+        //! The search runs in the background until the next call to choose_move() or
+        //! stop_pondering(). If choose_move() is given the same position, the work done while
+        //! pondering is kept and the search continues. Players that do not search the game
+        //! tree ignore this.
+        //! \param board The position expected after the opponent's next move.
+        //! \param clock The game clock. Time limits do not start until choose_move() is called.
+        virtual void ponder(const Board& board, const Clock& clock) const noexcept;
+
+        //! \brief Stop thinking about the position given to ponder().
+        virtual void stop_pondering() const noexcept;
+
+        //! \brief The move the player expects the opponent to play next.
+        //!
+        //! \param board The board position after this player's last move.
+        //! \returns The expected move, or nullptr if the player has no prediction.
+        virtual const Move* expected_response(const Board& board) const noexcept;
+
+        //! \brief The number of positions examined while choosing the last move.
+        //!
+        //! A Clock with a node budget charges this to the player. Players that do not search
+        //! the game tree return zero.
+        virtual size_t nodes_searched_for_last_move() const noexcept;
+
         //! \brief The name of the player.
         //!
         //! \returns The name of the individual player. This may have specific details like ID numbers
@@ -0,0 +1,53 @@
+#include "Players/Score.h"
+
+#include <cmath>
+#include <cassert>
+#include <cstdlib>
+#include <algorithm>
+
+Score Score::from_centipawns(const double centipawns) noexcept
+{
+    if(std::isnan(centipawns))
+    {
+        return {};
+    }
+
+    return Score{value_type(std::round(std::clamp(centipawns, -double(maximum_centipawns), double(maximum_centipawns))))};
+}
+
+Score Score::win(const size_t depth) noexcept
+{
+    assert(depth <= size_t(maximum_checkmate_depth));
+    return Score{checkmate_score - value_type(depth)};
+}
+
+Score Score::loss(const size_t depth) noexcept
+{
+    return -win(depth);
+}
+
+Score::value_type Score::centipawns() const noexcept
+{
+    return score;
+}
+
+bool Score::is_win() const noexcept
+{
+    return score > maximum_centipawns;
+}
+
+bool Score::is_loss() const noexcept
+{
+    return score < -maximum_centipawns;
+}
+
+bool Score::is_checkmate() const noexcept
+{
+    return is_win() || is_loss();
+}
+
+size_t Score::checkmate_depth() const noexcept
+{
+    assert(is_checkmate());
+    return size_t(checkmate_score - std::abs(score));
+}
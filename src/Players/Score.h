@@ -0,0 +1,86 @@
+#ifndef SCORE_H
+#define SCORE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <compare>
+
+//! \file
+
+//! \brief An integer score of a board position for the game tree search.
+//!
+//! Positions where the game continues are scored in centipawns. Checkmates are scored
+//! beyond any centipawn score, and the fewer plies it takes to reach the checkmate, the
+//! further the score is from zero. So, comparing two scores as integers prefers any win
+//! over a non-win, a faster win over a slower one, and a slower loss over a faster one.
+class Score
+{
+    public:
+        //! \brief The integer type that holds a score.
+        using value_type = int32_t;
+
+        //! \brief The largest magnitude of a score that is not a checkmate.
+        static constexpr value_type maximum_centipawns = 900'000;
+
+        //! \brief Create a score of zero, the score of a drawn position.
+        constexpr Score() noexcept = default;
+
+        //! \brief Create a score from a number of centipawns.
+        //!
+        //! \param centipawns_in The score in centipawns, or the value of centipawns() from another score.
+        constexpr explicit Score(value_type centipawns_in) noexcept : score(centipawns_in)
+        {
+        }
+
+        //! \brief Create a score from a board evaluation.
+        //!
+        //! \param centipawns The evaluation in centipawns. It is rounded to the nearest integer
+        //!        and limited to the range of scores that are not checkmates. NaN becomes zero.
+        static Score from_centipawns(double centipawns) noexcept;
+
+        //! \brief The score of a checkmate of the opponent.
+        //!
+        //! \param depth The number of plies from the start of the search to the checkmate.
+        static Score win(size_t depth) noexcept;
+
+        //! \brief The score of being checkmated.
+        //!
+        //! \param depth The number of plies from the start of the search to the checkmate.
+        static Score loss(size_t depth) noexcept;
+
+        //! \brief The score of the same position from the opponent's perspective.
+        constexpr Score operator-() const noexcept
+        {
+            return Score{-score};
+        }
+
+        //! \brief Scores are compared as integers.
+        constexpr auto operator<=>(const Score& other) const noexcept = default;
+
+        //! \brief The score in centipawns.
+        //!
+        //! For checkmates, this is a number larger in magnitude than maximum_centipawns.
+        value_type centipawns() const noexcept;
+
+        //! \brief Whether the score is a checkmate of the opponent.
+        bool is_win() const noexcept;
+
+        //! \brief Whether the score is a checkmate of the player.
+        bool is_loss() const noexcept;
+
+        //! \brief Whether the score is a checkmate of either player.
+        bool is_checkmate() const noexcept;
+
+        //! \brief The number of plies from the start of the search to the checkmate.
+        //!
+        //! \exception assertion_failure If the score is not a checkmate.
+        size_t checkmate_depth() const noexcept;
+
+    private:
+        value_type score = 0;
+
+        static constexpr value_type checkmate_score = 1'000'000;
+        static constexpr value_type maximum_checkmate_depth = checkmate_score - maximum_centipawns - 1;
+};
+
+#endif // SCORE_H
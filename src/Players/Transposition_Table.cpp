@@ -0,0 +1,144 @@
+#include "Players/Transposition_Table.h"
+
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <bit>
+#include <algorithm>
+#include <utility>
+
+#include "Game/Move.h"
+
+namespace
+{
+    // Layout of the data word of an entry
+    constexpr auto move_shift = 32;
+    constexpr auto draft_shift = 48;
+    constexpr auto bound_shift = 56;
+    constexpr auto age_shift = 58;
+    constexpr uint64_t draft_mask = 0xFF;
+    constexpr uint64_t bound_mask = 0x3;
+    constexpr uint64_t age_mask = 0x3F;
+
+    // An age of zero is never used so that an empty slot never looks like an entry.
+    constexpr uint64_t maximum_age = age_mask;
+}
+
+Transposition_Table::Transposition_Table(const size_t megabytes_in) noexcept : megabytes(megabytes_in)
+{
+}
+
+Transposition_Table::Transposition_Table(const Transposition_Table& other) noexcept : Transposition_Table(other.megabytes)
+{
+}
+
+Transposition_Table& Transposition_Table::operator=(const Transposition_Table& other) noexcept
+{
+    resize(other.megabytes);
+    return *this;
+}
+
+void Transposition_Table::resize(const size_t megabytes_in) noexcept
+{
+    megabytes = megabytes_in;
+    clear();
+}
+
+size_t Transposition_Table::size_in_megabytes() const noexcept
+{
+    return megabytes;
+}
+
+void Transposition_Table::start_search() noexcept
+{
+    if( ! buckets)
+    {
+        // Use a smaller table if there is not enough memory for the requested size.
+        bucket_count = std::bit_floor(std::max(size_t{1}, (megabytes << 20)/sizeof(Bucket)));
+        buckets.reset(new(std::nothrow) Bucket[bucket_count]());
+        while( ! buckets && bucket_count > 1)
+        {
+            bucket_count /= 2;
+            buckets.reset(new(std::nothrow) Bucket[bucket_count]());
+        }
+    }
+
+    age = age % maximum_age + 1;
+}
+
+void Transposition_Table::clear() noexcept
+{
+    buckets.reset();
+    bucket_count = 0;
+}
+
+std::optional<Transposition_Table::Entry> Transposition_Table::probe(const uint64_t hash) const noexcept
+{
+    if( ! buckets)
+    {
+        return {};
+    }
+
+    auto& bucket = bucket_for(hash);
+    for(const auto slot : {&bucket.depth_preferred, &bucket.always_replace})
+    {
+        const auto data = slot->data.load(std::memory_order_relaxed);
+        if(data != 0 && (slot->checked_key.load(std::memory_order_relaxed) ^ data) == hash)
+        {
+            return unpack(data);
+        }
+    }
+
+    return {};
+}
+
+void Transposition_Table::store(const uint64_t hash, const Entry& entry) noexcept
+{
+    if( ! buckets)
+    {
+        return;
+    }
+
+    auto& bucket = bucket_for(hash);
+    const auto data = pack(entry);
+    const auto old_data = bucket.depth_preferred.data.load(std::memory_order_relaxed);
+    const auto same_position = (bucket.depth_preferred.checked_key.load(std::memory_order_relaxed) ^ old_data) == hash;
+    auto& slot = (same_position || age_of(old_data) != age || entry.draft >= draft_of(old_data)) ? bucket.depth_preferred : bucket.always_replace;
+    slot.checked_key.store(hash ^ data, std::memory_order_relaxed);
+    slot.data.store(data, std::memory_order_relaxed);
+}
+
+Transposition_Table::Bucket& Transposition_Table::bucket_for(const uint64_t hash) const noexcept
+{
+    return buckets[hash & (bucket_count - 1)];
+}
+
+uint64_t Transposition_Table::pack(const Entry& entry) const noexcept
+{
+    const auto move_code = entry.best_move ? entry.best_move->code() : Move::code_t{0};
+    return uint64_t{std::bit_cast<uint32_t>(entry.score.centipawns())}
+        | (uint64_t{move_code} << move_shift)
+        | (std::min(uint64_t(entry.draft), draft_mask) << draft_shift)
+        | (uint64_t(std::to_underlying(entry.bound)) << bound_shift)
+        | (age << age_shift);
+}
+
+Transposition_Table::Entry Transposition_Table::unpack(const uint64_t data) noexcept
+{
+    const auto move_code = Move::code_t(data >> move_shift);
+    return {Score{std::bit_cast<Score::value_type>(uint32_t(data))},
+            static_cast<Score_Bound>((data >> bound_shift) & bound_mask),
+            draft_of(data),
+            move_code == 0 ? nullptr : &Move::from_code(move_code)};
+}
+
+size_t Transposition_Table::draft_of(const uint64_t data) noexcept
+{
+    return size_t((data >> draft_shift) & draft_mask);
+}
+
+uint64_t Transposition_Table::age_of(const uint64_t data) noexcept
+{
+    return (data >> age_shift) & age_mask;
+}
@@ -0,0 +1,130 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <atomic>
+#include <optional>
+
+#include "Players/Score.h"
+
+class Move;
+
+//! \file
+
+//! \brief Indicates how a stored score relates to the true score of a position.
+enum class Score_Bound
+{
+    EXACT,
+    LOWER,
+    UPPER
+};
+
+//! \brief A cache of the results of searching board positions, keyed by Zobrist hash.
+//!
+//! The table is divided into buckets of two entries. The first entry of each bucket
+//! keeps the result of the deepest search of a position from the current search (a
+//! depth-preferred entry), and the second entry is always overwritten with the newest
+//! result that did not fit in the first.
+//!
+//! Each entry is stored as two 64-bit words: the data and the position hash XOR'd with
+//! the data. If two threads write to the same entry at the same time, the mismatched
+//! words will fail the hash check when read, so no locks are needed.
+//!
+//! Memory for the table is not allocated until the first search starts, and copies of a
+//! table start empty, so idle players do not use much memory.
+class Transposition_Table
+{
+    public:
+        //! \brief The size of the table in megabytes if no other size is given.
+        static constexpr size_t default_size_in_megabytes = 16;
+
+        //! \brief The information stored for a board position.
+        struct Entry
+        {
+            //! \brief The score of the position from the perspective of the player to move.
+            Score score;
+
+            //! \brief Whether the score is exact or a bound on the exact value.
+            Score_Bound bound;
+
+            //! \brief How many plies were searched beyond the position to get the score.
+            size_t draft;
+
+            //! \brief The best move found in the position, or nullptr if there was none.
+            const Move* best_move;
+        };
+
+        //! \brief Create an empty table.
+        //!
+        //! \param megabytes The size of the table. The actual size will be the largest power
+        //!        of two number of buckets that fits.
+        explicit Transposition_Table(size_t megabytes = default_size_in_megabytes) noexcept;
+
+        //! \brief Create an empty table with the same size as another.
+        //!
+        //! The stored results are not copied.
+        Transposition_Table(const Transposition_Table& other) noexcept;
+
+        //! \brief Empty the table and take on the size of another table.
+        //!
+        //! The stored results are not copied.
+        Transposition_Table& operator=(const Transposition_Table& other) noexcept;
+
+        //! \brief Change the size of the table.
+        //!
+        //! All stored results are lost.
+        //! \param megabytes The new size.
+        void resize(size_t megabytes) noexcept;
+
+        //! \brief The size of the table in megabytes.
+        size_t size_in_megabytes() const noexcept;
+
+        //! \brief Prepare for a new search, allocating memory if needed.
+        //!
+        //! Entries from previous searches are kept, but they will be replaced before
+        //! entries from the new search.
+        void start_search() noexcept;
+
+        //! \brief Delete all entries and release the table's memory.
+        void clear() noexcept;
+
+        //! \brief Look up a board position.
+        //!
+        //! \param hash The Zobrist hash of the position.
+        //! \returns The stored entry for the position, if any.
+        std::optional<Entry> probe(uint64_t hash) const noexcept;
+
+        //! \brief Store the result of a search.
+        //!
+        //! \param hash The Zobrist hash of the position.
+        //! \param entry The result of the search.
+        void store(uint64_t hash, const Entry& entry) noexcept;
+
+    private:
+        struct Slot
+        {
+            std::atomic<uint64_t> checked_key{0};
+            std::atomic<uint64_t> data{0};
+        };
+
+        struct Bucket
+        {
+            Slot depth_preferred;
+            Slot always_replace;
+        };
+
+        size_t megabytes;
+        size_t bucket_count = 0;
+        std::unique_ptr<Bucket[]> buckets;
+        uint64_t age = 0;
+
+        Bucket& bucket_for(uint64_t hash) const noexcept;
+        uint64_t pack(const Entry& entry) const noexcept;
+        static Entry unpack(uint64_t data) noexcept;
+        static size_t draft_of(uint64_t data) noexcept;
+        static uint64_t age_of(uint64_t data) noexcept;
+};
+
+#endif // TRANSPOSITION_TABLE_H
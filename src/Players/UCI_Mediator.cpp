@@ -9,6 +9,7 @@ using namespace std::chrono_literals;
 #include <ranges>
 
 #include "Players/Player.h"
+#include "Players/Transposition_Table.h"
 #include "Game/Board.h"
 #include "Game/Clock.h"
 #include "Game/Game_Result.h"
@@ -22,12 +23,16 @@ UCI_Mediator::UCI_Mediator(const Player& player, const bool enable_logging) : Ou
     send_command("id name {}", player.name());
     send_command("id author {}", player.author());
     send_command("option name UCI_Opponent type string");
+    send_command("option name Hash type spin default {} min 1 max 65536", Transposition_Table::default_size_in_megabytes);
+    send_command("option name Threads type spin default 1 min 1 max 512");
+    send_command("option name Ponder type check default true");
     send_command("uciok");
 }
 
 Game_Result UCI_Mediator::setup_turn(Board& board, Clock& clock, std::vector<const Move*>& move_list, const Player& player)
 {
     Game_Result setup_result;
+    auto pondering = false;
 
     try
     {
@@ -35,7 +40,11 @@ Game_Result UCI_Mediator::setup_turn(Board& board, Clock& clock, std::vector<con
         {
             const auto command = receive_uci_command(false);
 
-            Player::pick_move_now(); // Stop pondering
+            if(command != "ponderhit" && command != "stop")
+            {
+                player.stop_pondering();
+                pondering = false;
+            }
 
             if(command == "ucinewgame")
             {
@@ -64,6 +73,32 @@ Game_Result UCI_Mediator::setup_turn(Board& board, Clock& clock, std::vector<con
                     log("Opponent's name: {}", name);
                 }
             }
+            else if(command.starts_with("setoption name Hash value "))
+            {
+                try
+                {
+                    const auto megabytes = String::to_number<size_t>(String::split(command).back());
+                    player.set_transposition_table_size(megabytes);
+                    log("Transposition table size set to {} MB", megabytes);
+                }
+                catch(const std::invalid_argument&)
+                {
+                    log("Malformed Hash option line: {}", command);
+                }
+            }
+            else if(command.starts_with("setoption name Threads value "))
+            {
+                try
+                {
+                    const auto thread_count = String::to_number<size_t>(String::split(command).back());
+                    player.set_search_thread_count(thread_count);
+                    log("Search thread count set to {}", thread_count);
+                }
+                catch(const std::invalid_argument&)
+                {
+                    log("Malformed Threads option line: {}", command);
+                }
+            }
             else if(command.starts_with("position "))
             {
                 const auto parse = String::split(command);
@@ -76,6 +111,7 @@ Game_Result UCI_Mediator::setup_turn(Board& board, Clock& clock, std::vector<con
                     const auto fen_begin = std::next(parse.begin(), 2);
                     board = Board(String::join(std::views::counted(fen_begin, 6), " "));
                 }
+                record_game_positions(board);
 
                 move_list.clear();
                 const auto moves_iter = std::ranges::find(parse, "moves");
@@ -107,7 +143,9 @@ Game_Result UCI_Mediator::setup_turn(Board& board, Clock& clock, std::vector<con
                 auto binc = clock.increment(Piece_Color::BLACK);
                 auto movestogo = size_t{0};
                 auto movetime = clock.initial_time();
-                auto search_moves = std::vector<const Move*>();
+                auto nodes = size_t{0};
+                auto search_moves = Board::move_list();
+                auto ponder = false;
 
                 std::string parameter;
                 for(const auto& token : String::split(command))
@@ -117,6 +155,12 @@ Game_Result UCI_Mediator::setup_turn(Board& board, Clock& clock, std::vector<con
                         continue;
                     }
 
+                    if(token == "ponder")
+                    {
+                        ponder = true;
+                        continue;
+                    }
+
                     if(parameter.empty())
                     {
                         parameter = token;
@@ -136,6 +180,14 @@ Game_Result UCI_Mediator::setup_turn(Board& board, Clock& clock, std::vector<con
                         continue;
                     }
 
+                    if(parameter == "nodes")
+                    {
+                        nodes = String::to_number<size_t>(token);
+                        log("Limiting search to {} nodes", nodes);
+                        parameter.clear();
+                        continue;
+                    }
+
                     const auto number = String::to_number<int>(token);
                     if(parameter == "wtime")
                     {
@@ -181,7 +233,11 @@ Game_Result UCI_Mediator::setup_turn(Board& board, Clock& clock, std::vector<con
                     parameter.clear();
                 }
 
-                if(new_mode != mode || ! clock.is_running())
+                if(nodes > 0)
+                {
+                    clock = Clock::node_budget(0, nodes, clock.game_start_date_and_time());
+                }
+                else if(new_mode != mode || ! clock.is_running() || clock.limits_nodes())
                 {
                     if(new_mode == Time_Reset_Method::ADDITION)
                     {
@@ -219,12 +275,33 @@ Game_Result UCI_Mediator::setup_turn(Board& board, Clock& clock, std::vector<con
                 if( ! search_moves.empty())
                 {
                     board.legal_moves_cache = search_moves;
+                    board.legal_moves_cache_is_stale = false;
+                }
+
+                if(ponder)
+                {
+                    log("Pondering the opponent's expected move");
+                    player.ponder(board, clock);
+                    pondering = true;
+                    continue;
                 }
 
                 log("Telling AI to choose a move at leisure");
                 Player::choose_move_at_leisure();
                 return setup_result;
             }
+            else if(command == "ponderhit" && pondering)
+            {
+                log("Opponent played the expected move, continuing search");
+                Player::choose_move_at_leisure();
+                return setup_result;
+            }
+            else if(command == "stop" && pondering)
+            {
+                log("Stopping pondering and sending best move so far");
+                Player::pick_move_now();
+                return setup_result;
+            }
         }
     }
     catch(const Game_Ended& game_ending_error)
@@ -235,11 +312,21 @@ Game_Result UCI_Mediator::setup_turn(Board& board, Clock& clock, std::vector<con
 
 Game_Result UCI_Mediator::handle_move(Board& board,
                                       const Move& move,
-                                      std::vector<const Move*>& move_list) const
+                                      std::vector<const Move*>& move_list,
+                                      const Player& player) const
 {
-    send_command("bestmove {}", move.coordinates());
     move_list.push_back(&move);
-    return board.play_move(move);
+    const auto result = board.play_move(move);
+    const auto expected_response = result.game_has_ended() ? nullptr : player.expected_response(board);
+    if(expected_response)
+    {
+        send_command("bestmove {} ponder {}", move.coordinates(), expected_response->coordinates());
+    }
+    else
+    {
+        send_command("bestmove {}", move.coordinates());
+    }
+    return result;
 }
 
 std::string UCI_Mediator::listener(Clock&)
@@ -265,7 +352,7 @@ std::string UCI_Mediator::receive_uci_command(bool while_listening)
         {
             send_command("readyok");
         }
-        else if(command == "stop")
+        else if(command == "stop" && while_listening)
         {
             log("Stopping local AI thinking");
             Player::pick_move_now();
@@ -29,7 +29,8 @@ class UCI_Mediator : public Outside_Communicator
                                const Player& player) override;
         Game_Result handle_move(Board& board,
                                 const Move& move,
-                                std::vector<const Move*>& move_list) const override;
+                                std::vector<const Move*>& move_list,
+                                const Player& player) const override;
 
     private:
         std::string listener(Clock& clock) override;
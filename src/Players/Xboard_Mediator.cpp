@@ -33,6 +33,8 @@ Xboard_Mediator::Xboard_Mediator(const Player& local_player, const bool enable_l
                      "ping=1 "
                      "setboard=1 "
                      "colors=0 "
+                     "memory=1 "
+                     "smp=1 "
                      "done=1", local_player.name());
     }
     else
@@ -51,13 +53,30 @@ Game_Result Xboard_Mediator::setup_turn(Board& board, Clock& clock, std::vector<
     std::optional<Clock::seconds> opponent_time_left;
     Game_Result setup_result;
 
+    if(pondering_allowed && ! in_force_mode)
+    {
+        const auto expected_response = player.expected_response(board);
+        if(expected_response)
+        {
+            auto ponder_board = board;
+            if( ! ponder_board.play_move(*expected_response).game_has_ended())
+            {
+                log("Pondering expected move: {}", expected_response->coordinates());
+                player.ponder(ponder_board, clock);
+            }
+        }
+    }
+
     try
     {
         while(true)
         {
             const auto command = receive_xboard_command(clock, false);
 
-            Player::pick_move_now(); // Stop pondering
+            if( ! may_continue_pondering(command, board))
+            {
+                player.stop_pondering();
+            }
 
             if(command.starts_with("ping "))
             {
@@ -73,6 +92,7 @@ Game_Result Xboard_Mediator::setup_turn(Board& board, Clock& clock, std::vector<
             {
                 log("Setting board to standard start position and resetting clock");
                 board = Board{};
+                record_game_positions(board);
                 clock = Clock(clock.initial_time(), clock.moves_per_time_period(), clock.increment(Piece_Color::WHITE), clock.reset_mode());
                 own_time_left.reset();
                 opponent_time_left.reset();
@@ -81,6 +101,42 @@ Game_Result Xboard_Mediator::setup_turn(Board& board, Clock& clock, std::vector<
                 player.reset();
                 in_force_mode = false;
             }
+            else if(command == "hard")
+            {
+                log("Pondering on opponent's time");
+                pondering_allowed = true;
+            }
+            else if(command == "easy")
+            {
+                log("Not pondering on opponent's time");
+                pondering_allowed = false;
+            }
+            else if(command.starts_with("memory "))
+            {
+                try
+                {
+                    const auto megabytes = String::to_number<size_t>(String::split(command).back());
+                    player.set_transposition_table_size(megabytes);
+                    log("Transposition table size set to {} MB", megabytes);
+                }
+                catch(const std::invalid_argument&)
+                {
+                    send_error(command, "Invalid memory size");
+                }
+            }
+            else if(command.starts_with("cores "))
+            {
+                try
+                {
+                    const auto thread_count = String::to_number<size_t>(String::split(command).back());
+                    player.set_search_thread_count(thread_count);
+                    log("Search thread count set to {}", thread_count);
+                }
+                catch(const std::invalid_argument&)
+                {
+                    send_error(command, "Invalid number of cores");
+                }
+            }
             else if(command.starts_with("name "))
             {
                 const auto name = String::split(command, " ", 1).back();
@@ -101,6 +157,7 @@ Game_Result Xboard_Mediator::setup_turn(Board& board, Clock& clock, std::vector<
                     {
                         log("Rearranging board to: {}", fen);
                         board = new_board;
+                        record_game_positions(board);
                         move_list.clear();
                         setup_result = {};
                     }
@@ -283,6 +340,7 @@ bool Xboard_Mediator::undo_move(std::vector<const Move*>& move_list, const std::
         player.undo_move(board.last_move());
         move_list.pop_back();
         auto new_board = Board(board.original_fen());
+        record_game_positions(new_board);
         for(auto move : move_list)
         {
             new_board.play_move(*move);
@@ -293,7 +351,7 @@ bool Xboard_Mediator::undo_move(std::vector<const Move*>& move_list, const std::
     }
 }
 
-Game_Result Xboard_Mediator::handle_move(Board& board, const Move& move, std::vector<const Move*>& move_list) const
+Game_Result Xboard_Mediator::handle_move(Board& board, const Move& move, std::vector<const Move*>& move_list, const Player&) const
 {
     if(in_force_mode)
     {
@@ -348,6 +406,17 @@ std::string Xboard_Mediator::receive_xboard_command(Clock& clock, bool while_lis
     }
 }
 
+bool Xboard_Mediator::may_continue_pondering(const std::string& command, const Board& board) const noexcept
+{
+    return ! in_force_mode &&
+           (command.starts_with("ping ") ||
+            command.starts_with("time ") ||
+            command.starts_with("otim ") ||
+            command.starts_with("usermove ") ||
+            command == "hard" ||
+            ( ! usermove_prefix && board.is_legal_move(command)));
+}
+
 void Xboard_Mediator::send_error(const std::string& command, const std::string& reason) const noexcept
 {
     send_command("Error ({}): {}", reason, command);
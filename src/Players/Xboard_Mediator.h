@@ -31,15 +31,18 @@ class Xboard_Mediator : public Outside_Communicator
                                const Player& player) override;
         Game_Result handle_move(Board& board,
                                 const Move& move,
-                                std::vector<const Move*>& move_list) const override;
+                                std::vector<const Move*>& move_list,
+                                const Player& player) const override;
 
     private:
         bool in_force_mode = true;
         bool usermove_prefix = true;
+        bool pondering_allowed = false;
 
         std::string receive_xboard_command(Clock& clock, bool while_listening);
         bool undo_move(std::vector<const Move*>& move_list, const std::string& command, Board& board, Clock& clock, const Player& player);
         void send_error(const std::string& command, const std::string& reason) const noexcept;
+        bool may_continue_pondering(const std::string& command, const Board& board) const noexcept;
         std::string listener(Clock& clock) override;
         void report_end_of_game(const Game_Result& ending) const noexcept;
 };
@@ -18,6 +18,11 @@ using namespace std::chrono_literals;
 #include <format>
 #include <ranges>
 #include <type_traits>
+#include <future>
+#include <stdexcept>
+#include <random>
+#include <vector>
+#include <array>
 
 #include "Game/Board.h"
 #include "Game/Clock.h"
@@ -25,10 +30,16 @@ using namespace std::chrono_literals;
 #include "Game/Piece.h"
 #include "Game/Square.h"
 #include "Game/Move.h"
+#include "Game/Bitboard.h"
+#include "Game/Move_Generator.h"
+#include "Game/Position_History.h"
 
 #include "Players/Genetic_AI.h"
 #include "Players/Game_Tree_Node_Result.h"
 #include "Players/Alpha_Beta_Value.h"
+#include "Players/Score.h"
+#include "Players/Transposition_Table.h"
+#include "Players/Evaluation_Cache.h"
 
 #include "Genes/Castling_Possible_Gene.h"
 #include "Genes/Freedom_To_Move_Gene.h"
@@ -43,12 +54,49 @@ using namespace std::chrono_literals;
 #include "Genes/Checkmate_Material_Gene.h"
 #include "Genes/Pawn_Structure_Gene.h"
 #include "Genes/Move_Sorting_Gene.h"
+#include "Genes/Genome.h"
 
 #include "Utility/String.h"
 #include "Utility/Random.h"
 #include "Utility/Math.h"
 #include "Utility/Exceptions.h"
 #include "Utility/Algorithm.h"
+#include "Utility/Thread_Pool.h"
+
+#ifdef COUNT_ALLOCATIONS
+#include <atomic>
+#include <new>
+
+// Building with COUNT_ALLOCATIONS defined replaces the global allocation functions
+// so that tests can check how often memory is allocated.
+namespace
+{
+    std::atomic<size_t> allocation_count = 0;
+}
+
+void* operator new(const size_t size)
+{
+    ++allocation_count;
+    if(const auto memory = std::malloc(size == 0 ? 1 : size))
+    {
+        return memory;
+    }
+
+    throw std::bad_alloc();
+}
+
+// Keeping the compiler from inlining the deallocation prevents a false warning about
+// freeing memory from operator new.
+[[gnu::noinline]] void operator delete(void* const memory) noexcept
+{
+    std::free(memory);
+}
+
+[[gnu::noinline]] void operator delete(void* const memory, size_t) noexcept
+{
+    std::free(memory);
+}
+#endif // COUNT_ALLOCATIONS
 
 namespace
 {
@@ -195,12 +243,14 @@ namespace
     }
 
     bool files_are_identical(const std::string& file_name1, const std::string& file_name2) noexcept;
-    size_t move_count(const Board& board, size_t maximum_depth) noexcept;
+    size_t move_count(Board& board, size_t maximum_depth) noexcept;
     bool run_board_tests(const std::string& file_name, int line_number = -1);
     bool all_moves_legal(Board& board, const std::vector<std::string>& moves) noexcept;
     bool move_is_illegal(const Board& board, const std::string& move) noexcept;
 
     void move_attack_indices_are_consistenly_defined(bool& tests_passed);
+    void packed_move_codes_retrieve_the_same_move(bool& tests_passed);
+    void move_lists_are_grouped_by_direction_and_ordered_by_distance(bool& tests_passed);
 
     void squares_with_unique_coordinates_have_unique_indices(bool& tests_passed);
     void constructed_squares_retain_coordinates(bool& tests_passed);
@@ -213,9 +263,15 @@ namespace
     void algebraic_notation_resolves_ambiguous_moves(bool& tests_passed);
 
     void repeating_board_position_three_times_results_in_threefold_game_result(bool& tests_passed);
+    void searching_a_board_copy_does_not_change_repetition_history(bool& tests_passed);
+    void boards_with_separate_histories_count_repetitions_independently(bool& tests_passed);
     void one_hundred_ply_with_no_pawn_or_capture_move_yields_fifty_move_game_result(bool& tests_passed);
 
     void derived_moves_applied_to_earlier_board_result_in_later_board(bool& tests_passed);
+    void unmaking_a_move_restores_the_board(bool& tests_passed);
+    void staged_move_generation_matches_legal_moves(bool& tests_passed);
+    void material_counts_match_board_contents(bool& tests_passed);
+    void piece_squares_match_board_contents(bool& tests_passed);
     void identical_boards_have_identical_hashes(bool& tests_passed);
     void boards_with_different_en_passant_targets_have_different_hashes(bool& tests_passed);
 
@@ -226,6 +282,9 @@ namespace
     void correctly_detects_checking_moves(bool& tests_passed, const std::string& fen, const std::string& move_text);
 
     void genome_loaded_from_file_writes_identical_file(bool& tests_passed);
+    void genome_calibration_is_repeatable_and_saved_to_cache_file(bool& tests_passed);
+    void offspring_created_on_other_threads_use_reserved_ids(bool& tests_passed);
+    void thread_pool_runs_every_task_once(bool& tests_passed);
     void self_swapped_minimax_ai_is_unchanged(bool& tests_passed);
     void self_assigned_minimax_ai_is_unchanged(bool& tests_passed);
 
@@ -250,12 +309,25 @@ namespace
 
     void specified_time_added_to_clock_after_specified_number_of_punches(bool& tests_passed);
     void clock_with_increment_gets_time_added_on_every_punch(bool& tests_passed);
+    void node_budget_clock_uses_move_allowance_before_game_budget(bool& tests_passed);
+    void thread_cpu_time_clock_only_counts_time_running_on_processor(bool& tests_passed);
 
     void midgame_node_result_values_compare_correctly(bool& tests_passed);
     void midgame_alpha_beta_values_compare_correctly_with_node_values(bool& tests_passed);
     void alpha_beta_result_values_compare_in_line_with_algorithm(bool& tests_passed);
     void alpha_and_beta_value_comparisons_fit_algorithm_definitions(bool& tests_passed);
     void endgame_node_result_tests(bool& tests_passed);
+    void scores_encode_checkmate_distance_beyond_all_centipawn_scores(bool& tests_passed);
+    void transposition_table_keeps_deepest_and_newest_entries(bool& tests_passed);
+    void evaluation_cache_stores_scores_by_position_and_side_to_move(bool& tests_passed);
+    void cached_genome_evaluation_matches_full_evaluation(bool& tests_passed);
+    void mutating_a_genetic_ai_discards_stored_search_results(bool& tests_passed);
+    void multithreaded_search_finds_checkmate(bool& tests_passed);
+    void pondering_search_continues_after_expected_move(bool& tests_passed);
+#ifdef COUNT_ALLOCATIONS
+    void search_does_not_allocate_memory_per_node(bool& tests_passed);
+#endif
+    void search_with_node_budget_is_repeatable(bool& tests_passed);
 
     void average_moves_left_matches_precalculated_value(bool& tests_passed);
     void average_moves_left_returns_finite_result_after_zero_moves(bool& tests_passed);
@@ -266,6 +338,8 @@ namespace
     void has_exactly_n_works_as_advertised(bool& tests_passed);
 
     void probability_check(bool& tests_passed);
+    void random_generator_matches_reference_output(bool& tests_passed);
+    void seeded_random_numbers_are_repeatable_on_every_thread(bool& tests_passed);
     void list_moves_on_board(const Board& board, std::vector<const Move*>& moves_played, size_t depth) noexcept;
 }
 
@@ -274,6 +348,8 @@ bool run_tests()
     bool tests_passed = true;
 
     move_attack_indices_are_consistenly_defined(tests_passed);
+    packed_move_codes_retrieve_the_same_move(tests_passed);
+    move_lists_are_grouped_by_direction_and_ordered_by_distance(tests_passed);
 
     pieces_can_be_constructed_from_piece_data(tests_passed);
     pieces_can_be_constructed_from_fen_symbols(tests_passed);
@@ -289,9 +365,15 @@ bool run_tests()
     algebraic_notation_resolves_ambiguous_moves(tests_passed);
 
     repeating_board_position_three_times_results_in_threefold_game_result(tests_passed);
+    searching_a_board_copy_does_not_change_repetition_history(tests_passed);
+    boards_with_separate_histories_count_repetitions_independently(tests_passed);
     one_hundred_ply_with_no_pawn_or_capture_move_yields_fifty_move_game_result(tests_passed);
 
     derived_moves_applied_to_earlier_board_result_in_later_board(tests_passed);
+    unmaking_a_move_restores_the_board(tests_passed);
+    staged_move_generation_matches_legal_moves(tests_passed);
+    material_counts_match_board_contents(tests_passed);
+    piece_squares_match_board_contents(tests_passed);
     identical_boards_have_identical_hashes(tests_passed);
     boards_with_different_en_passant_targets_have_different_hashes(tests_passed);
 
@@ -305,6 +387,9 @@ bool run_tests()
     correctly_detects_checking_moves(tests_passed, "k7/8/8/8/8/8/8/K4B2 w - - 0 1", "Bh3");
 
     genome_loaded_from_file_writes_identical_file(tests_passed);
+    genome_calibration_is_repeatable_and_saved_to_cache_file(tests_passed);
+    offspring_created_on_other_threads_use_reserved_ids(tests_passed);
+    thread_pool_runs_every_task_once(tests_passed);
     self_swapped_minimax_ai_is_unchanged(tests_passed);
     self_assigned_minimax_ai_is_unchanged(tests_passed);
 
@@ -373,16 +458,31 @@ bool run_tests()
 
     specified_time_added_to_clock_after_specified_number_of_punches(tests_passed);
     clock_with_increment_gets_time_added_on_every_punch(tests_passed);
+    node_budget_clock_uses_move_allowance_before_game_budget(tests_passed);
+    thread_cpu_time_clock_only_counts_time_running_on_processor(tests_passed);
 
     midgame_node_result_values_compare_correctly(tests_passed);
     midgame_alpha_beta_values_compare_correctly_with_node_values(tests_passed);
     alpha_beta_result_values_compare_in_line_with_algorithm(tests_passed);
     alpha_and_beta_value_comparisons_fit_algorithm_definitions(tests_passed);
     endgame_node_result_tests(tests_passed);
+    scores_encode_checkmate_distance_beyond_all_centipawn_scores(tests_passed);
+    transposition_table_keeps_deepest_and_newest_entries(tests_passed);
+    evaluation_cache_stores_scores_by_position_and_side_to_move(tests_passed);
+    cached_genome_evaluation_matches_full_evaluation(tests_passed);
+    mutating_a_genetic_ai_discards_stored_search_results(tests_passed);
+    multithreaded_search_finds_checkmate(tests_passed);
+    pondering_search_continues_after_expected_move(tests_passed);
+#ifdef COUNT_ALLOCATIONS
+    search_does_not_allocate_memory_per_node(tests_passed);
+#endif
+    search_with_node_budget_is_repeatable(tests_passed);
 
     scoped_push_back_works_as_advertised(tests_passed);
     has_exactly_n_works_as_advertised(tests_passed);
     probability_check(tests_passed);
+    random_generator_matches_reference_output(tests_passed);
+    seeded_random_numbers_are_repeatable_on_every_thread(tests_passed);
 
 
     std::println("{}", tests_passed ? "All tests passed." : "Tests failed.");
@@ -412,7 +512,9 @@ void run_speed_tests()
     auto pawn_structure_gene = Pawn_Structure_Gene();
     pawn_structure_gene.read_from(test_genes_file_name);
 
+    Position_History performance_history;
     auto performance_board = Board();
+    performance_board.use_position_history(performance_history);
     for(const auto& move : String::split("e4 e6 d4 h5 d5 b5 Qf3 g6 Be2 Bg7 Bd2 h4 Nh3 Na6 Nc3 b4 Nf4 Nc5 Nd3 Na4 Ne5 Nb6 Qd3 Qe7 Qe3 Ba6 Qf3 Nf6 Qe3 h3 Qf4 Qc5 Qf3 Qe7 O-O-O"))
     {
         performance_board.play_move(move);
@@ -460,7 +562,9 @@ void run_speed_tests()
 
     std::println("Board::play_move() speed ...");
     const auto game_time_start = std::chrono::steady_clock::now();
+    Position_History speed_history;
     Board speed_board;
+    speed_board.use_position_history(speed_history);
     const auto speed_board_spare = speed_board;
     for(auto i = 0; i < number_of_tests; ++i)
     {
@@ -476,7 +580,9 @@ void run_speed_tests()
 
     std::println("Board::play_move() with copy speed ...");
     const auto copy_game_start = std::chrono::steady_clock::now();
+    Position_History copy_speed_history;
     Board copy_speed_board;
+    copy_speed_board.use_position_history(copy_speed_history);
     for(auto i = 0; i < number_of_tests; ++i)
     {
         const auto move = Random::random_element(copy_speed_board.legal_moves());
@@ -485,6 +591,7 @@ void run_speed_tests()
         if(move_result.game_has_ended())
         {
             copy_speed_board = Board{};
+            copy_speed_board.use_position_history(copy_speed_history);
         }
         else
         {
@@ -493,11 +600,73 @@ void run_speed_tests()
     }
     timing_results.emplace_back(std::chrono::steady_clock::now() - copy_game_start, "Board::play_move() with copy");
 
+    std::println("Board copy speed ...");
+    Position_History board_copy_history;
+    auto board_copies = std::vector<Board>(16);
+    board_copies.front().use_position_history(board_copy_history);
+    for(auto i = 0; i < 20 && ! board_copies.front().no_legal_moves(); ++i)
+    {
+        board_copies.front().play_move(*Random::random_element(board_copies.front().legal_moves()));
+    }
+    const auto board_copy_start = std::chrono::steady_clock::now();
+    for(auto i = 1; i < number_of_tests; ++i)
+    {
+        const auto board_copy = board_copies[size_t(i - 1) % board_copies.size()];
+        board_copies[size_t(i) % board_copies.size()] = board_copy;
+    }
+    timing_results.emplace_back(std::chrono::steady_clock::now() - board_copy_start, std::format("Board copy ({} bytes)", sizeof(Board)));
+
+    std::print("Piece move list speed ... ");
+    std::cout.flush();
+    const auto& move_list_board = performance_board;
+    const auto& move_list_moves = move_list_board.legal_moves();
+    size_t moves_found = 0;
+    const auto can_move_start = std::chrono::steady_clock::now();
+    for(auto i = 0; i < number_of_tests; ++i)
+    {
+        const auto move = move_list_moves[size_t(i) % move_list_moves.size()];
+        moves_found += move_list_board.piece_on_square(move->start()).can_move(move) ? 1 : 0;
+    }
+    timing_results.emplace_back(std::chrono::steady_clock::now() - can_move_start, "Piece::can_move()");
+
+    size_t checking_moves = 0;
+    const auto checks_king_start = std::chrono::steady_clock::now();
+    for(auto i = 0; i < number_of_tests; ++i)
+    {
+        const auto move = move_list_moves[size_t(i) % move_list_moves.size()];
+        checking_moves += move_list_board.move_checks_king(*move) ? 1 : 0;
+    }
+    timing_results.emplace_back(std::chrono::steady_clock::now() - checks_king_start, "Board::move_checks_king()");
+    std::println("(moves found = {}, checking moves = {})", String::format_number(moves_found), String::format_number(checking_moves));
+
+    std::println("Board::make_move() and unmake_move() speed ...");
+    const auto make_unmake_start = std::chrono::steady_clock::now();
+    Position_History make_unmake_history;
+    Board make_unmake_board;
+    make_unmake_board.use_position_history(make_unmake_history);
+    Board::Undo_Record undo;
+    for(auto i = 0; i < number_of_tests; ++i)
+    {
+        const auto move = Random::random_element(make_unmake_board.legal_moves());
+        auto move_result = make_unmake_board.make_move(*move, undo);
+        make_unmake_board.unmake_move(undo);
+        move_result = make_unmake_board.play_move(*move);
+        if(move_result.game_has_ended())
+        {
+            make_unmake_board = Board{};
+            make_unmake_board.use_position_history(make_unmake_history);
+        }
+    }
+    timing_results.emplace_back(std::chrono::steady_clock::now() - make_unmake_start, "Board::make_move() and unmake_move()");
+
     std::print("Board::quiescent() speed ... ");
     std::cout.flush();
     const auto quiescent_time_start = std::chrono::steady_clock::now();
+    Position_History quiescent_history;
     Board quiescent_board;
+    quiescent_board.use_position_history(quiescent_history);
     size_t move_count = 0;
+    size_t quiescent_capture_count = 0;
     for(auto i = 0; i < number_of_tests; ++i)
     {
         while(true)
@@ -508,6 +677,7 @@ void run_speed_tests()
             if(move_result.game_has_ended())
             {
                 quiescent_board = Board{};
+                quiescent_board.use_position_history(quiescent_history);
             }
             else if(quiescent_board.attacked_by(move->end(), quiescent_board.whose_turn()))
             {
@@ -515,11 +685,11 @@ void run_speed_tests()
             }
         }
 
-        const auto quiescent_result_board = quiescent_board.quiescent({1.0, 5.0, 3.0, 3.0, 8.0, 100.0});
+        quiescent_capture_count += quiescent_board.quiescent({1.0, 5.0, 3.0, 3.0, 8.0, 100.0}).size();
     }
     const auto quiescent_time = std::chrono::steady_clock::now() - quiescent_time_start;
     timing_results.emplace_back(quiescent_time - (board_play_move_time*move_count)/number_of_tests, "Board::quiescent()");
-    std::println("(non-quiescent moves = {})", String::format_number(move_count));
+    std::println("(non-quiescent moves = {}, quiescent captures = {})", String::format_number(move_count), String::format_number(quiescent_capture_count));
 
     std::ranges::sort(timing_results);
     const auto name_width =
@@ -536,6 +706,44 @@ void run_speed_tests()
     {
         std::println("{:{}} = {}", name, name_width, std::chrono::duration<double>(time).count());
     }
+
+    std::println("\nSearch speed with multiple threads ...");
+    const auto search_fens = {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/2KR3R b kq - 5 18",
+                              "r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP1B1PPP/R2QKB1R w KQ - 3 9",
+                              "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"};
+#ifdef NDEBUG
+    const auto search_time = Clock::seconds{10.0};
+#else
+    const auto search_time = Clock::seconds{2.0};
+#endif // NDEBUG
+    const auto search_genome_file_name = "genome_example.txt";
+    const auto search_ai = Genetic_AI(search_genome_file_name, find_last_id(search_genome_file_name));
+    const auto maximum_thread_count = std::max(size_t{std::thread::hardware_concurrency()}, size_t{1});
+    auto single_thread_rate = 0.0;
+    for(size_t thread_count = 1; thread_count <= maximum_thread_count; thread_count *= 2)
+    {
+        search_ai.set_search_thread_count(thread_count);
+        size_t nodes = 0;
+        auto search_time_used = std::chrono::steady_clock::duration{};
+        for(const auto& fen : search_fens)
+        {
+            search_ai.reset();
+            Position_History search_history;
+            auto search_board = Board{fen};
+            search_board.use_position_history(search_history);
+            const auto search_start = std::chrono::steady_clock::now();
+            search_ai.choose_move(search_board, Clock{search_time, 1});
+            search_time_used += std::chrono::steady_clock::now() - search_start;
+            nodes += search_ai.nodes_searched_for_last_move();
+        }
+
+        const auto rate = double(nodes)/std::chrono::duration<double>(search_time_used).count();
+        if(thread_count == 1)
+        {
+            single_thread_rate = rate;
+        }
+        std::println("{:>3} thread{} = {} nodes/second ({:.2f}x)", thread_count, thread_count == 1 ? " " : "s", String::format_number(int(rate)), rate/single_thread_rate);
+    }
 }
 
 bool run_perft_tests()
@@ -558,9 +766,6 @@ bool run_perft_tests()
                           return f(x) < f(y);
                       });
 
-    auto test_number = 0;
-    size_t legal_moves_counted = 0;
-    const auto time_at_start_of_all = std::chrono::steady_clock::now();
     const auto test_count_space = int(std::to_string(lines.size()).size());
     size_t fen_space = 0;
     size_t test_space = 0;
@@ -572,61 +777,85 @@ bool run_perft_tests()
         test_space = std::max(test_space, test_parts.size() - 1);
     }
 
-    for(const auto& line : lines)
-    {
-        const auto time_at_start = std::chrono::steady_clock::now();
-        const auto line_parts = String::split(line, ";");
-        const auto fen = line_parts.front();
-        std::print("[{:{}}/{:{}}] {:{}}", 
-                   ++test_number, test_count_space, 
-                   lines.size(), test_count_space, 
-                   fen, fen_space);
-        std::cout.flush();
-        const auto perft_board = Board(fen);
-        const auto tests = std::vector<std::string>(line_parts.begin() + 1, line_parts.end());
-        std::string test_results;
-        const auto PASS = '.';
-        const auto FAIL = 'x';
-        for(const auto& test : tests)
-        {
-            const auto depth_leaves = String::split(test);
-            assert(depth_leaves.size() == 2);
-            assert(depth_leaves.front().front() == 'D');
-            const auto depth = String::to_number<size_t>(depth_leaves.front().substr(1));
-            const auto expected_leaves = String::to_number<size_t>(depth_leaves.back());
-            const auto leaf_count = move_count(perft_board, depth);
-            legal_moves_counted += leaf_count;
-            if(leaf_count != expected_leaves)
+    // Run the suite with each method of looking up sliding piece attacks to compare their speed.
+    const auto original_backend = Bitboard::slider_backend();
+    std::vector<std::pair<std::string, double>> backend_rates;
+    for(const auto backend : {Bitboard::Slider_Backend::MAGIC, Bitboard::Slider_Backend::PEXT})
+    {
+        Bitboard::use_slider_backend(backend);
+        const auto backend_name = Bitboard::backend_name(backend);
+        std::println("\nSliding piece attacks: {}", backend_name);
+
+        auto test_number = 0;
+        size_t legal_moves_counted = 0;
+        const auto time_at_start_of_all = std::chrono::steady_clock::now();
+        for(const auto& line : lines)
+        {
+            const auto time_at_start = std::chrono::steady_clock::now();
+            const auto line_parts = String::split(line, ";");
+            const auto fen = line_parts.front();
+            std::print("[{:{}}/{:{}}] {:{}}", 
+                       ++test_number, test_count_space, 
+                       lines.size(), test_count_space, 
+                       fen, fen_space);
+            std::cout.flush();
+            Position_History perft_history;
+            auto perft_board = Board(fen);
+            perft_board.use_position_history(perft_history);
+            const auto tests = std::vector<std::string>(line_parts.begin() + 1, line_parts.end());
+            std::string test_results;
+            const auto PASS = '.';
+            const auto FAIL = 'x';
+            for(const auto& test : tests)
             {
-                test_results.push_back(FAIL);
-                tests_failed.push_back(test_number);
-                break;
+                const auto depth_leaves = String::split(test);
+                assert(depth_leaves.size() == 2);
+                assert(depth_leaves.front().front() == 'D');
+                const auto depth = String::to_number<size_t>(depth_leaves.front().substr(1));
+                const auto expected_leaves = String::to_number<size_t>(depth_leaves.back());
+                const auto leaf_count = move_count(perft_board, depth);
+                legal_moves_counted += leaf_count;
+                if(leaf_count != expected_leaves)
+                {
+                    test_results.push_back(FAIL);
+                    tests_failed.push_back(test_number);
+                    break;
+                }
+                else
+                {
+                    test_results.push_back(PASS);
+                }
+            }
+
+            std::print("{:{}}", test_results, test_space);
+            if(test_results.back() == PASS)
+            {
+                std::print("OK! ");
+                const auto time_at_end = std::chrono::steady_clock::now();
+                const auto time_for_test = time_at_end - time_at_start;
+                const auto time_so_far = time_at_end - time_at_start_of_all;
+                std::println("{:.6f} / {:.6f}", std::chrono::duration<double>(time_for_test).count(), std::chrono::duration<double>(time_so_far).count());
             }
             else
             {
-                test_results.push_back(PASS);
+                std::println("FAIL!");
             }
         }
 
-        std::print("{:{}}", test_results, test_space);
-        if(test_results.back() == PASS)
-        {
-            std::print("OK! ");
-            const auto time_at_end = std::chrono::steady_clock::now();
-            const auto time_for_test = time_at_end - time_at_start;
-            const auto time_so_far = time_at_end - time_at_start_of_all;
-            std::println("{:.6f} / {:.6f}", std::chrono::duration<double>(time_for_test).count(), std::chrono::duration<double>(time_so_far).count());
-        }
-        else
-        {
-            std::println("FAIL!");
-        }
+        const auto time = std::chrono::duration<double>(std::chrono::steady_clock::now() - time_at_start_of_all);
+        std::println("Perft time: {} seconds", time.count());
+        std::println("Legal moves counted: {}", String::format_number(legal_moves_counted));
+        std::println("Move generation rate: {} moves/second.", String::format_number(int(double(legal_moves_counted)/time.count())));
+        backend_rates.emplace_back(backend_name, double(legal_moves_counted)/time.count());
+    }
+    Bitboard::use_slider_backend(original_backend);
+
+    std::println("");
+    for(const auto& [name, rate] : backend_rates)
+    {
+        std::println("{} move generation rate: {} moves/second", name, String::format_number(int(rate)));
     }
 
-    const auto time = std::chrono::duration<double>(std::chrono::steady_clock::now() - time_at_start_of_all);
-    std::println("Perft time: {} seconds", time.count());
-    std::println("Legal moves counted: {}", String::format_number(legal_moves_counted));
-    std::println("Move generation rate: {} moves/second.", String::format_number(int(double(legal_moves_counted)/time.count())));
     if( ! tests_failed.empty())
     {
         std::print("Tests failed ({}): ", tests_failed.size());
@@ -642,7 +871,9 @@ bool run_perft_tests()
 void list_moves(const size_t depth) noexcept
 {
     std::vector<const Move*> moves_played;
+    Position_History history;
     Board board;
+    board.use_position_history(history);
     list_moves_on_board(board, moves_played, depth);
 }
 
@@ -699,7 +930,7 @@ namespace
         return true;
     }
 
-    size_t move_count(const Board& board, const size_t maximum_depth) noexcept
+    size_t move_count(Board& board, const size_t maximum_depth) noexcept
     {
         if(maximum_depth == 0)
         {
@@ -712,11 +943,13 @@ namespace
         }
 
         size_t count = 0;
-        for(const auto move : board.legal_moves())
+        Board::Undo_Record undo;
+        const auto legal_moves = board.legal_moves();
+        for(const auto move : legal_moves)
         {
-            auto next_board = board;
-            next_board.play_move(*move);
-            count += move_count(next_board, maximum_depth - 1);
+            board.make_move(*move, undo);
+            count += move_count(board, maximum_depth - 1);
+            board.unmake_move(undo);
         }
 
         return count;
@@ -782,7 +1015,9 @@ namespace
                 continue;
             }
 
+            Position_History history;
             auto board = board_fen == "start" ? Board{} : Board{board_fen};
+            board.use_position_history(history);
             if( ! test_assert(specification.size() >= 3)) { continue; }
 
             if(test_type == "all moves legal")
@@ -941,6 +1176,91 @@ namespace
         }
     }
 
+    void packed_move_codes_retrieve_the_same_move(bool& tests_passed)
+    {
+        for(const auto color : {Piece_Color::WHITE, Piece_Color::BLACK})
+        {
+            for(auto type_index = 0; type_index <= std::to_underlying(Piece_Type::KING); ++type_index)
+            {
+                const auto piece = Piece{color, static_cast<Piece_Type>(type_index)};
+                for(const auto square : Square::all_squares())
+                {
+                    for(const auto& move_list : piece.move_lists(square))
+                    {
+                        for(const auto move : move_list)
+                        {
+                            const auto& decoded_move = Move::from_code(move->code());
+                            test_result(tests_passed, &decoded_move == move, "Move code of {} does not lead back to the same move.", move->coordinates());
+                            test_result(tests_passed,
+                                        decoded_move.start() == square &&
+                                            decoded_move.end() == move->end() &&
+                                            decoded_move.promotion() == move->promotion() &&
+                                            decoded_move.is_castle() == move->is_castle() &&
+                                            decoded_move.is_en_passant() == move->is_en_passant(),
+                                        "Move code of {} does not decode to the same move.", move->coordinates());
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void move_lists_are_grouped_by_direction_and_ordered_by_distance(bool& tests_passed)
+    {
+        const auto queen = Piece{Piece_Color::WHITE, Piece_Type::QUEEN};
+        const auto queen_lists = queen.move_lists(Square{'d', 4});
+        size_t queen_move_count = 0;
+        for(const auto& move_list : queen_lists)
+        {
+            queen_move_count += move_list.size();
+        }
+        test_result(tests_passed, queen_lists.size() == 8 && queen_move_count == 27,
+                    "A queen on d4 should have 27 moves in 8 directions. Found {} moves in {} directions.", queen_move_count, queen_lists.size());
+
+        for(const auto color : {Piece_Color::WHITE, Piece_Color::BLACK})
+        {
+            for(auto type_index = 0; type_index <= std::to_underlying(Piece_Type::KING); ++type_index)
+            {
+                const auto piece = Piece{color, static_cast<Piece_Type>(type_index)};
+                for(const auto square : Square::all_squares())
+                {
+                    for(const auto& move_lists : {piece.move_lists(square), piece.attacking_move_lists(square)})
+                    {
+                        for(const auto& move_list : move_lists)
+                        {
+                            test_result(tests_passed, ! move_list.empty(), "Empty move list for {} on {}.", piece.fen_symbol(), square.text());
+                            for(const auto move : move_list)
+                            {
+                                test_result(tests_passed, move->start() == square, "Move {} found in list of moves from {}.", move->coordinates(), square.text());
+                            }
+
+                            for(size_t index = 1; index < move_list.size(); ++index)
+                            {
+                                const auto previous = move_list[index - 1];
+                                const auto next = move_list[index];
+                                // An en passant capture is listed after the normal capture in the same direction.
+                                test_result(tests_passed,
+                                            same_direction(previous->movement(), next->movement()) &&
+                                                (next->is_en_passant() ||
+                                                 std::abs(previous->movement().file_change) + std::abs(previous->movement().rank_change) <
+                                                     std::abs(next->movement().file_change) + std::abs(next->movement().rank_change)),
+                                            "Moves {} and {} are out of order in the same list.", previous->coordinates(), next->coordinates());
+                            }
+                        }
+                    }
+
+                    for(const auto& attack_list : piece.attacking_move_lists(square))
+                    {
+                        for(const auto move : attack_list)
+                        {
+                            test_result(tests_passed, move->can_capture(), "Non-capturing move {} in list of attacking moves.", move->coordinates());
+                        }
+                    }
+                }
+            }
+        }
+    }
+
     void squares_with_unique_coordinates_have_unique_indices(bool& tests_passed)
     {
         std::array<bool, 64> visited{};
@@ -1074,7 +1394,9 @@ namespace
 
     void repeating_board_position_three_times_results_in_threefold_game_result(bool& tests_passed)
     {
+        Position_History history;
         auto repeat_board = Board();
+        repeat_board.use_position_history(history);
         Game_Result repeat_result;
         auto repeat_move_count = 0;
 
@@ -1093,9 +1415,71 @@ namespace
         test_result(tests_passed, repeat_result.ending_reason() == "Threefold repetition", "Threefold stalemate not triggered.");
     }
 
+    void searching_a_board_copy_does_not_change_repetition_history(bool& tests_passed)
+    {
+        Position_History history;
+        auto board = Board();
+        board.use_position_history(history);
+        for(const auto& move : {"Nc3", "Nc6", "Nb1", "Nb8", "Nc3", "Nc6", "Nb1"})
+        {
+            board.play_move(move);
+        }
+
+        // Play out random lines on a copy as a search would.
+        auto search_board = board;
+        for(auto line = 0; line < 20; ++line)
+        {
+            std::vector<Board::Undo_Record> undos(10);
+            auto depth = 0;
+            for( ; depth < 10 && ! search_board.no_legal_moves(); ++depth)
+            {
+                search_board.make_move(*Random::random_element(search_board.legal_moves()), undos[depth]);
+            }
+
+            while(depth > 0)
+            {
+                search_board.unmake_move(undos[--depth]);
+            }
+        }
+
+        Position_History new_history;
+        auto moved_board = board;
+        moved_board.use_position_history(new_history);
+
+        test_result(tests_passed, board.play_move("Nb8").ending_reason() == "Threefold repetition", "Searching a board copy erased repetition history.");
+        test_result(tests_passed, moved_board.play_move("Nb8").ending_reason() == "Threefold repetition", "Repetition history not copied to new history.");
+    }
+
+    void boards_with_separate_histories_count_repetitions_independently(bool& tests_passed)
+    {
+        Position_History knight_history;
+        auto knight_board = Board();
+        knight_board.use_position_history(knight_history);
+
+        Position_History pawn_history;
+        auto pawn_board = Board();
+        pawn_board.use_position_history(pawn_history);
+
+        // Moves are played alternately on both boards at the same plies.
+        const auto knight_moves = {"Nc3", "Nc6", "Nb1", "Nb8", "Nc3", "Nc6", "Nb1", "Nb8"};
+        const auto pawn_moves = {"e4", "e5", "Nf3", "Nc6", "Bb5", "a6", "Ba4", "Nf6"};
+        Game_Result knight_result;
+        Game_Result pawn_result;
+        for(auto knight_move = knight_moves.begin(), pawn_move = pawn_moves.begin(); knight_move != knight_moves.end(); ++knight_move, ++pawn_move)
+        {
+            knight_result = knight_board.play_move(*knight_move);
+            pawn_result = pawn_board.play_move(*pawn_move);
+        }
+
+        test_result(tests_passed, knight_result.ending_reason() == "Threefold repetition", "Moves on another board erased repetition history.");
+        test_result(tests_passed, ! pawn_result.game_has_ended(), "Moves on another board caused a false repetition.");
+    }
+
     void one_hundred_ply_with_no_pawn_or_capture_move_yields_fifty_move_game_result(bool& tests_passed)
     {
+        Position_History history;
         auto fifty_move_board = Board();
+        fifty_move_board.use_position_history(history);
         auto fifty_move_result = Game_Result();
         for(int move_counter = 1; move_counter <= 100; ++move_counter)
         {
@@ -1144,7 +1528,9 @@ namespace
 
     void derived_moves_applied_to_earlier_board_result_in_later_board(bool& tests_passed)
     {
+        Position_History history;
         Board move_derivation_board;
+        move_derivation_board.use_position_history(history);
         const auto goal_board = Board{"rnbqkbnr/pp1ppppp/2p5/8/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2"};
         const auto derived_moves = move_derivation_board.derive_moves(goal_board);
         test_result(tests_passed, derived_moves.size() == 2, "Wrong number of moves derived. Got {}", derived_moves.size());
@@ -1155,9 +1541,262 @@ namespace
         test_result(tests_passed, move_derivation_board.fen() == goal_board.fen(), "Wrong moves derived. {} != {}", move_derivation_board.fen(), goal_board.fen());
     }
 
+    void unmaking_a_move_restores_the_board(bool& tests_passed)
+    {
+        for(const auto& fen : {std::string{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"},
+                               std::string{"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"},
+                               std::string{"n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1"},
+                               std::string{"8/8/3k4/8/2pP4/8/B7/4K3 b - d3 0 3"}})
+        {
+            Position_History history;
+            auto board = Board(fen);
+            board.use_position_history(history);
+            for(auto move_count = 0; move_count < 100 && ! board.no_legal_moves(); ++move_count)
+            {
+                const auto fen_before = board.fen();
+                const auto hash_before = board.board_hash();
+                const auto legal_moves_before = board.legal_moves();
+                const auto repeats_before = board.repeat_count_from_depth(100);
+                for(const auto move : legal_moves_before)
+                {
+                    auto played_board = board;
+                    const auto played_result = played_board.play_move(*move);
+
+                    Board::Undo_Record undo;
+                    const auto made_result = board.make_move(*move, undo);
+                    test_result(tests_passed, made_result.ending_reason() == played_result.ending_reason() && board.fen() == played_board.fen(),
+                                "Board::make_move() differs from Board::play_move() for {} on {}", move->coordinates(), fen_before);
+
+                    board.unmake_move(undo);
+                    if( ! test_result(tests_passed,
+                                      board.fen() == fen_before &&
+                                          board.board_hash() == hash_before &&
+                                          board.legal_moves() == legal_moves_before &&
+                                          board.repeat_count_from_depth(100) == repeats_before,
+                                      "Board not restored after unmaking {}: {} != {}", move->coordinates(), board.fen(), fen_before))
+                    {
+                        return;
+                    }
+                }
+
+                board.play_move(*Random::random_element(board.legal_moves()));
+            }
+        }
+    }
+
+    void material_counts_match_board_contents(bool& tests_passed)
+    {
+        auto counts_match = [](const Board& board)
+        {
+            std::array<std::array<int, 6>, 2> piece_counts{};
+            std::array<std::array<int, 2>, 2> bishop_counts{};
+            for(const auto square : Square::all_squares())
+            {
+                if(const auto piece = board.piece_on_square(square))
+                {
+                    ++piece_counts[std::to_underlying(piece.color())][std::to_underlying(piece.type())];
+                    if(piece.type() == Piece_Type::BISHOP)
+                    {
+                        ++bishop_counts[std::to_underlying(piece.color())][std::to_underlying(square.color())];
+                    }
+                }
+            }
+
+            for(const auto color : {Piece_Color::WHITE, Piece_Color::BLACK})
+            {
+                for(size_t type_index = 0; type_index < 6; ++type_index)
+                {
+                    if(board.piece_count(color, static_cast<Piece_Type>(type_index)) != piece_counts[std::to_underlying(color)][type_index])
+                    {
+                        return false;
+                    }
+                }
+
+                for(const auto square_color : {Square_Color::WHITE, Square_Color::BLACK})
+                {
+                    if(board.bishop_count(color, square_color) != bishop_counts[std::to_underlying(color)][std::to_underlying(square_color)])
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            return true;
+        };
+
+        for(auto game = 0; game < 20; ++game)
+        {
+            Position_History history;
+            auto board = Board();
+            board.use_position_history(history);
+            for(auto move_count = 0; move_count < 300 && ! board.no_legal_moves(); ++move_count)
+            {
+                const auto key_before = board.material_key();
+                const auto legal_moves = board.legal_moves();
+                for(const auto move : legal_moves)
+                {
+                    Board::Undo_Record undo;
+                    const auto material_changed = board.move_changes_material(*move);
+                    board.make_move(*move, undo);
+                    if( ! test_result(tests_passed, counts_match(board), "Material counts wrong after {}: {}", move->coordinates(), board.fen()) ||
+                        ! test_result(tests_passed, material_changed == (board.material_key() != key_before), "Material key wrong after {}: {}", move->coordinates(), board.fen()))
+                    {
+                        return;
+                    }
+                    board.unmake_move(undo);
+                }
+
+                test_result(tests_passed, counts_match(board) && board.material_key() == key_before, "Material counts not restored: {}", board.fen());
+                board.play_move(*Random::random_element(board.legal_moves()));
+            }
+        }
+
+        const auto same_material = Board("4k3/8/8/3b4/8/8/8/4K2N w - - 0 1");
+        const auto other_material = Board("4k3/8/8/3n4/8/8/8/4K2B w - - 0 1");
+        const auto moved_material = Board("4k3/1b6/8/8/8/8/8/2N1K3 b - - 0 1");
+        test_result(tests_passed, same_material.material_key() != other_material.material_key(), "Material keys do not distinguish piece colors.");
+        test_result(tests_passed, same_material.material_key() == moved_material.material_key(), "Material keys depend on piece placement.");
+    }
+
+    void piece_squares_match_board_contents(bool& tests_passed)
+    {
+        Position_History history;
+        auto board = Board("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+        board.use_position_history(history);
+        for(auto move_count = 0; move_count < 200 && ! board.no_legal_moves(); ++move_count)
+        {
+            for(const auto color : {Piece_Color::WHITE, Piece_Color::BLACK})
+            {
+                std::vector<Square> expected_squares;
+                std::vector<Square> expected_pawn_squares;
+                for(const auto square : Square::all_squares())
+                {
+                    const auto piece = std::as_const(board).piece_on_square(square);
+                    if(piece && piece.color() == color)
+                    {
+                        expected_squares.push_back(square);
+                        if(piece.type() == Piece_Type::PAWN)
+                        {
+                            expected_pawn_squares.push_back(square);
+                        }
+                    }
+                }
+
+                const auto squares = board.piece_squares(color);
+                auto found_squares = std::vector<Square>(squares.begin(), squares.end());
+                const auto pawn_squares = board.piece_squares(color, Piece_Type::PAWN);
+                auto found_pawn_squares = std::vector<Square>(pawn_squares.begin(), pawn_squares.end());
+                for(auto list : {&expected_squares, &found_squares, &expected_pawn_squares, &found_pawn_squares})
+                {
+                    std::ranges::sort(*list, {}, &Square::index);
+                }
+
+                if( ! test_result(tests_passed,
+                                  found_squares == expected_squares && squares.size() == int(expected_squares.size()) &&
+                                      found_pawn_squares == expected_pawn_squares,
+                                  "Wrong piece squares for {} on {}", color_text(color), board.fen()))
+                {
+                    return;
+                }
+            }
+
+            board.play_move(*Random::random_element(board.legal_moves()));
+        }
+    }
+
+    void staged_move_generation_matches_legal_moves(bool& tests_passed)
+    {
+        for(const auto& fen : {std::string{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"},
+                               std::string{"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"},
+                               std::string{"n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1"}})
+        {
+            Position_History history;
+            auto board = Board(fen);
+            board.use_position_history(history);
+            for(auto move_count = 0; move_count < 100 && ! board.no_legal_moves(); ++move_count)
+            {
+                auto legal_moves = board.legal_moves();
+                const auto hash_move = Random::random_element(legal_moves);
+
+                std::vector<const Move*> generated_moves;
+                auto generator = Move_Generator(board, hash_move);
+                while(const auto move = generator.next())
+                {
+                    generated_moves.push_back(move);
+                }
+
+                if( ! test_result(tests_passed, generated_moves.front() == hash_move,
+                                  "Move_Generator did not return hash move {} first on {}", hash_move->coordinates(), board.fen()))
+                {
+                    return;
+                }
+
+                std::ranges::sort(legal_moves);
+                std::ranges::sort(generated_moves);
+                if( ! test_result(tests_passed, std::ranges::equal(generated_moves, legal_moves),
+                                  "Move_Generator moves do not match legal moves on {}", board.fen()))
+                {
+                    return;
+                }
+
+                // Reversing each stage checks that the sorter sees every legal move except the hash move.
+                std::vector<const Move*> sorted_moves;
+                size_t sorted_stage_moves = 0;
+                auto sorting_generator = Move_Generator(board, hash_move);
+                const auto reverse_stage = [&sorted_stage_moves](const auto begin, const auto end)
+                                           {
+                                               sorted_stage_moves += size_t(std::distance(begin, end));
+                                               std::reverse(begin, end);
+                                           };
+                while(const auto move = sorting_generator.next(reverse_stage))
+                {
+                    sorted_moves.push_back(move);
+                }
+
+                if( ! test_result(tests_passed, sorted_moves.front() == hash_move && sorted_stage_moves + 1 == legal_moves.size(),
+                                  "Sorted Move_Generator stages are wrong on {}", board.fen()))
+                {
+                    return;
+                }
+
+                std::ranges::sort(sorted_moves);
+                if( ! test_result(tests_passed, sorted_moves == generated_moves,
+                                  "Sorted Move_Generator moves do not match legal moves on {}", board.fen()))
+                {
+                    return;
+                }
+
+                std::vector<const Move*> material_changing_moves;
+                std::ranges::copy_if(legal_moves,
+                                     std::back_inserter(material_changing_moves),
+                                     [&board](const auto move)
+                                     {
+                                         return std::as_const(board).piece_on_square(move->end()) || move->promotion() || move->is_en_passant();
+                                     });
+                std::vector<const Move*> generated_captures;
+                auto capture_generator = Move_Generator(board, nullptr, true);
+                while(const auto move = capture_generator.next())
+                {
+                    generated_captures.push_back(move);
+                }
+
+                std::ranges::sort(generated_captures);
+                if( ! test_result(tests_passed, generated_captures == material_changing_moves,
+                                  "Move_Generator captures do not match legal captures on {}", board.fen()))
+                {
+                    return;
+                }
+
+                board.play_move(*Random::random_element(board.legal_moves()));
+            }
+        }
+    }
+
     void identical_boards_have_identical_hashes(bool& tests_passed)
     {
+        Position_History history;
         Board board;
+        board.use_position_history(history);
         test_result(tests_passed, board.board_hash() == Board{board.fen()}.board_hash(), "Standard starting board hashes do not match.");
         std::vector<std::string> moves;
         constexpr auto maximum_move_count =
@@ -1197,7 +1836,9 @@ namespace
 
     void boards_with_different_en_passant_targets_have_different_hashes(bool& tests_passed)
     {
+        Position_History history;
         Board board;
+        board.use_position_history(history);
         for(const auto move : {"e4", "a6", "e5", "f5"})
         {
             board.play_move(move);
@@ -1218,14 +1859,18 @@ namespace
         const auto castling_hash_board = Board("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1");
 
         // Lose all castling rights due to king moving
+        Position_History kings_history;
         auto just_kings_move_board = castling_hash_board;
+        just_kings_move_board.use_position_history(kings_history);
         for(auto move : {"Ke2", "Ke7", "Ke1", "Ke8"})
         {
             just_kings_move_board.play_move(move);
         }
 
         // Lose all castling rights due to rooks moving
+        Position_History rooks_history;
         auto just_rooks_move_board = castling_hash_board;
+        just_rooks_move_board.use_position_history(rooks_history);
         for(auto move : {"Ra2", "Ra7", "Ra1", "Ra8", "Rh2", "Rh7", "Rh1", "Rh8"})
         {
             just_rooks_move_board.play_move(move);
@@ -1239,7 +1884,9 @@ namespace
         const auto castling_hash_board = Board("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1");
 
         // Lose all castling rights due to king moving
+        Position_History kings_history;
         auto just_kings_move_board = castling_hash_board;
+        just_kings_move_board.use_position_history(kings_history);
         for(auto move : {"Ke2", "Ke7", "Ke1", "Ke8"})
         {
             just_kings_move_board.play_move(move);
@@ -1250,13 +1897,17 @@ namespace
 
     void same_board_position_with_different_en_passant_captures_has_different_hash(bool& tests_passed)
     {
+        Position_History history1;
         Board board1;
+        board1.use_position_history(history1);
         for(const auto& move : String::split("e4 a6 e5 d5 a3 f5"))
         {
             board1.play_move(move);
         }
 
+        Position_History history2;
         Board board2;
+        board2.use_position_history(history2);
         for(const auto& move : String::split("e4 a6 e5 f5 a3 d5"))
         {
             board2.play_move(move);
@@ -1267,7 +1918,9 @@ namespace
 
     void correctly_detects_checking_moves(bool& tests_passed, const std::string& fen, const std::string& move_text)
     {
+        Position_History history;
         auto board = Board(fen);
+        board.use_position_history(history);
         const auto& move = board.interpret_move(move_text);
         const auto check_prediction = board.move_checks_king(move);
         board.play_move(move);
@@ -1303,6 +1956,128 @@ namespace
         }
     }
 
+    void genome_calibration_is_repeatable_and_saved_to_cache_file(bool& tests_passed)
+    {
+        const auto genome_file_name = "test_calibration_genome.txt";
+        const auto first_cache_file_name = "test_calibration_cache_1.txt";
+        const auto second_cache_file_name = "test_calibration_cache_2.txt";
+        const auto sentinel_cache_file_name = "test_calibration_cache_sentinel.txt";
+        remove(genome_file_name);
+        remove(first_cache_file_name);
+        remove(second_cache_file_name);
+        remove(sentinel_cache_file_name);
+
+        const auto read_lines = [](const std::string& file_name)
+                                {
+                                    std::vector<std::vector<std::string>> lines;
+                                    auto ifs = std::ifstream(file_name);
+                                    for(std::string line; std::getline(ifs, line);)
+                                    {
+                                        lines.push_back(String::split(line));
+                                    }
+                                    return lines;
+                                };
+
+        auto ai = Genetic_AI();
+        ai.mutate(100);
+        ai.print(genome_file_name);
+
+        Genetic_AI::use_calibration_cache_file(first_cache_file_name);
+        const auto calibrated_ai = Genetic_AI(genome_file_name, ai.id());
+        const auto first_calibration = read_lines(first_cache_file_name);
+        auto files_are_good = test_result(tests_passed, first_calibration.size() == 1 && first_calibration.front().size() == 3, "Calibration was not saved to cache file.");
+
+        Genetic_AI::use_calibration_cache_file(second_cache_file_name);
+        const auto recalibrated_ai = Genetic_AI(genome_file_name, ai.id());
+        const auto second_calibration = read_lines(second_cache_file_name);
+        files_are_good = test_result(tests_passed, second_calibration == first_calibration, "Calibration of the same genome gave a different result.") && files_are_good;
+
+        // A cached calibration that cannot come from calibrating shows that the cache was used.
+        const auto sentinel_calibration = 12345.0;
+        if(files_are_good)
+        {
+            auto ofs = std::ofstream(sentinel_cache_file_name);
+            std::println(ofs, "{} {} {}", first_calibration.front()[0], first_calibration.front()[1], sentinel_calibration);
+        }
+        Genetic_AI::use_calibration_cache_file(sentinel_cache_file_name);
+        const auto cached_ai = Genetic_AI(genome_file_name, ai.id());
+        files_are_good = test_result(tests_passed, std::abs(cached_ai.centipawn_value() - sentinel_calibration) < 1e-9, "Cached calibration was calculated again.") && files_are_good;
+
+        Genetic_AI::use_calibration_cache_file({});
+        if(files_are_good)
+        {
+            remove(genome_file_name);
+            remove(first_cache_file_name);
+            remove(second_cache_file_name);
+            remove(sentinel_cache_file_name);
+        }
+    }
+
+    void offspring_created_on_other_threads_use_reserved_ids(bool& tests_passed)
+    {
+        const auto parent_1 = Genetic_AI();
+        const auto parent_2 = Genetic_AI();
+        const auto offspring_count = 4;
+        std::vector<Genetic_AI> offspring(offspring_count);
+        const auto first_id = Genome::reserve_ids(offspring_count);
+        Thread_Pool(offspring_count).parallel_for(offspring.size(),
+                                                  [&](const size_t index)
+                                                  {
+                                                      offspring[index] = Genetic_AI(parent_1, parent_2, first_id + int(index), 1);
+                                                  });
+
+        for(auto index = 0; index < offspring_count; ++index)
+        {
+            test_result(tests_passed, offspring[size_t(index)].id() == first_id + index, "Offspring #{} has ID {} instead of {}.", index, offspring[size_t(index)].id(), first_id + index);
+        }
+
+        const auto later_ai = Genetic_AI();
+        test_result(tests_passed, later_ai.id() == first_id + offspring_count, "New AI has ID {} instead of the first unreserved ID {}.", later_ai.id(), first_id + offspring_count);
+    }
+
+    void thread_pool_runs_every_task_once(bool& tests_passed)
+    {
+        auto pool = Thread_Pool(3);
+
+        std::vector<std::future<size_t>> squares;
+        for(size_t number = 0; number < 100; ++number)
+        {
+            squares.push_back(pool.submit([number]() { return number*number; }));
+        }
+
+        for(size_t number = 0; number < squares.size(); ++number)
+        {
+            const auto square = squares[number].get();
+            test_result(tests_passed, square == number*number, "Thread pool task for {} returned {}.", number, square);
+        }
+
+        std::vector<std::atomic<int>> call_counts(1000);
+        const auto count_calls = [&call_counts](const size_t index) { ++call_counts[index]; };
+
+        pool.parallel_for(call_counts.size(), count_calls);
+        test_result(tests_passed, std::ranges::all_of(call_counts, [](const auto& count) { return count == 1; }), "Thread pool parallel_for() did not call every index once.");
+
+        // Every worker waits on its own parallel_for(), so they must run each other's tasks.
+        std::vector<std::future<void>> nested_loops;
+        for(size_t task = 0; task < pool.size(); ++task)
+        {
+            nested_loops.push_back(pool.submit([&pool, &count_calls, &call_counts]() { pool.parallel_for(call_counts.size(), count_calls); }));
+        }
+        std::ranges::for_each(nested_loops, [](auto& loop) { loop.get(); });
+        const auto expected_count = int(pool.size() + 1);
+        test_result(tests_passed, std::ranges::all_of(call_counts, [expected_count](const auto& count) { return count == expected_count; }), "Nested thread pool parallel_for() did not call every index once.");
+
+        auto failure = pool.submit([]() { throw std::runtime_error("Task failure"); });
+        try
+        {
+            failure.get();
+            test_result(tests_passed, false, "Exception from thread pool task was lost.");
+        }
+        catch(const std::runtime_error&)
+        {
+        }
+    }
+
     void self_swapped_minimax_ai_is_unchanged(bool& tests_passed)
     {
         auto self_swap_ai = Genetic_AI();
@@ -1350,7 +2125,9 @@ namespace
         auto castling_possible_gene = Castling_Possible_Gene();
         castling_possible_gene.read_from("testing/test_genome.txt");
 
+        Position_History history;
         auto castling_board = Board("rn2k3/8/8/8/8/8/8/R3K2R w KQq - 0 1");
+        castling_board.use_position_history(history);
         castling_possible_gene.test(tests_passed, castling_board, Piece_Color::WHITE, 0.0);
 
         castling_board.play_move("O-O");
@@ -1366,7 +2143,9 @@ namespace
     void freedom_to_move_gene_tests(bool& tests_passed)
     {
         const auto freedom_to_move_gene = Freedom_To_Move_Gene();
+        Position_History history;
         auto freedom_to_move_board = Board("5k2/8/8/8/4Q3/8/8/3K4 w - - 0 1");
+        freedom_to_move_board.use_position_history(history);
 
         const auto freedom_to_move_white_score = 32.0/128.0;
         freedom_to_move_gene.test(tests_passed, freedom_to_move_board, Piece_Color::WHITE, freedom_to_move_white_score);
@@ -1412,7 +2191,9 @@ namespace
     void passed_pawn_gene_tests(bool& tests_passed)
     {
         const auto passed_pawn_gene = Passed_Pawn_Gene();
+        Position_History history;
         auto passed_pawn_board = Board("k1K5/8/8/3pP3/3P4/8/8/8 w - - 0 1");
+        passed_pawn_board.use_position_history(history);
         auto passed_pawn_score = (1.0 + 2.0 / 3.0) / 8;
         passed_pawn_gene.test(tests_passed, passed_pawn_board, Piece_Color::WHITE, passed_pawn_score);
 
@@ -1518,6 +2299,19 @@ namespace
         test_result(tests_passed,
                     std::abs(game_progress) < 1e-8,
                     "Game progress at beginning of game is not zero: {}", game_progress);
+
+        // Genes are turned off when the game progress is less than zero, so rounding errors must not make it negative.
+        for(auto mutation = 0; mutation < 1000; ++mutation)
+        {
+            piece_strength_gene.mutate();
+            const auto mutated_game_progress = piece_strength_gene.game_progress(Board{});
+            if( ! test_result(tests_passed,
+                              mutated_game_progress >= 0.0 && mutated_game_progress < 1e-8,
+                              "Game progress at beginning of game is not zero after mutation: {}", mutated_game_progress))
+            {
+                break;
+            }
+        }
     }
 
     void game_progress_where_one_side_has_only_king_is_one(bool& tests_passed)
@@ -1628,14 +2422,59 @@ namespace
                     expected_time.count());
     }
 
+    void node_budget_clock_uses_move_allowance_before_game_budget(bool& tests_passed)
+    {
+        const Board timing_board;
+        auto clock = Clock::node_budget(1000, 100);
+        test_result(tests_passed, clock.time_control_string() == "1000 nodes+100 nodes/move",
+                    "Wrong node budget time control: {}", clock.time_control_string());
+        clock.start(Piece_Color::WHITE);
+
+        clock.punch(timing_board, 60);
+        test_result(tests_passed, clock.nodes_left(Piece_Color::WHITE) == 1100,
+                    "Nodes within the move allowance were taken from the game budget: {} left", clock.nodes_left(Piece_Color::WHITE));
+
+        clock.punch(timing_board, 400);
+        test_result(tests_passed, clock.game_nodes_left(Piece_Color::BLACK) == 700,
+                    "Wrong game budget after using more than the move allowance: {} left", clock.game_nodes_left(Piece_Color::BLACK));
+
+        const auto result = clock.punch(timing_board, 1101);
+        test_result(tests_passed, result.winner() == Winner_Color::BLACK,
+                    "Searching more than the node budget did not lose the game: {}", result.ending_reason());
+        test_result(tests_passed, ! clock.time_expired(Piece_Color::WHITE) && clock.nodes_left(Piece_Color::WHITE) == 100,
+                    "Allowance for each move not available after game budget was used up: {} left", clock.nodes_left(Piece_Color::WHITE));
+    }
+
+    void thread_cpu_time_clock_only_counts_time_running_on_processor(bool& tests_passed)
+    {
+        const auto time = Clock::seconds{30};
+        auto clock = Clock(time, 0, 0.0s, Time_Reset_Method::ADDITION, {}, Time_Source::THREAD_CPU_TIME);
+        clock.start(Piece_Color::WHITE);
+
+        std::this_thread::sleep_for(100ms);
+        const auto time_used_sleeping = time - clock.time_left(Piece_Color::WHITE);
+        test_result(tests_passed, time_used_sleeping < 20ms,
+                    "Thread CPU time clock counted {} sec while sleeping.", time_used_sleeping.count());
+
+        const auto spin_start = std::chrono::steady_clock::now();
+        while(std::chrono::steady_clock::now() - spin_start < 50ms)
+        {
+        }
+        const auto time_left_after_spin = clock.time_left(Piece_Color::WHITE);
+        test_result(tests_passed, time_left_after_spin < time - time_used_sleeping,
+                    "Thread CPU time clock did not count time while busy: {} sec left.", time_left_after_spin.count());
+
+        const Board timing_board;
+        clock.punch(timing_board);
+        const auto time_left_after_punch = clock.time_left(Piece_Color::WHITE);
+        test_result(tests_passed, time_left_after_punch <= time_left_after_spin && time_left_after_punch > time - 1s,
+                    "Thread CPU time clock punched wrong time: {} sec left.", time_left_after_punch.count());
+    }
+
     void midgame_node_result_values_compare_correctly(bool& tests_passed)
     {
-        const Game_Tree_Node_Result r1 = {10,
-                                          Piece_Color::WHITE,
-                                          {nullptr, nullptr, nullptr}};
-        const Game_Tree_Node_Result r2 = {10,
-                                          Piece_Color::BLACK,
-                                          {nullptr, nullptr, nullptr}};
+        const Game_Tree_Node_Result r1 = {Score{10}, Piece_Color::WHITE};
+        const Game_Tree_Node_Result r2 = {Score{10}, Piece_Color::BLACK};
         test_result(tests_passed, r2.value(Piece_Color::WHITE) < r1.value(Piece_Color::WHITE), "1. Error in comparing Game Tree Node Results.");
         test_result(tests_passed, r1.value(Piece_Color::BLACK) < r2.value(Piece_Color::BLACK), "2. Error in comparing Game Tree Node Results.");
         test_result(tests_passed, r1.value(Piece_Color::WHITE) > r1.value(Piece_Color::BLACK), "1. Error in comparing Game Tree Node Results after color switch.");
@@ -1644,12 +2483,8 @@ namespace
 
     void midgame_alpha_beta_values_compare_correctly_with_node_values(bool& tests_passed)
     {
-        const Game_Tree_Node_Result r1 = {10,
-                                          Piece_Color::WHITE,
-                                          {nullptr, nullptr, nullptr}};
-        const Game_Tree_Node_Result r2 = {10,
-                                          Piece_Color::BLACK,
-                                          {nullptr, nullptr, nullptr}};
+        const Game_Tree_Node_Result r1 = {Score{10}, Piece_Color::WHITE};
+        const Game_Tree_Node_Result r2 = {Score{10}, Piece_Color::BLACK};
         const auto abv = r1.alpha_beta_value();
         test_result(tests_passed, abv.value(Piece_Color::WHITE) == r1.value(Piece_Color::WHITE), "1. Incorrect construction of Alpha-Beta Value");
         test_result(tests_passed, abv.value(Piece_Color::BLACK) == r2.value(Piece_Color::WHITE), "2. Incorrect construction of Alpha-Beta Value");
@@ -1657,13 +2492,8 @@ namespace
 
     void alpha_beta_result_values_compare_in_line_with_algorithm(bool& tests_passed)
     {
-        const Game_Tree_Node_Result alpha_start = {Game_Tree_Node_Result::lose_score,
-                                                   Piece_Color::WHITE,
-                                                   {}};
-
-        const Game_Tree_Node_Result beta_start = {Game_Tree_Node_Result::win_score,
-                                                  Piece_Color::WHITE,
-                                                  {}};
+        const Game_Tree_Node_Result alpha_start = {Score::loss(0), Piece_Color::WHITE};
+        const Game_Tree_Node_Result beta_start = {Score::win(0), Piece_Color::WHITE};
         test_result(tests_passed, alpha_start.value(Piece_Color::WHITE) < beta_start.value(Piece_Color::WHITE), "3. Error in comparing Game Tree Node Results.");
         test_result(tests_passed, alpha_start.value(Piece_Color::BLACK) > beta_start.value(Piece_Color::BLACK), "4. Error in comparing Game Tree Node Results.");
     }
@@ -1678,23 +2508,12 @@ namespace
 
     void endgame_node_result_tests(bool& tests_passed)
     {
-        const Game_Tree_Node_Result white_win4 = {Game_Tree_Node_Result::win_score,
-                                                  Piece_Color::WHITE,
-                                                  {nullptr, nullptr, nullptr,
-                                                   nullptr, nullptr}};
-        const Game_Tree_Node_Result white_win6 = {Game_Tree_Node_Result::win_score,
-                                                  Piece_Color::WHITE,
-                                                  {nullptr, nullptr, nullptr,
-                                                   nullptr, nullptr, nullptr,
-                                                   nullptr}};
+        const Game_Tree_Node_Result white_win4 = {Score::win(5), Piece_Color::WHITE};
+        const Game_Tree_Node_Result white_win6 = {Score::win(7), Piece_Color::WHITE};
         test_result(tests_passed, white_win6.value(Piece_Color::WHITE) < white_win4.value(Piece_Color::WHITE), "Later win preferred over earlier win.");
         test_result(tests_passed, white_win4.value(Piece_Color::BLACK) < white_win6.value(Piece_Color::BLACK), "Earlier loss preferred over later win.");
 
-        const Game_Tree_Node_Result black_loss6 = {Game_Tree_Node_Result::lose_score,
-                                                   Piece_Color::BLACK,
-                                                   {nullptr, nullptr, nullptr,
-                                                    nullptr, nullptr, nullptr,
-                                                    nullptr}};
+        const Game_Tree_Node_Result black_loss6 = {Score::loss(7), Piece_Color::BLACK};
         test_result(tests_passed, white_win6.value(Piece_Color::WHITE) == black_loss6.value(Piece_Color::WHITE), "1. White win in 6 not equal to black loss in 6.");
         test_result(tests_passed, white_win6.value(Piece_Color::BLACK) == black_loss6.value(Piece_Color::BLACK), "2. White win in 6 not equal to black loss in 6.");
 
@@ -1702,6 +2521,216 @@ namespace
         test_result(tests_passed, black_loss6.is_losing_for(Piece_Color::BLACK), "Black loss in 6 returns false for is_losing_for(Piece_Color::BLACK).");
     }
 
+    void scores_encode_checkmate_distance_beyond_all_centipawn_scores(bool& tests_passed)
+    {
+        const auto largest_score = Score::from_centipawns(std::numeric_limits<double>::infinity());
+        test_result(tests_passed, largest_score == Score{Score::maximum_centipawns} && ! largest_score.is_checkmate(),
+                    "Large evaluation not limited to the largest non-checkmate score: {}", largest_score.centipawns());
+        test_result(tests_passed, Score::from_centipawns(-12.6) == Score{-13}, "Evaluation not rounded to nearest centipawn: {}", Score::from_centipawns(-12.6).centipawns());
+        test_result(tests_passed, Score::from_centipawns(std::numeric_limits<double>::quiet_NaN()) == Score{}, "NaN evaluation is not zero.");
+        test_result(tests_passed, Score::loss(3) < -largest_score && largest_score < Score::win(100), "Checkmate scores do not exceed centipawn scores.");
+        test_result(tests_passed, Score::win(3) > Score::win(5) && Score::loss(3) < Score::loss(5), "Checkmate scores do not prefer faster wins and slower losses.");
+        test_result(tests_passed, Score::win(9).checkmate_depth() == 9 && Score::loss(4).checkmate_depth() == 4 && -Score::win(4) == Score::loss(4),
+                    "Checkmate depth not recovered from score.");
+    }
+
+    void transposition_table_keeps_deepest_and_newest_entries(bool& tests_passed)
+    {
+        auto table = Transposition_Table(1);
+        const auto board = Board();
+        const auto& move = *board.legal_moves().front();
+        const auto hash = uint64_t{0x123456789ABCDEF0};
+        table.store(hash, {Score{150}, Score_Bound::LOWER, 7, &move});
+        test_result(tests_passed, ! table.probe(hash), "Transposition table stored an entry before a search started.");
+
+        table.start_search();
+        table.store(hash, {Score::loss(15), Score_Bound::LOWER, 7, &move});
+        const auto entry = table.probe(hash);
+        test_result(tests_passed,
+                    entry && entry->score == Score::loss(15) && entry->bound == Score_Bound::LOWER && entry->draft == 7 && entry->best_move == &move,
+                    "Transposition table entry not retrieved intact.");
+        test_result(tests_passed, ! table.probe(hash + 1), "Transposition table found an entry that was not stored.");
+
+        // Hashes that differ only in the high bits go in the same bucket.
+        const auto same_bucket_1 = hash ^ (uint64_t{1} << 60);
+        const auto same_bucket_2 = hash ^ (uint64_t{1} << 61);
+        table.store(same_bucket_1, {Score{-200}, Score_Bound::UPPER, 3, nullptr});
+        table.store(same_bucket_2, {Score{}, Score_Bound::EXACT, 2, nullptr});
+        test_result(tests_passed, table.probe(hash) && table.probe(hash)->draft == 7, "Deeper transposition table entry was replaced.");
+        test_result(tests_passed, ! table.probe(same_bucket_1), "Older shallow transposition table entry was not replaced.");
+        test_result(tests_passed, table.probe(same_bucket_2) && table.probe(same_bucket_2)->best_move == nullptr, "Newest transposition table entry not found.");
+
+        table.start_search();
+        table.store(same_bucket_1, {Score{-200}, Score_Bound::UPPER, 3, nullptr});
+        test_result(tests_passed, table.probe(same_bucket_1) && table.probe(same_bucket_2), "Entries from an earlier search were not replaced first.");
+        test_result(tests_passed, ! table.probe(hash), "Entry from an earlier search was not replaced first.");
+
+        const auto table_copy = table;
+        test_result(tests_passed, ! table_copy.probe(same_bucket_1) && table_copy.size_in_megabytes() == 1, "Copied transposition table is not empty.");
+    }
+
+    void evaluation_cache_stores_scores_by_position_and_side_to_move(bool& tests_passed)
+    {
+        auto cache = Evaluation_Cache();
+        const auto board = Board();
+        const auto key = board.board_hash();
+        cache.store(key, 1.5);
+        test_result(tests_passed, ! cache.probe(key), "Evaluation cache stored a score before memory was allocated.");
+
+        cache.allocate();
+        cache.store(key, 1.5);
+        test_result(tests_passed, cache.probe(key) == 1.5, "Evaluation cache score not retrieved intact.");
+
+        auto black_to_move = Board("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR b KQkq - 0 1");
+        test_result(tests_passed, black_to_move.board_hash() != key, "Evaluation cache keys do not depend on the side to move.");
+        test_result(tests_passed, ! cache.probe(black_to_move.board_hash()), "Evaluation cache found a score for the wrong side to move.");
+
+        cache.store(key + Evaluation_Cache::entry_count, -2.0);
+        test_result(tests_passed, ! cache.probe(key) && cache.probe(key + Evaluation_Cache::entry_count) == -2.0, "Evaluation cache did not replace an entry.");
+
+        const auto cache_copy = cache;
+        test_result(tests_passed, ! cache_copy.probe(key + Evaluation_Cache::entry_count), "Copied evaluation cache is not empty.");
+
+        cache.clear();
+        test_result(tests_passed, ! cache.probe(key + Evaluation_Cache::entry_count), "Cleared evaluation cache is not empty.");
+    }
+
+    void cached_genome_evaluation_matches_full_evaluation(bool& tests_passed)
+    {
+        auto genome_file = std::ifstream("genome_example.txt");
+        const auto genome = Genome(genome_file, find_last_id("genome_example.txt"));
+        Position_History history;
+        auto board = Board();
+        board.use_position_history(history);
+        for(const auto& move : String::split("e4 e5 Nf3 Nc6 Bc4 Nf6 O-O Be7 d4 exd4 Nxd4 O-O"))
+        {
+            board.play_move(move);
+            for(const auto perspective : {Piece_Color::WHITE, Piece_Color::BLACK})
+            {
+                for(size_t depth = 0; depth <= std::min(board.played_ply_count(), size_t{4}); ++depth)
+                {
+                    const auto full = genome.evaluate(board, perspective, depth);
+                    const auto split = genome.evaluate_position(board, perspective) + genome.evaluate_move_history(board, perspective, depth);
+                    test_result(tests_passed, std::abs(full - split) < 1e-9,
+                                "Split genome evaluation ({}) does not match full evaluation ({}) after {} at depth {}.", split, full, move, depth);
+                }
+            }
+        }
+    }
+
+    void mutating_a_genetic_ai_discards_stored_search_results(bool& tests_passed)
+    {
+        const auto file_name = "genome_example.txt";
+        auto ai = Genetic_AI(file_name, find_last_id(file_name));
+        Position_History history;
+        auto board = Board();
+        board.use_position_history(history);
+        board.play_move("e4");
+        ai.choose_move(board, Clock{0.1s, 1});
+        test_result(tests_passed, ai.stored_search_result(board).has_value(), "Search did not store a result for the searched position.");
+
+        ai.mutate(1);
+        test_result(tests_passed, ! ai.stored_search_result(board), "Search result from before mutation survived.");
+    }
+
+    void multithreaded_search_finds_checkmate(bool& tests_passed)
+    {
+        const auto file_name = "genome_example.txt";
+        const auto ai = Genetic_AI(file_name, find_last_id(file_name));
+        ai.set_search_thread_count(4);
+        Position_History history;
+        auto board = Board("k7/8/1K6/8/8/8/8/7R w - - 0 1");
+        board.use_position_history(history);
+        const auto& move = ai.choose_move(board, Clock{5.0s, 1});
+        test_result(tests_passed, move.algebraic(board) == "Rh8#", "Multithreaded search did not find checkmate. Got: {}", move.algebraic(board));
+        test_result(tests_passed, ai.nodes_searched_for_last_move() > 0, "Multithreaded search did not count searched nodes.");
+        const auto cache_statistics = ai.evaluation_cache_statistics_for_last_move();
+        test_result(tests_passed, cache_statistics.hits + cache_statistics.misses > 0, "Multithreaded search did not count evaluation cache use.");
+    }
+
+    void pondering_search_continues_after_expected_move(bool& tests_passed)
+    {
+        const auto file_name = "genome_example.txt";
+        const auto ai = Genetic_AI(file_name, find_last_id(file_name));
+        Position_History history;
+        auto board = Board();
+        board.use_position_history(history);
+        board.play_move("e4");
+        const auto short_time = Clock{0.01s, 1};
+
+        ai.choose_move(board, short_time);
+        const auto unpondered_nodes = ai.nodes_searched_for_last_move();
+
+        ai.reset();
+        ai.ponder(board, short_time);
+        std::this_thread::sleep_for(1s);
+        const auto& pondered_move = ai.choose_move(board, short_time);
+        test_result(tests_passed, board.is_in_legal_moves_list(pondered_move), "Pondering search picked an illegal move: {}", pondered_move.coordinates());
+        test_result(tests_passed, ai.nodes_searched_for_last_move() > unpondered_nodes,
+                    "Search after pondering did not keep the pondering work ({} nodes vs. {} nodes without pondering).",
+                    ai.nodes_searched_for_last_move(), unpondered_nodes);
+
+        board.play_move(pondered_move);
+        const auto expected_response = ai.expected_response(board);
+        if( ! expected_response || ! board.is_in_legal_moves_list(*expected_response))
+        {
+            test_result(tests_passed, false, "No legal expected response after search.");
+            return;
+        }
+
+        auto wrong_board = board;
+        wrong_board.play_move(**std::ranges::find_if(board.legal_moves(), [expected_response](const auto move) { return move != expected_response; }));
+        ai.ponder(wrong_board, short_time);
+        auto right_board = board;
+        right_board.play_move(*expected_response);
+        const auto& unexpected_move = ai.choose_move(right_board, short_time);
+        test_result(tests_passed, right_board.is_in_legal_moves_list(unexpected_move), "Search after wrong pondering picked an illegal move: {}", unexpected_move.coordinates());
+    }
+
+#ifdef COUNT_ALLOCATIONS
+    void search_does_not_allocate_memory_per_node(bool& tests_passed)
+    {
+        const auto file_name = "genome_example.txt";
+        const auto ai = Genetic_AI(file_name, find_last_id(file_name));
+        Position_History history;
+        auto board = Board("r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP2BPPP/R2QKB1R w KQ - 0 8");
+        board.use_position_history(history);
+        const auto allocations_before_search = allocation_count.load();
+        ai.choose_move(board, Clock::node_budget(0, 500'000));
+        const auto allocations = allocation_count.load() - allocations_before_search;
+        const auto nodes = ai.nodes_searched_for_last_move();
+
+        // Memory is only allocated when a search starts and when each iteration of
+        // iterative deepening finishes, never for individual positions.
+        const size_t maximum_allocations = 200;
+        test_result(tests_passed, allocations <= maximum_allocations,
+                    "Search allocated memory {} times while searching {} positions.", allocations, nodes);
+    }
+#endif
+
+    void search_with_node_budget_is_repeatable(bool& tests_passed)
+    {
+        const auto file_name = "genome_example.txt";
+        Position_History history;
+        auto board = Board("r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP2BPPP/R2QKB1R w KQ - 0 8");
+        board.use_position_history(history);
+        const auto node_budget = size_t{20'000};
+        const auto clock = Clock::node_budget(0, node_budget);
+
+        const auto first_ai = Genetic_AI(file_name, find_last_id(file_name));
+        const auto first_move = first_ai.choose_move(board, clock).coordinates();
+        const auto first_nodes = first_ai.nodes_searched_for_last_move();
+        test_result(tests_passed, first_nodes > 0 && first_nodes <= node_budget,
+                    "Search with a budget of {} nodes searched {} nodes.", node_budget, first_nodes);
+
+        const auto second_ai = Genetic_AI(file_name, find_last_id(file_name));
+        const auto second_move = second_ai.choose_move(board, clock).coordinates();
+        const auto second_nodes = second_ai.nodes_searched_for_last_move();
+        test_result(tests_passed, first_move == second_move && first_nodes == second_nodes,
+                    "Searches with the same node budget differed: {} after {} nodes and {} after {} nodes.",
+                    first_move, first_nodes, second_move, second_nodes);
+    }
+
     void average_moves_left_matches_precalculated_value(bool& tests_passed)
     {
         const double mean_moves = 26.0;
@@ -1857,6 +2886,56 @@ namespace
         }
     }
 
+    void random_generator_matches_reference_output(bool& tests_passed)
+    {
+        // Output of the reference C implementations of SplitMix64 and xoshiro256** with a seed of zero.
+        const auto expected = std::array<uint64_t, 3>{11091344671253066420ULL, 13793997310169335082ULL, 1900383378846508768ULL};
+        auto generator = Random::Xoshiro256_Star_Star(0);
+        for(const auto expected_number : expected)
+        {
+            const auto number = generator();
+            test_result(tests_passed, number == expected_number, "Random generator produced {} instead of {}.", number, expected_number);
+        }
+    }
+
+    void seeded_random_numbers_are_repeatable_on_every_thread(bool& tests_passed)
+    {
+        const auto draw_numbers = []()
+                                  {
+                                      std::vector<int> numbers;
+                                      for(auto count = 0; count < 10; ++count)
+                                      {
+                                          numbers.push_back(Random::random_integer(0, 1'000'000));
+                                      }
+                                      return numbers;
+                                  };
+        const auto draw_numbers_on_threads = [&draw_numbers]()
+                                             {
+                                                 auto numbers = draw_numbers();
+                                                 for(auto thread_count = 0; thread_count < 3; ++thread_count)
+                                                 {
+                                                     // A new thread each time, since std::async may reuse a thread that already has a generator.
+                                                     std::vector<int> thread_numbers;
+                                                     std::jthread([&thread_numbers, &draw_numbers]() { thread_numbers = draw_numbers(); }).join();
+                                                     numbers.insert(numbers.end(), thread_numbers.begin(), thread_numbers.end());
+                                                 }
+                                                 return numbers;
+                                             };
+
+        const auto seed = uint64_t{std::random_device{}()};
+        Random::set_seed(seed);
+        const auto first_numbers = draw_numbers_on_threads();
+        Random::set_seed(seed);
+        const auto second_numbers = draw_numbers_on_threads();
+        test_result(tests_passed, first_numbers == second_numbers, "Random numbers with seed {} were different in two runs.", seed);
+
+        const auto main_thread_numbers = std::vector<int>(first_numbers.begin(), first_numbers.begin() + 10);
+        const auto other_thread_numbers = std::vector<int>(first_numbers.begin() + 10, first_numbers.begin() + 20);
+        test_result(tests_passed, main_thread_numbers != other_thread_numbers, "Threads received the same random numbers with seed {}.", seed);
+
+        Random::clear_seed();
+    }
+
     void list_moves_on_board(const Board& board, std::vector<const Move*>& moves_played, size_t depth) noexcept
     {
         if(depth == 0 || board.legal_moves().empty())
@@ -21,9 +21,15 @@ class Fixed_Capacity_Vector
         using data_store = std::array<T, capacity>;
 
     public:
+        //! \brief The type of the stored data (for use with std::back_inserter).
+        using value_type = T;
+
         //! \brief A typedef for use with scoped_push_back
         using const_reference = const T&;
 
+        //! \brief A reference to stored data.
+        using reference = T&;
+
         //! Create an empty Fixed_Capacity_Vector.
         constexpr Fixed_Capacity_Vector() = default;
 
@@ -37,6 +43,16 @@ class Fixed_Capacity_Vector
             data[insertion_point++] = new_item;
         }
 
+        //! \brief Remove the last item in the Fixed_Capacity_Vector.
+        //!
+        //! As with clear(), no destructor is called on the removed item.
+        //! \exception assertion_failure If the vector is empty.
+        constexpr void pop_back() noexcept
+        {
+            assert( ! empty());
+            --insertion_point;
+        }
+
         //! \brief Inserts a range of values into the vector at the given position.
         //!
         //! \tparam Iterator An iterator type
@@ -50,7 +66,7 @@ class Fixed_Capacity_Vector
         {
             const auto move_distance = std::distance(range_begin, range_end);
             assert(size() + move_distance <= maximum_size());
-            std::move(position, end(), position + move_distance);
+            std::move_backward(position, end(), end() + move_distance);
             std::copy(range_begin, range_end, position);
             insertion_point += move_distance;
         }
@@ -144,6 +160,42 @@ class Fixed_Capacity_Vector
             return data[insertion_point - 1];
         }
 
+        //! \brief Access an item in the Fixed_Capacity_Vector.
+        //!
+        //! \param index The position of the item.
+        //! \exception assertion_failure If the index is past the end of the valid data.
+        constexpr const T& operator[](const size_t index) const noexcept
+        {
+            assert(index < size());
+            return data[index];
+        }
+
+        //! \brief Access an item in the Fixed_Capacity_Vector.
+        //!
+        //! \param index The position of the item.
+        //! \exception assertion_failure If the index is past the end of the valid data.
+        constexpr T& operator[](const size_t index) noexcept
+        {
+            assert(index < size());
+            return data[index];
+        }
+
+        //! \brief Access an item in the Fixed_Capacity_Vector.
+        //!
+        //! This is the same as operator[]. It exists so that the container can be used like a std::vector.
+        //! \param index The position of the item.
+        //! \exception assertion_failure If the index is past the end of the valid data.
+        constexpr const T& at(const size_t index) const noexcept
+        {
+            return (*this)[index];
+        }
+
+        //! \brief Two Fixed_Capacity_Vectors are equal if their valid data are equal.
+        friend constexpr bool operator==(const Fixed_Capacity_Vector& a, const Fixed_Capacity_Vector& b) noexcept
+        {
+            return std::equal(a.begin(), a.end(), b.begin(), b.end());
+        }
+
         //! \brief An iterator to the beginning of the vector.
         constexpr typename data_store::const_iterator begin() const noexcept
         {
@@ -2,6 +2,7 @@
 
 #include "Utility/String.h"
 #include "Utility/Help_Writer.h"
+#include "Utility/Random.h"
 
 #include <string>
 #include <vector>
@@ -10,6 +11,7 @@
 #include <tuple>
 #include <print>
 #include <format>
+#include <cstdint>
 
 void Main_Tools::print_help()
 {
@@ -34,12 +36,14 @@ void Main_Tools::print_help()
     help.add_option("-confirm", {"file name"}, "Check a file containing PGN game records for any illegal moves or mismarked checks or checkmates.");
     help.add_option("-test", "Run tests to ensure various parts of the program function correctly.");
     help.add_option("-speed", "Run a speed test for gene scoring and board move submission.");
-    help.add_option("-perft", "Run a legal move generation speed test.");
+    help.add_option("-perft", "Run a legal move generation speed test with each sliding piece attack lookup method.");
     help.add_option("-solve", {"FEN or file name"}, {"fen or file name ..."}, "Solve a set of chess puzzles given by FENs on the command line or file names with one FEN per line (or a mix of both). A player to do the solving must also be specified. The player has up to two minutes to solve it.");
     help.add_section_title("Player options");
     help.add_paragraph("The following options start a game with various players. If two players are specified, the first plays white and the second black. If only one player is specified, the program will wait for an Xboard or UCI command from a GUI to start playing.");
-    help.add_option("-genetic", {"file name"}, {"ID number"}, "Select a minimaxing evolved player for a game and load data from the file. If there are multiple genomes in the file, specify an ID number to load, otherwise the last genome in the file will be used.");
+    help.add_option("-genetic", {"file name"}, {"ID number"}, "Select a minimaxing evolved player for a game and load data from the file. If there are multiple genomes in the file, specify an ID number to load, otherwise the last genome in the file will be used. Calibration results are saved in a file with \"_calibration.txt\" appended to the name to speed up future loading.");
     help.add_option("-random", "Select a player that makes random moves for a game.");
+    help.add_option("-hash", {"megabytes"}, "Set the size of the table that minimaxing players use to remember the results of searching board positions.");
+    help.add_option("-threads", {"count"}, "Set the number of threads that minimaxing players use to search for moves.");
     help.add_section_title("Other game options");
     help.add_option("-time", {"number"}, "Specify the time (in seconds) each player has to play the game or to make a set number of moves (see -reset_moves option).");
     help.add_option("-reset-moves", {"number"}, "Specify the number of moves a player must make within the time limit. The clock adds the initial time every time this number of moves is made.");
@@ -53,6 +57,8 @@ void Main_Tools::print_help()
     help.add_option("-show-board", "Show the board on the command line when playing a local game.");
     help.add_option("-log-comms", "Log UCI/Xboard communications (except engine thinking) to a file.");
     help.add_paragraph("All game options in this section can be overriden by GUI commands except -event, -location, and -game-file.");
+    help.add_section_title("Random numbers");
+    help.add_option("-seed", {"number"}, "Seed the random number generators so that random choices are the same in every run. This can be combined with any of the options above. A gene pool can also be seeded in its configuration file.");
 
     std::print("{}", help.output());
 }
@@ -102,3 +108,21 @@ Main_Tools::command_line_options Main_Tools::parse_options(int argc, char* argv[
 
     return options;
 }
+
+void Main_Tools::use_random_seed_option(command_line_options& options)
+{
+    for(const auto& [option, parameters] : options)
+    {
+        if(option == "-seed")
+        {
+            argument_assert(parameters.size() == 1, "{} requires a single numeric argument.", option);
+            Random::set_seed(String::to_number<uint64_t>(parameters.front()));
+        }
+    }
+
+    std::erase_if(options, [](const auto& option) { return std::get<0>(option) == "-seed"; });
+    if(options.empty())
+    {
+        options.push_back({"-help", {}});
+    }
+}
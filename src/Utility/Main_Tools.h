@@ -30,6 +30,13 @@ namespace Main_Tools
 
     //! \brief Standardizes command line options into a vector of strings.
     command_line_options parse_options(int argc, char* argv[]);
+
+    //! \brief Seed the random number generators if the -seed option was given.
+    //!
+    //! The option is removed so that the rest of the options can be used as if it were not there.
+    //! \param options The command line options from parse_options().
+    //! \exception std::invalid_argument If the seed is not a number.
+    void use_random_seed_option(command_line_options& options);
 }
 
 #endif // MAIN_TOOL_H
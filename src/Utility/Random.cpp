@@ -4,33 +4,103 @@
 #include <string>
 #include <limits>
 #include <functional>
+#include <cstdint>
+#include <mutex>
+#include <optional>
 
 namespace
 {
-    struct Seeder
+    //! \brief The source of the generators given out after Random::set_seed() is called.
+    //!
+    //! Each generator given out is a copy, after which the source jumps ahead.
+    struct Seeded_Generators
     {
-        using result_type = unsigned int;
-        template<typename Iterator>
-        void generate(const Iterator begin, const Iterator end) const
+        std::mutex access;
+        std::optional<Random::Random_Bits_Generator> next_generator;
+    };
+
+    // Created on first use since random numbers may be needed while other static data is initialized.
+    Seeded_Generators& seeded_generators() noexcept
+    {
+        static Seeded_Generators generators;
+        return generators;
+    }
+}
+
+void Random::Xoshiro256_Star_Star::jump() noexcept
+{
+    constexpr std::array<uint64_t, 4> jump_polynomial = {0x180ec6d33cfd0aba, 0xd5a61266f0c9392c, 0xa9582618e03fc9aa, 0x39abdc4529b1661c};
+    auto jumped_state = std::array<uint64_t, 4>{};
+    for(const auto word : jump_polynomial)
+    {
+        for(auto bit = 0; bit < 64; ++bit)
         {
-            std::random_device rd;
-            std::generate(begin, end, std::ref(rd));
+            if(word & (uint64_t{1} << bit))
+            {
+                std::ranges::transform(jumped_state, state, jumped_state.begin(), std::bit_xor<>{});
+            }
+            (*this)();
         }
-    };
+    }
+    state = jumped_state;
 }
 
 Random::Random_Bits_Generator Random::get_new_seeded_random_bit_source() noexcept
 {
-    const auto seeder = Seeder{};
-    return Random_Bits_Generator(seeder);
+    auto& generators = seeded_generators();
+    {
+        const auto lock = std::lock_guard(generators.access);
+        if(generators.next_generator)
+        {
+            const auto generator = *generators.next_generator;
+            generators.next_generator->jump();
+            return generator;
+        }
+    }
+
+    std::random_device rd;
+    const auto seed = (uint64_t{rd()} << 32) ^ rd();
+    return Random_Bits_Generator(seed);
+}
+
+Random::Random_Bits_Generator& Random::thread_generator() noexcept
+{
+    thread_local auto generator = get_new_seeded_random_bit_source();
+    return generator;
+}
+
+Random::Random_Bits_Generator Random::new_task_generator() noexcept
+{
+    return Random_Bits_Generator(random_unsigned_int64());
+}
+
+void Random::set_seed(const uint64_t seed) noexcept
+{
+    // Create this thread's generator first so that it takes the first seeded sequence below.
+    auto& generator = thread_generator();
+    {
+        auto& generators = seeded_generators();
+        const auto lock = std::lock_guard(generators.access);
+        generators.next_generator = Random_Bits_Generator(seed);
+    }
+    generator = get_new_seeded_random_bit_source();
+}
+
+void Random::clear_seed() noexcept
+{
+    auto& generator = thread_generator();
+    {
+        auto& generators = seeded_generators();
+        const auto lock = std::lock_guard(generators.access);
+        generators.next_generator.reset();
+    }
+    generator = get_new_seeded_random_bit_source();
 }
 
 double Random::random_laplace(const double width) noexcept
 {
-    thread_local static auto generator = get_new_seeded_random_bit_source();
-    using ed = std::exponential_distribution<double>;
-    thread_local static auto dist = ed{};
-    return (coin_flip() ? 1 : -1)*dist(generator, ed::param_type{1.0/width});
+    const auto sign = coin_flip() ? 1 : -1;
+    return sign*std::exponential_distribution<double>{1.0/width}(thread_generator());
 }
 
 uint64_t Random::random_unsigned_int64() noexcept
@@ -6,16 +6,114 @@
 #include <cassert>
 #include <string>
 #include <type_traits>
+#include <cstdint>
+#include <array>
+#include <bit>
+#include <limits>
 
 //! \brief A collection of functions for dealing with randomness.
 namespace Random
 {
+    //! \brief The xoshiro256** random number generator.
+    //!
+    //! This generator is much faster and smaller than std::mt19937_64 while passing all
+    //! common statistical tests. It can be used with the standard random distributions.
+    //! See https://prng.di.unimi.it/.
+    class Xoshiro256_Star_Star
+    {
+        public:
+            //! \brief The type of the generated numbers.
+            using result_type = uint64_t;
+
+            //! \brief Create a generator whose sequence is completely determined by a seed.
+            //!
+            //! \param seed Any number. It is expanded into the generator's state with the SplitMix64 generator.
+            constexpr explicit Xoshiro256_Star_Star(uint64_t seed) noexcept
+            {
+                for(auto& word : state)
+                {
+                    seed += 0x9e3779b97f4a7c15;
+                    auto z = seed;
+                    z = (z ^ (z >> 30))*0xbf58476d1ce4e5b9;
+                    z = (z ^ (z >> 27))*0x94d049bb133111eb;
+                    word = z ^ (z >> 31);
+                }
+            }
+
+            //! \brief The smallest number that can be generated.
+            static constexpr result_type min() noexcept
+            {
+                return std::numeric_limits<result_type>::min();
+            }
+
+            //! \brief The largest number that can be generated.
+            static constexpr result_type max() noexcept
+            {
+                return std::numeric_limits<result_type>::max();
+            }
+
+            //! \brief Generate the next number.
+            constexpr result_type operator()() noexcept
+            {
+                const auto result = std::rotl(state[1]*5, 7)*9;
+                const auto shifted = state[1] << 17;
+                state[2] ^= state[0];
+                state[3] ^= state[1];
+                state[1] ^= state[2];
+                state[0] ^= state[3];
+                state[2] ^= shifted;
+                state[3] = std::rotl(state[3], 45);
+                return result;
+            }
+
+            //! \brief Skip ahead by 2^128 numbers.
+            //!
+            //! Copies of a generator that are each jumped a different number of times produce
+            //! sequences that do not overlap.
+            void jump() noexcept;
+
+        private:
+            std::array<uint64_t, 4> state;
+    };
+
     //! \brief Specifying the type of random number generator used.
-    using Random_Bits_Generator = std::mt19937_64;
+    using Random_Bits_Generator = Xoshiro256_Star_Star;
 
-    //! Creates and returns a randomly seeded random bit generator.
+    //! \brief Creates a random bit generator for a new sequence of random numbers.
+    //!
+    //! If set_seed() has been called, each new generator continues the sequence after the
+    //! previous one, so the generators are the same in every run with the same seed.
+    //! Otherwise, the generator is seeded from std::random_device.
     Random_Bits_Generator get_new_seeded_random_bit_source() noexcept;
 
+    //! \brief The random bit generator of the current thread.
+    //!
+    //! All functions here without a generator parameter use this generator. It is created
+    //! by get_new_seeded_random_bit_source() the first time a thread uses random numbers.
+    Random_Bits_Generator& thread_generator() noexcept;
+
+    //! \brief Creates a generator seeded from the current thread's generator.
+    //!
+    //! A task that is handed a generator made by this function when it is submitted, and
+    //! that uses it as its thread's generator, gets the same random numbers no matter which
+    //! thread runs it or when.
+    Random_Bits_Generator new_task_generator() noexcept;
+
+    //! \brief Make all random numbers repeatable from run to run.
+    //!
+    //! The current thread's generator is restarted from the seed, and every thread that
+    //! uses random numbers for the first time afterwards gets the next sequence from the
+    //! seed. Each thread's random numbers are repeatable as long as threads start using
+    //! random numbers in the same order. This should be called before starting other threads.
+    //! \param seed Any number.
+    void set_seed(uint64_t seed) noexcept;
+
+    //! \brief Undo set_seed() so that random numbers are no longer repeatable.
+    //!
+    //! The current thread's generator and every generator created afterwards are seeded
+    //! from std::random_device.
+    void clear_seed() noexcept;
+
     //! \brief Random number with Laplace distribution (double-sided exponential) and mean of zero
     //!
     //! \param width The inverse of the rate of drop-off as one gets further from zero.
@@ -32,10 +130,20 @@ namespace Random
     template<typename Integer> requires std::is_integral_v<Integer>
     Integer random_integer(const Integer min, const Integer max) noexcept
     {
-        thread_local static auto generator = get_new_seeded_random_bit_source();
-        using uid = std::uniform_int_distribution<Integer>;
-        thread_local static auto dist = uid{};
-        return dist(generator, typename uid::param_type{min, max});
+        return random_integer(min, max, thread_generator());
+    }
+
+    //! \brief Random integral number with inclusive range from a uniform distribution.
+    //!
+    //! \param min The minimum number to return.
+    //! \param max The maximum number to return.
+    //! \param generator The source of random bits. Use this version for sequences that must
+    //!        be repeatable.
+    //! \returns A random number in the range [min, max].
+    template<typename Integer> requires std::is_integral_v<Integer>
+    Integer random_integer(const Integer min, const Integer max, Random_Bits_Generator& generator) noexcept
+    {
+        return std::uniform_int_distribution<Integer>{min, max}(generator);
     }
 
     //! \brief Random 64-bit unsigned integer.
@@ -77,6 +185,18 @@ namespace Random
         return container[random_integer({0}, container.size() - 1)];
     }
 
+    //! \brief Select random element from random-access container.
+    //!
+    //! \param container A collection of items that allows for access by an index.
+    //! \param generator The source of random bits. Use this version for sequences that must
+    //!        be repeatable.
+    template<typename Container>
+    typename Container::const_reference random_element(const Container& container, Random_Bits_Generator& generator) noexcept
+    {
+        assert( ! container.empty());
+        return container[random_integer({0}, container.size() - 1, generator)];
+    }
+
     //! \brief Create a string of random lowercase letters.
     //!
     //! \param size The desired size of the random string.
@@ -88,8 +208,7 @@ namespace Random
     template<typename Container>
     void shuffle(Container& container) noexcept
     {
-        thread_local static auto generator = get_new_seeded_random_bit_source();
-        std::shuffle(container.begin(), container.end(), generator);
+        std::shuffle(container.begin(), container.end(), thread_generator());
     }
 }
 
@@ -8,6 +8,7 @@
 #include <cmath>
 #include <format>
 #include <ranges>
+#include <cstdint>
 
 std::vector<std::string> String::split(const std::string& s, const std::string& delim, const size_t count) noexcept
 {
@@ -89,6 +90,17 @@ std::string String::lowercase(std::string s) noexcept
     return s;
 }
 
+uint64_t String::hash(const std::string& s) noexcept
+{
+    auto result = uint64_t{0xcbf29ce484222325};
+    for(const auto c : s)
+    {
+        result ^= uint8_t(c);
+        result *= uint64_t{0x100000001b3};
+    }
+    return result;
+}
+
 bool String::isspace(char c) noexcept
 {
     return std::isspace(c);
@@ -13,6 +13,7 @@
 #include <format>
 #include <ranges>
 #include <iostream>
+#include <cstdint>
 
 //! \brief A collection of useful functions for dealing with text strings.
 namespace String
@@ -96,6 +97,13 @@ namespace String
     //! \returns The same string with all letters replaced by their lowercase versions.
     std::string lowercase(std::string s) noexcept;
 
+    //! \brief A 64-bit hash of a string that is the same in every run and on every platform.
+    //!
+    //! Unlike std::hash, this can be used to identify text saved to files. The hash is FNV-1a:
+    //! http://www.isthe.com/chongo/tech/comp/fnv/index.html
+    //! \param s The input string.
+    uint64_t hash(const std::string& s) noexcept;
+
     //! \brief Check if a character is whitespace.
     //!
     //! This is useful with std:: algorithms since std::isspace takes an int as a parameter.
@@ -0,0 +1,181 @@
+#include "Utility/Thread_Pool.h"
+
+#include <cstddef>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <optional>
+#include <utility>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace
+{
+    // The pool and queue that the current thread works for, if it is a worker.
+    thread_local const Thread_Pool* current_pool = nullptr;
+    thread_local size_t current_queue_index = 0;
+
+    void pin_to_processor(std::jthread& thread, const size_t processor) noexcept
+    {
+#if defined(__linux__)
+        cpu_set_t processors;
+        CPU_ZERO(&processors);
+        CPU_SET(processor, &processors);
+        pthread_setaffinity_np(thread.native_handle(), sizeof(processors), &processors);
+#elif defined(_WIN32)
+        if(processor < 8*sizeof(DWORD_PTR))
+        {
+            SetThreadAffinityMask(thread.native_handle(), DWORD_PTR{1} << processor);
+        }
+#else
+        (void)thread;
+        (void)processor;
+#endif
+    }
+}
+
+Thread_Pool::Thread_Pool(const size_t thread_count, const bool pin_to_processors) noexcept : queues(std::max(thread_count, size_t{1}))
+{
+    const auto processor_count = std::max(size_t{std::thread::hardware_concurrency()}, size_t{1});
+    for(size_t index = 0; index < queues.size(); ++index)
+    {
+        workers.emplace_back([this, index]() { work(index); });
+        if(pin_to_processors)
+        {
+            pin_to_processor(workers.back(), index % processor_count);
+        }
+    }
+}
+
+Thread_Pool::~Thread_Pool()
+{
+    {
+        const auto lock = std::lock_guard(sleep_lock);
+        stopping = true;
+    }
+    wake_up.notify_all();
+}
+
+void Thread_Pool::parallel_for(const size_t count, const std::function<void(size_t)>& body) noexcept
+{
+    // Each task takes every chunk_count-th index so that no task waits for a slow one.
+    const auto chunk_count = std::min(count, size() + 1);
+    auto unfinished_chunks = std::atomic<size_t>(chunk_count);
+    for(size_t first_index = 0; first_index < chunk_count; ++first_index)
+    {
+        push([&body, &unfinished_chunks, first_index, chunk_count, count]()
+             {
+                 for(auto index = first_index; index < count; index += chunk_count)
+                 {
+                     body(index);
+                 }
+                 unfinished_chunks.fetch_sub(1, std::memory_order_release);
+             });
+    }
+
+    while(unfinished_chunks.load(std::memory_order_acquire) > 0)
+    {
+        if( ! run_queued_task())
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+size_t Thread_Pool::size() const noexcept
+{
+    return queues.size();
+}
+
+Thread_Pool& Thread_Pool::shared() noexcept
+{
+    static Thread_Pool pool(std::thread::hardware_concurrency());
+    return pool;
+}
+
+void Thread_Pool::push(Task task) noexcept
+{
+    {
+        // The count is changed while holding the sleep lock so that a worker cannot miss
+        // the new task between checking the count and going to sleep. It is counted before
+        // it is queued so that the count never drops below zero when the task is taken.
+        const auto lock = std::lock_guard(sleep_lock);
+        ++queued_task_count;
+    }
+
+    const auto queue_index = current_pool == this ? current_queue_index : next_queue++ % queues.size();
+    auto& queue = queues[queue_index];
+    {
+        const auto lock = std::lock_guard(queue.access);
+        queue.tasks.push_back(std::move(task));
+    }
+    wake_up.notify_one();
+}
+
+std::optional<Thread_Pool::Task> Thread_Pool::take_task(const size_t queue_index) noexcept
+{
+    for(size_t offset = 0; offset < queues.size(); ++offset)
+    {
+        auto& queue = queues[(queue_index + offset) % queues.size()];
+        const auto lock = std::lock_guard(queue.access);
+        if(queue.tasks.empty())
+        {
+            continue;
+        }
+
+        // A worker takes the newest task from its own queue and steals the oldest from others.
+        auto task = std::optional<Task>();
+        if(offset == 0)
+        {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else
+        {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        --queued_task_count;
+        return task;
+    }
+
+    return {};
+}
+
+bool Thread_Pool::run_queued_task() noexcept
+{
+    auto task = take_task(current_pool == this ? current_queue_index : next_queue++ % queues.size());
+    if(task)
+    {
+        (*task)();
+    }
+    return task.has_value();
+}
+
+void Thread_Pool::work(const size_t queue_index) noexcept
+{
+    current_pool = this;
+    current_queue_index = queue_index;
+    while(true)
+    {
+        if(run_queued_task())
+        {
+            continue;
+        }
+
+        auto lock = std::unique_lock(sleep_lock);
+        wake_up.wait(lock, [this]() { return stopping || queued_task_count > 0; });
+        if(stopping && queued_task_count == 0)
+        {
+            return;
+        }
+    }
+}
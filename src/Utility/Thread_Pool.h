@@ -0,0 +1,99 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <cstddef>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <future>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+//! \file
+
+//! \brief A fixed set of worker threads that run tasks with work stealing.
+//!
+//! Each worker has its own queue of tasks. Tasks submitted from outside the pool are dealt
+//! out to the queues in turn, and tasks submitted by a worker go to that worker's queue.
+//! A worker runs the newest task in its own queue first. When its queue is empty, it steals
+//! the oldest task from another worker's queue. Idle workers sleep until a task arrives.
+//!
+//! Tasks that are queued when the pool is destroyed are run before the workers stop.
+class Thread_Pool
+{
+    public:
+        //! \brief Start the worker threads.
+        //!
+        //! \param thread_count The number of worker threads. At least one is always started.
+        //! \param pin_to_processors Whether each worker should be restricted to running on a
+        //!        single processor. Worker i runs on processor i modulo the number of processors.
+        //!        Pinning is silently skipped on platforms that do not support it.
+        explicit Thread_Pool(size_t thread_count, bool pin_to_processors = false) noexcept;
+
+        //! \brief Finish all queued tasks and stop the worker threads.
+        ~Thread_Pool();
+
+        Thread_Pool(const Thread_Pool&) = delete;
+        Thread_Pool& operator=(const Thread_Pool&) = delete;
+
+        //! \brief Queue a task to run on one of the worker threads.
+        //!
+        //! \param task A function that takes no arguments.
+        //! \returns A future that holds the return value or exception of the task.
+        template<typename Function>
+        std::future<std::invoke_result_t<std::decay_t<Function>>> submit(Function&& task) noexcept
+        {
+            auto packaged_task = std::packaged_task<std::invoke_result_t<std::decay_t<Function>>()>(std::forward<Function>(task));
+            auto result = packaged_task.get_future();
+            push(std::move(packaged_task));
+            return result;
+        }
+
+        //! \brief Call a function with every index from zero up to a count using all workers.
+        //!
+        //! The calling thread runs queued tasks while it waits, so this can be called from
+        //! inside a task running on the same pool without deadlocking.
+        //! \param count The number of indices.
+        //! \param body The function to call with each index. It will be called from several
+        //!        threads at the same time and must not throw.
+        void parallel_for(size_t count, const std::function<void(size_t)>& body) noexcept;
+
+        //! \brief The number of worker threads.
+        size_t size() const noexcept;
+
+        //! \brief A pool with one worker per processor for short parallel computations.
+        //!
+        //! The pool is started the first time this is called.
+        static Thread_Pool& shared() noexcept;
+
+    private:
+        using Task = std::move_only_function<void()>;
+
+        struct Task_Queue
+        {
+            std::mutex access;
+            std::deque<Task> tasks;
+        };
+
+        std::vector<Task_Queue> queues;
+        std::atomic<size_t> next_queue = 0;
+        std::atomic<size_t> queued_task_count = 0;
+        std::mutex sleep_lock;
+        std::condition_variable wake_up;
+        bool stopping = false;
+
+        // Declared last so that the workers are joined before the rest of the pool is destroyed.
+        std::vector<std::jthread> workers;
+
+        void push(Task task) noexcept;
+        std::optional<Task> take_task(size_t queue_index) noexcept;
+        bool run_queued_task() noexcept;
+        void work(size_t queue_index) noexcept;
+};
+
+#endif // THREAD_POOL_H
@@ -26,7 +26,8 @@ int main(int argc, char *argv[])
 {
     try
     {
-        const auto options = Main_Tools::parse_options(argc, argv);
+        auto options = Main_Tools::parse_options(argc, argv);
+        Main_Tools::use_random_seed_option(options);
         const auto& [option, parameters] = options.front();
         if(option == "-gene-pool")
         {